@@ -22,6 +22,7 @@
 #define _AVLTREE_H
 
 #include <stdint.h>
+#include <pool.h>
 #include <stack.h>
 
 /**
@@ -45,6 +46,10 @@
  *
  * holds for every node X in the tree.
  *
+ * The height is a field of its own because callers read it and the links directly,
+ * so packing it into the links would change this interface; AVL_GENERATE_COMPACT packs it
+ * for trees that only go through the generated accessors.
+ *
  * See https://zhjwpku.com/assets/pdf/AED2-10-avl-paper.pdf
  */
 struct avl_node {
@@ -57,15 +62,25 @@ struct avl_node {
 
 /**
  * avl_get_node - returns a new struct avl_node
+ *
+ * @pool: pool to allocate the node from, or NULL to use malloc
  */
-static inline struct avl_node *avl_get_node(void) {
-  struct avl_node *node = malloc(sizeof(struct avl_node));
+static inline struct avl_node *avl_get_node(struct pool *restrict pool) {
+  struct avl_node *node = pool == NULL ? malloc(sizeof(struct avl_node)) : pool_alloc(pool);
   node->left            = NULL;
   node->right           = NULL;
   node->height          = 1;
   return node;
 }
 
+/**
+ * avl_put_node - releases @node
+ *
+ * @pool: pool @node was allocated from, or NULL if it came from malloc
+ * @node: node to release
+ */
+static inline void avl_put_node(struct pool *restrict pool, struct avl_node *restrict node) { pool == NULL ? free(node) : pool_free(pool, node); }
+
 static inline uint32_t max(const uint32_t a, const uint32_t b) { return a < b ? b : a; }
 
 /**
@@ -125,162 +140,738 @@ static inline void avl_rotate_right(struct avl_node **restrict root, struct avl_
  */
 
 /**
- * avl_insert - inserts @key and @value into @tree
+ * avl_rebalance - restores the balance of every node on @stack, bottom up
+ *
+ * @tree:  tree the search path belongs to
+ * @stack: the search path from the root to the parent of the node linked or unlinked
+ *
+ * An insertion is fixed by at most one single or double rotation,
+ * but an erasure may need one at every level of the path.
+ * The walk stops at the first node that keeps both its balance and its height,
+ * since no node above it changes, and @stack is left as the path to its parent.
+ */
+static inline void avl_rebalance(struct avl_node **restrict tree, struct path_stack *restrict stack) {
+  register struct avl_node    *walk;
+           struct avl_node    *child;
+           uint32_t           old;
+
+  while (!path_empty(stack)) {
+    walk         = path_pop(stack);
+    old          = walk->height;
+    walk->height = 1 + max(height(walk->left), height(walk->right));
+
+    if          (1 + height(walk->right) < height(walk->left)) {
+      if        (height(walk->left->left) < height(walk->left->right)) {   /* case of Left Right */
+        child         = walk->left;
+        avl_rotate_left(tree, child, walk);
+        child->height = 1 + max(height(child->left), height(child->right));
+      }
+      child           = walk->left;                                        /* case of Left Left */
+      avl_rotate_right(tree, walk, path_top(stack));
+      walk->height    = 1 + max(height(walk->left), height(walk->right));
+      child->height   = 1 + max(height(child->left), height(child->right));
+    } else if   (1 + height(walk->left) < height(walk->right)) {
+      if        (height(walk->right->right) < height(walk->right->left)) { /* case of Right Left */
+        child         = walk->right;
+        avl_rotate_right(tree, child, walk);
+        child->height = 1 + max(height(child->left), height(child->right));
+      }
+      child           = walk->right;                                       /* case of Right Right */
+      avl_rotate_left(tree, walk, path_top(stack));
+      walk->height    = 1 + max(height(walk->left), height(walk->right));
+      child->height   = 1 + max(height(child->left), height(child->right));
+    } else if   (walk->height == old) break;
+  }
+}
+
+/**
+ * avl_insert_pool - inserts @key and @value into @tree using @pool
  *
  * @tree:  tree to insert @key and @value into
+ * @pool:  pool to allocate the new node from, or NULL to use malloc
  * @key:   the key to insert
  * @value: the value to insert
  * @less:  operator defining the (partial) node order
+ *
+ * Initialize @pool with pool_init(pool, sizeof(struct avl_node)) and use it for every
+ * insertion and erasure of @tree; the whole tree is then released by pool_destroy
+ * in time proportional to the number of slabs, after which @tree must be reset to NULL.
  */
-extern inline void avl_insert(struct avl_node **restrict tree, const void *restrict key, void *restrict value, bool (*less)(const void *, const void *)) {
-  register struct avl_node *walk  = *tree;
-           struct avl_node *x     = NULL;
-           struct avl_node *parent;
-           struct stack    *stack = NULL;
+extern inline void avl_insert_pool(struct avl_node **restrict tree, struct pool *restrict pool, const void *restrict key, void *restrict value, bool (*less)(const void *, const void *)) {
+  register struct avl_node    *walk = *tree;
+           struct avl_node    *parent;
+           struct path_stack  stack;
+
+  path_init(&stack);
 
   while (walk != NULL) {
-    if  (!(less(key, walk->key) || less(walk->key, key))) { destroy(&stack); return; }
-    push(&stack, walk);
+    if  (!(less(key, walk->key) || less(walk->key, key))) return;
+    path_push(&stack, walk);
     walk = less(key, walk->key) ? walk->left : walk->right;
   }
 
-  walk        = avl_get_node();
+  walk        = avl_get_node(pool);
   walk->key   = key;
   walk->value = value;
 
-  if      ((parent = top(stack)) == NULL) *tree         = walk;
-  else if (less(key, parent->key))        parent->left  = walk;
-  else                                    parent->right = walk;
+  if      ((parent = path_top(&stack)) == NULL) *tree         = walk;
+  else if (less(key, parent->key))              parent->left  = walk;
+  else                                          parent->right = walk;
 
-  while (!empty(stack)) {
-    walk         = pop(&stack);
-    walk->height = 1 + max(height(walk->left), height(walk->right));
-    if (1 + height(walk->right) < height(walk->left) || 1 + height(walk->left) < height(walk->right)) { x = walk; parent = top(stack); break; }
+  avl_rebalance(tree, &stack);
+}
+
+/**
+ * avl_build - returns a perfectly balanced subtree holding @n sorted keys
+ *
+ * @pool:   pool to allocate the nodes from, or NULL to use malloc
+ * @keys:   the keys in strictly increasing order
+ * @values: the values of @keys, or NULL to leave every value NULL
+ * @n:      the number of keys
+ *
+ * Each node is allocated before its subtrees, so the nodes of a fresh pool
+ * are laid out in preorder and a descent moves forward in memory.
+ */
+static inline struct avl_node *avl_build(struct pool *restrict pool, const void *const *restrict keys, void *const *restrict values, const size_t n) {
+  if (n == 0) return NULL;
+
+  struct avl_node *node = avl_get_node(pool);
+  node->key             = keys[n/2];
+  node->value           = values == NULL ? NULL : values[n/2];
+  node->left            = avl_build(pool, keys, values, n/2);
+  node->right           = avl_build(pool, keys + n/2 + 1, values == NULL ? NULL : values + n/2 + 1, n - n/2 - 1);
+  node->height          = 1 + max(height(node->left), height(node->right));
+  return node;
+}
+
+/**
+ * avl_build_sorted_pool - builds @tree from @n keys sorted in strictly increasing order in linear time using @pool
+ *
+ * @tree:   tree to build, which must be empty
+ * @pool:   pool to allocate the nodes from, or NULL to use malloc
+ * @keys:   the keys in strictly increasing order
+ * @values: the values of @keys, or NULL to leave every value NULL
+ * @n:      the number of keys
+ *
+ * The tree is split at the median of each range, so the sizes of sibling subtrees differ
+ * by at most one and so do their heights, without any comparison or rotation.
+ */
+extern inline void avl_build_sorted_pool(struct avl_node **restrict tree, struct pool *restrict pool, const void *const *restrict keys, void *const *restrict values, const size_t n) { *tree = avl_build(pool, keys, values, n); }
+
+/**
+ * avl_erase_node - erases @walk from @tree using @pool
+ *
+ * @tree:  tree to erase @walk from
+ * @pool:  pool the nodes of @tree were allocated from, or NULL if they came from malloc
+ * @stack: the search path from the root to the parent of @walk
+ * @walk:  the node to erase
+ */
+static inline void avl_erase_node(struct avl_node **restrict tree, struct pool *restrict pool, struct path_stack *restrict stack, register struct avl_node *walk) {
+           struct avl_node    *parent;
+
+  if (walk->left != NULL && walk->right != NULL) {                         /* case of degree 2 */
+    parent = walk;
+    path_push(stack, walk);
+
+    if (height(walk->left) <= height(walk->right)) for (walk = walk->right; walk->left != NULL; walk = walk->left)  path_push(stack, walk);
+    else                                           for (walk = walk->left; walk->right != NULL; walk = walk->right) path_push(stack, walk);
+
+    parent->key   = walk->key;
+    parent->value = walk->value;
   }
 
-  if   (x == NULL) return;
-
-  if   (1 + height(x->right) < height(x->left)) {
-    if (height(x->left->left) < height(x->left->right)) {   /* case of Left Right */
-      push(&stack, x->left->right);
-      push(&stack, x->left);
-      push(&stack, x);
-      avl_rotate_left(tree, x->left, x);
-      avl_rotate_right(tree, x, parent);
-    } else {                                                /* case of Left Left */
-      push(&stack, x->left);
-      push(&stack, x);
-      avl_rotate_right(tree, x, parent);
-    }
-  } else {
-    if (height(x->right->right) < height(x->right->left)) { /* case of Right Left */
-      push(&stack, x->right->left);
-      push(&stack, x->right);
-      push(&stack, x);
-      avl_rotate_right(tree, x->right, x);
-      avl_rotate_left(tree, x, parent);
-    } else {                                                /* case of Right Right */
-      push(&stack, x->right);
-      push(&stack, x);
-      avl_rotate_left(tree, x, parent);
+  if          (walk->left == NULL && walk->right == NULL) {                /* case of degree 0 */
+    if        ((parent = path_top(stack)) == NULL)  *tree         = NULL;        /* case of root */
+    else if   (parent->left == walk)                parent->left  = NULL;
+    else                                            parent->right = NULL;
+  } else {                                                                 /* case of degree 1 */
+    if        (walk->left != NULL) {
+      if      ((parent = path_top(stack)) == NULL)  *tree         = walk->left;  /* case of root */
+      else if (parent->left == walk)                parent->left  = walk->left;
+      else                                          parent->right = walk->left;
+    } else {
+      if      ((parent = path_top(stack)) == NULL)  *tree         = walk->right; /* case of root */
+      else if (parent->left == walk)                parent->left  = walk->right;
+      else                                          parent->right = walk->right;
     }
   }
 
-  while (!empty(stack)) {
-    walk         = pop(&stack);
-    walk->height = 1 + max(height(walk->left), height(walk->right));
-  }
+  avl_put_node(pool, walk);
+  avl_rebalance(tree, stack);
 }
 
 /**
- * avl_erase - erases @key from @tree
+ * avl_erase_pool - erases @key from @tree using @pool
  *
  * @tree: tree to erase @key from
+ * @pool: pool the nodes of @tree were allocated from, or NULL if they came from malloc
  * @key:  the key to erase
  * @less: operator defining the (partial) node order
  */
-extern inline void avl_erase(struct avl_node **restrict tree, const void *restrict key, bool (*less)(const void *, const void *)) {
-  register struct avl_node *walk  = *tree;
-           struct avl_node *x     = NULL;
-           struct avl_node *parent;
-           struct stack    *stack = NULL;
+extern inline void avl_erase_pool(struct avl_node **restrict tree, struct pool *restrict pool, const void *restrict key, bool (*less)(const void *, const void *)) {
+  register struct avl_node    *walk = *tree;
+           struct path_stack  stack;
+
+  path_init(&stack);
 
   while (walk != NULL && (less(key, walk->key) || less(walk->key, key))) {
-    push(&stack, walk);
+    path_push(&stack, walk);
     walk = less(key, walk->key) ? walk->left : walk->right;
   }
 
-  if (walk == NULL) { destroy(&stack); return; }
+  if (walk != NULL) avl_erase_node(tree, pool, &stack, walk);
+}
 
-  if (walk->left != NULL && walk->right != NULL) {                         /* case of degree 2 */
-    parent = walk;
-    push(&stack, walk);
+/**
+ * avl_insert - inserts @key and @value into @tree
+ *
+ * @tree:  tree to insert @key and @value into
+ * @key:   the key to insert
+ * @value: the value to insert
+ * @less:  operator defining the (partial) node order
+ */
+extern inline void avl_insert(struct avl_node **restrict tree, const void *restrict key, void *restrict value, bool (*less)(const void *, const void *)) { avl_insert_pool(tree, NULL, key, value, less); }
 
-    if (height(walk->left) <= height(walk->right)) for (walk = walk->right; walk->left != NULL; walk = walk->left)  push(&stack, walk);
-    else                                           for (walk = walk->left; walk->right != NULL; walk = walk->right) push(&stack, walk);
+/**
+ * avl_build_sorted - builds @tree from @n keys sorted in strictly increasing order in linear time
+ *
+ * @tree:   tree to build, which must be empty
+ * @keys:   the keys in strictly increasing order
+ * @values: the values of @keys, or NULL to leave every value NULL
+ * @n:      the number of keys
+ */
+extern inline void avl_build_sorted(struct avl_node **restrict tree, const void *const *restrict keys, void *const *restrict values, const size_t n) { avl_build_sorted_pool(tree, NULL, keys, values, n); }
 
-    parent->key   = walk->key;
-    parent->value = walk->value;
+/**
+ * avl_erase - erases @key from @tree
+ *
+ * @tree: tree to erase @key from
+ * @key:  the key to erase
+ * @less: operator defining the (partial) node order
+ */
+extern inline void avl_erase(struct avl_node **restrict tree, const void *restrict key, bool (*less)(const void *, const void *)) { avl_erase_pool(tree, NULL, key, less); }
+
+/*
+ * The below functions take a three-way operator instead of less,
+ * so that each node is compared once. The operator denotes:
+ *
+ *    a < b  := cmp(a, b) < 0
+ *    a > b  := cmp(a, b) > 0
+ *    a == b := cmp(a, b) == 0
+ *
+ * and must describe the same ordering as the less the tree was built with, if any.
+ */
+
+/**
+ * avl_search_cmp - returns the node of @tree holding @key, or NULL if there is none
+ *
+ * @tree: tree to search @key in
+ * @key:  the key to search
+ * @cmp:  operator defining the (partial) node order
+ */
+extern inline const struct avl_node *avl_search_cmp(register const struct avl_node *tree, const void *restrict key, int (*cmp)(const void *, const void *)) {
+  register int diff;
+
+  while (tree != NULL && (diff = cmp(key, tree->key)) != 0) tree = diff < 0 ? tree->left : tree->right;
+
+  return tree;
+}
+
+/**
+ * avl_insert_cmp_pool - inserts @key and @value into @tree using @pool
+ *
+ * @tree:  tree to insert @key and @value into
+ * @pool:  pool to allocate the new node from, or NULL to use malloc
+ * @key:   the key to insert
+ * @value: the value to insert
+ * @cmp:   operator defining the (partial) node order
+ */
+extern inline void avl_insert_cmp_pool(struct avl_node **restrict tree, struct pool *restrict pool, const void *restrict key, void *restrict value, int (*cmp)(const void *, const void *)) {
+  register struct avl_node    *walk = *tree;
+  register struct avl_node    *parent;
+  register int                diff  = 0;
+           struct path_stack  stack;
+
+  path_init(&stack);
+
+  while (walk != NULL) {
+    if  ((diff = cmp(key, walk->key)) == 0) return;
+    path_push(&stack, walk);
+    walk = diff < 0 ? walk->left : walk->right;
   }
 
-  if          (walk->left == NULL && walk->right == NULL) {                /* case of degree 0 */
-    if        ((parent = top(stack)) == NULL) *tree         = NULL;        /* case of root */
-    else if   (parent->left == walk)          parent->left  = NULL;
-    else                                      parent->right = NULL;
-  } else {                                                                 /* case of degree 1 */
-    if        (walk->left != NULL) {
-      if      ((parent = top(stack)) == NULL) *tree         = walk->left;  /* case of root */
-      else if (parent->left == walk)          parent->left  = walk->left;
-      else                                    parent->right = walk->left;
+  walk        = avl_get_node(pool);
+  walk->key   = key;
+  walk->value = value;
+
+  if      ((parent = path_top(&stack)) == NULL) *tree         = walk;
+  else if (diff < 0)                            parent->left  = walk;
+  else                                          parent->right = walk;
+
+  avl_rebalance(tree, &stack);
+}
+
+/**
+ * avl_erase_cmp_pool - erases @key from @tree using @pool
+ *
+ * @tree: tree to erase @key from
+ * @pool: pool the nodes of @tree were allocated from, or NULL if they came from malloc
+ * @key:  the key to erase
+ * @cmp:  operator defining the (partial) node order
+ */
+extern inline void avl_erase_cmp_pool(struct avl_node **restrict tree, struct pool *restrict pool, const void *restrict key, int (*cmp)(const void *, const void *)) {
+  register struct avl_node    *walk = *tree;
+  register int                diff;
+           struct path_stack  stack;
+
+  path_init(&stack);
+
+  while (walk != NULL && (diff = cmp(key, walk->key)) != 0) {
+    path_push(&stack, walk);
+    walk = diff < 0 ? walk->left : walk->right;
+  }
+
+  if (walk != NULL) avl_erase_node(tree, pool, &stack, walk);
+}
+
+/**
+ * avl_insert_cmp - inserts @key and @value into @tree
+ *
+ * @tree:  tree to insert @key and @value into
+ * @key:   the key to insert
+ * @value: the value to insert
+ * @cmp:   operator defining the (partial) node order
+ */
+extern inline void avl_insert_cmp(struct avl_node **restrict tree, const void *restrict key, void *restrict value, int (*cmp)(const void *, const void *)) { avl_insert_cmp_pool(tree, NULL, key, value, cmp); }
+
+/**
+ * avl_erase_cmp - erases @key from @tree
+ *
+ * @tree: tree to erase @key from
+ * @key:  the key to erase
+ * @cmp:  operator defining the (partial) node order
+ */
+extern inline void avl_erase_cmp(struct avl_node **restrict tree, const void *restrict key, int (*cmp)(const void *, const void *)) { avl_erase_cmp_pool(tree, NULL, key, cmp); }
+
+/**
+ * AVL_PARALLEL_HEIGHT - the height above which set operations fork their subtrees
+ *
+ * The set operations recurse on the left and right subtrees independently.
+ * When compiled with OpenMP, subtrees taller than this, or about 2^12 nodes and more,
+ * are handed to a task, and smaller ones run inline to keep the scheduling overhead low.
+ * Without OpenMP the pragmas are left out and the operations run sequentially.
+ */
+#define AVL_PARALLEL_HEIGHT 12
+
+/**
+ * struct avl_chain - list of nodes discarded by a set operation
+ *
+ * @head: the first node of the list
+ * @tail: the link to append the next node to
+ *
+ * The nodes are linked through their right child, and each task of a set operation
+ * fills a chain of its own, so discarded nodes are released after the parallel part
+ * even when they come from a pool, which is not thread-safe.
+ */
+struct avl_chain {
+  struct avl_node  *head;
+  struct avl_node **tail;
+};
+
+/**
+ * avl_chain_init - initializes @chain to be empty
+ *
+ * @chain: chain to initialize
+ */
+static inline void avl_chain_init(struct avl_chain *restrict chain) { chain->head = NULL; chain->tail = &chain->head; }
+
+/**
+ * avl_chain_tree - appends every node of @tree to @chain
+ *
+ * @chain: chain to append to
+ * @tree:  tree to discard
+ *
+ * @tree is flattened by rotating its left children up, in time linear in its size and without a stack.
+ */
+static inline void avl_chain_tree(struct avl_chain *restrict chain, register struct avl_node *tree) {
+  register struct avl_node *lchild;
+
+  while (tree != NULL) {
+    if (tree->left != NULL) {
+      lchild        = tree->left;
+      tree->left    = lchild->right;
+      lchild->right = tree;
+      tree          = lchild;
     } else {
-      if      ((parent = top(stack)) == NULL) *tree         = walk->right; /* case of root */
-      else if (parent->left == walk)          parent->left  = walk->right;
-      else                                    parent->right = walk->right;
+      *chain->tail = tree;
+      chain->tail  = &tree->right;
+      tree         = tree->right;
     }
   }
+}
+
+/**
+ * avl_chain_node - appends @node, detached from its subtrees, to @chain
+ *
+ * @chain: chain to append to
+ * @node:  node to discard
+ */
+static inline void avl_chain_node(struct avl_chain *restrict chain, struct avl_node *restrict node) { node->left = node->right = NULL; avl_chain_tree(chain, node); }
 
-  free(walk);
+/**
+ * avl_chain_splice - moves the nodes of @other to the end of @chain
+ *
+ * @chain: chain to append to
+ * @other: chain to move the nodes of
+ */
+static inline void avl_chain_splice(struct avl_chain *restrict chain, struct avl_chain *restrict other) { if (other->head != NULL) { *chain->tail = other->head; chain->tail = other->tail; } }
 
-  while (!empty(stack)) {
-    walk         = pop(&stack);
-    walk->height = 1 + max(height(walk->left), height(walk->right));
-    if (1 + height(walk->right) < height(walk->left) || 1 + height(walk->left) < height(walk->right)) { x = walk; parent = top(stack); break; }
+/**
+ * avl_chain_put - releases every node of @chain
+ *
+ * @chain: chain to release
+ * @pool:  pool the nodes were allocated from, or NULL if they came from malloc
+ */
+static inline void avl_chain_put(struct avl_chain *restrict chain, struct pool *restrict pool) {
+  register struct avl_node *node;
+
+  while ((node = chain->head) != NULL) { chain->head = node->right; avl_put_node(pool, node); }
+  chain->tail = &chain->head;
+}
+
+/**
+ * avl_update - recomputes the height of @node from its children and returns @node
+ *
+ * @node: node to recompute the height of
+ */
+static inline struct avl_node *avl_update(struct avl_node *restrict node) { node->height = 1 + max(height(node->left), height(node->right)); return node; }
+
+/**
+ * avl_spin_left - rotates subtree rooted with @x counterclockwise and returns its new root
+ *
+ * @x: root node of subtree
+ */
+static inline struct avl_node *avl_spin_left(struct avl_node *x) { avl_rotate_left(&x, x, NULL); avl_update(x->left); return avl_update(x); }
+
+/**
+ * avl_spin_right - rotates subtree rooted with @x clockwise and returns its new root
+ *
+ * @x: root node of subtree
+ */
+static inline struct avl_node *avl_spin_right(struct avl_node *x) { avl_rotate_right(&x, x, NULL); avl_update(x->right); return avl_update(x); }
+
+/**
+ * avl_join_right - joins @left, @node and the shorter tree @right along the right spine of @left
+ *
+ * @left:  tree whose keys are less than the key of @node, taller than @right by more than one
+ * @node:  node to join at
+ * @right: tree whose keys are greater than the key of @node
+ */
+static inline struct avl_node *avl_join_right(struct avl_node *left, struct avl_node *node, struct avl_node *right) {
+  if (height(left->right) <= height(right) + 1) {                       /* case of joining at the spine */
+    node->left  = left->right;
+    node->right = right;
+    left->right = avl_update(node);
+    if (height(node) <= height(left->left) + 1) return avl_update(left);
+    left->right = avl_spin_right(node);
+    return avl_spin_left(left);
   }
 
-  if   (x == NULL) return;
-
-  if   (1 + height(x->right) < height(x->left)) {
-    if (height(x->left->left) < height(x->left->right)) {                  /* case of Left Right */
-      push(&stack, x->left->right);
-      push(&stack, x->left);
-      push(&stack, x);
-      avl_rotate_left(tree, x->left, x);
-      avl_rotate_right(tree, x, parent);
-    } else {                                                               /* case of Left Left */
-      push(&stack, x->left);
-      push(&stack, x);
-      avl_rotate_right(tree, x, parent);
-    }
-  } else {
-    if (height(x->right->right) < height(x->right->left)) {                /* case of Right Left */
-      push(&stack, x->right->left);
-      push(&stack, x->right);
-      push(&stack, x);
-      avl_rotate_right(tree, x->right, x);
-      avl_rotate_left(tree, x, parent);
-    } else {                                                               /* case of Right Right */
-      push(&stack, x->right);
-      push(&stack, x);
-      avl_rotate_left(tree, x, parent);
-    }
+  left->right = avl_join_right(left->right, node, right);
+  return height(left->right) <= height(left->left) + 1 ? avl_update(left) : avl_spin_left(left);
+}
+
+/**
+ * avl_join_left - joins the shorter tree @left, @node and @right along the left spine of @right
+ *
+ * @left:  tree whose keys are less than the key of @node
+ * @node:  node to join at
+ * @right: tree whose keys are greater than the key of @node, taller than @left by more than one
+ */
+static inline struct avl_node *avl_join_left(struct avl_node *left, struct avl_node *node, struct avl_node *right) {
+  if (height(right->left) <= height(left) + 1) {                        /* case of joining at the spine */
+    node->left  = left;
+    node->right = right->left;
+    right->left = avl_update(node);
+    if (height(node) <= height(right->right) + 1) return avl_update(right);
+    right->left = avl_spin_left(node);
+    return avl_spin_right(right);
   }
 
-  while (!empty(stack)) {
-    walk         = pop(&stack);
-    walk->height = 1 + max(height(walk->left), height(walk->right));
+  right->left = avl_join_left(left, node, right->left);
+  return height(right->left) <= height(right->right) + 1 ? avl_update(right) : avl_spin_right(right);
+}
+
+/**
+ * avl_join - joins @left, @node and @right into one tree and returns its root
+ *
+ * @left:  tree whose keys are all less than the key of @node
+ * @node:  detached node to join at
+ * @right: tree whose keys are all greater than the key of @node
+ *
+ * The cost is proportional to the difference of the heights of @left and @right.
+ */
+extern inline struct avl_node *avl_join(struct avl_node *left, struct avl_node *node, struct avl_node *right) {
+  if (height(right) + 1 < height(left)) return avl_join_right(left, node, right);
+  if (height(left) + 1 < height(right)) return avl_join_left(left, node, right);
+  node->left  = left;
+  node->right = right;
+  return avl_update(node);
+}
+
+/**
+ * avl_split_last - detaches the node with the largest key of non-empty @tree into @last
+ * and returns the root of the rest
+ *
+ * @tree: tree to detach the node from
+ * @last: pointer to store the detached node in
+ */
+static inline struct avl_node *avl_split_last(struct avl_node *tree, struct avl_node **restrict last) {
+  struct avl_node *rest;
+
+  if (tree->right == NULL) { *last = tree; return tree->left; }
+  rest = avl_split_last(tree->right, last);
+  return avl_join(tree->left, tree, rest);
+}
+
+/**
+ * avl_concat - joins @left and @right, whose keys are all greater than those of @left,
+ * and returns the root of the result
+ *
+ * @left:  the lower tree
+ * @right: the upper tree
+ */
+static inline struct avl_node *avl_concat(struct avl_node *left, struct avl_node *right) {
+  struct avl_node *last;
+
+  if (left == NULL) return right;
+  left = avl_split_last(left, &last);
+  return avl_join(left, last, right);
+}
+
+/**
+ * avl_split - splits @tree into @left with the keys less than @key and @right with the keys greater than @key,
+ * and returns the detached node whose key equals @key, or NULL if there is none
+ *
+ * @tree:  tree to split, which is consumed
+ * @key:   the key to split at
+ * @left:  pointer to store the lower tree in
+ * @right: pointer to store the upper tree in
+ * @less:  operator defining the (partial) node order
+ */
+extern inline struct avl_node *avl_split(struct avl_node *tree, const void *restrict key, struct avl_node **restrict left, struct avl_node **restrict right, bool (*less)(const void *, const void *)) {
+  struct avl_node *node;
+  struct avl_node *child;
+
+  if (tree == NULL) { *left = *right = NULL; return NULL; }
+
+  if (less(key, tree->key)) {                                           /* case of splitting the left subtree */
+    child  = tree->right;
+    node   = avl_split(tree->left, key, left, right, less);
+    *right = avl_join(*right, tree, child);
+    return node;
+  }
+
+  if (less(tree->key, key)) {                                           /* case of splitting the right subtree */
+    child  = tree->left;
+    node   = avl_split(tree->right, key, left, right, less);
+    *left  = avl_join(child, tree, *left);
+    return node;
   }
+
+  *left        = tree->left;
+  *right       = tree->right;
+  tree->left   = NULL;
+  tree->right  = NULL;
+  tree->height = 1;
+  return tree;
+}
+
+/*
+ * The set operations below consume both trees and reuse their nodes.
+ * Each one splits the second tree at the root key of the first, recurses on the two halves,
+ * possibly in parallel, and joins the results, which takes O(m log(n/m + 1)) work
+ * for trees of sizes m <= n and O(log^2 n) span.
+ */
+
+/**
+ * avl_union_tree - returns the union of @tree and @other, discarding duplicates of @other into @chain
+ *
+ * @tree:  the first tree
+ * @other: the second tree
+ * @chain: chain to discard nodes into
+ * @less:  operator defining the (partial) node order
+ */
+static inline struct avl_node *avl_union_tree(struct avl_node *tree, struct avl_node *other, struct avl_chain *restrict chain, bool (*less)(const void *, const void *)) {
+  struct avl_node  *left, *right, *lother, *rother, *node;
+  struct avl_chain rchain;
+
+  if (tree  == NULL) return other;
+  if (other == NULL) return tree;
+
+  avl_chain_init(&rchain);
+  if ((node = avl_split(other, tree->key, &lother, &rother, less)) != NULL) avl_chain_node(chain, node);
+
+#ifdef _OPENMP
+#pragma omp task default(none) firstprivate(tree, lother, chain, less) shared(left) if (AVL_PARALLEL_HEIGHT < height(tree))
+#endif
+  left  = avl_union_tree(tree->left, lother, chain, less);
+  right = avl_union_tree(tree->right, rother, &rchain, less);
+#ifdef _OPENMP
+#pragma omp taskwait
+#endif
+
+  avl_chain_splice(chain, &rchain);
+  return avl_join(left, tree, right);
 }
 
+/**
+ * avl_intersection_tree - returns the intersection of @tree and @other, discarding the rest into @chain
+ *
+ * @tree:  the first tree
+ * @other: the second tree
+ * @chain: chain to discard nodes into
+ * @less:  operator defining the (partial) node order
+ */
+static inline struct avl_node *avl_intersection_tree(struct avl_node *tree, struct avl_node *other, struct avl_chain *restrict chain, bool (*less)(const void *, const void *)) {
+  struct avl_node  *left, *right, *lother, *rother, *node;
+  struct avl_chain rchain;
+
+  if (tree  == NULL) { avl_chain_tree(chain, other); return NULL; }
+  if (other == NULL) { avl_chain_tree(chain, tree);  return NULL; }
+
+  avl_chain_init(&rchain);
+  node = avl_split(other, tree->key, &lother, &rother, less);
+
+#ifdef _OPENMP
+#pragma omp task default(none) firstprivate(tree, lother, chain, less) shared(left) if (AVL_PARALLEL_HEIGHT < height(tree))
+#endif
+  left  = avl_intersection_tree(tree->left, lother, chain, less);
+  right = avl_intersection_tree(tree->right, rother, &rchain, less);
+#ifdef _OPENMP
+#pragma omp taskwait
+#endif
+
+  avl_chain_splice(chain, &rchain);
+  if (node != NULL) { avl_chain_node(chain, node); return avl_join(left, tree, right); }
+  avl_chain_node(chain, tree);
+  return avl_concat(left, right);
+}
+
+/**
+ * avl_difference_tree - returns the keys of @tree not in @other, discarding the rest into @chain
+ *
+ * @tree:  the first tree
+ * @other: the second tree
+ * @chain: chain to discard nodes into
+ * @less:  operator defining the (partial) node order
+ */
+static inline struct avl_node *avl_difference_tree(struct avl_node *tree, struct avl_node *other, struct avl_chain *restrict chain, bool (*less)(const void *, const void *)) {
+  struct avl_node  *left, *right, *lother, *rother, *node;
+  struct avl_chain rchain;
+
+  if (tree  == NULL) { avl_chain_tree(chain, other); return NULL; }
+  if (other == NULL) return tree;
+
+  avl_chain_init(&rchain);
+  node = avl_split(other, tree->key, &lother, &rother, less);
+
+#ifdef _OPENMP
+#pragma omp task default(none) firstprivate(tree, lother, chain, less) shared(left) if (AVL_PARALLEL_HEIGHT < height(tree))
+#endif
+  left  = avl_difference_tree(tree->left, lother, chain, less);
+  right = avl_difference_tree(tree->right, rother, &rchain, less);
+#ifdef _OPENMP
+#pragma omp taskwait
+#endif
+
+  avl_chain_splice(chain, &rchain);
+  if (node == NULL) return avl_join(left, tree, right);
+  avl_chain_node(chain, node);
+  avl_chain_node(chain, tree);
+  return avl_concat(left, right);
+}
+
+/**
+ * AVL_SET_OPERATION - applies @op to @tree and @other and releases the discarded nodes to @pool
+ *
+ * The operation runs in a parallel region of its own when compiled with OpenMP,
+ * and the discarded nodes are released afterwards by the calling thread.
+ */
+#ifdef _OPENMP
+#define AVL_SET_OPERATION(op, tree, other, pool, less) do {                 \
+  struct avl_chain chain;                                                   \
+  avl_chain_init(&chain);                                                   \
+  _Pragma("omp parallel") _Pragma("omp single")                             \
+  *(tree) = op(*(tree), (other), &chain, (less));                           \
+  avl_chain_put(&chain, (pool));                                            \
+} while (0)
+#else
+#define AVL_SET_OPERATION(op, tree, other, pool, less) do {                 \
+  struct avl_chain chain;                                                   \
+  avl_chain_init(&chain);                                                   \
+  *(tree) = op(*(tree), (other), &chain, (less));                           \
+  avl_chain_put(&chain, (pool));                                            \
+} while (0)
+#endif
+
+/**
+ * avl_union_pool - merges @other into @tree, keeping the nodes of @tree for keys in both
+ *
+ * @tree:  tree to merge @other into
+ * @other: tree to merge, which is consumed
+ * @pool:  pool the nodes of both trees were allocated from, or NULL if they came from malloc
+ * @less:  operator defining the (partial) node order
+ */
+extern inline void avl_union_pool(struct avl_node **restrict tree, struct avl_node *restrict other, struct pool *restrict pool, bool (*less)(const void *, const void *)) { AVL_SET_OPERATION(avl_union_tree, tree, other, pool, less); }
+
+/**
+ * avl_intersection_pool - removes the keys not in @other from @tree
+ *
+ * @tree:  tree to intersect with @other
+ * @other: tree to intersect with, which is consumed
+ * @pool:  pool the nodes of both trees were allocated from, or NULL if they came from malloc
+ * @less:  operator defining the (partial) node order
+ */
+extern inline void avl_intersection_pool(struct avl_node **restrict tree, struct avl_node *restrict other, struct pool *restrict pool, bool (*less)(const void *, const void *)) { AVL_SET_OPERATION(avl_intersection_tree, tree, other, pool, less); }
+
+/**
+ * avl_difference_pool - removes the keys in @other from @tree
+ *
+ * @tree:  tree to remove the keys from
+ * @other: tree of the keys to remove, which is consumed
+ * @pool:  pool the nodes of both trees were allocated from, or NULL if they came from malloc
+ * @less:  operator defining the (partial) node order
+ */
+extern inline void avl_difference_pool(struct avl_node **restrict tree, struct avl_node *restrict other, struct pool *restrict pool, bool (*less)(const void *, const void *)) { AVL_SET_OPERATION(avl_difference_tree, tree, other, pool, less); }
+
+/**
+ * avl_union - merges @other into @tree, keeping the nodes of @tree for keys in both
+ *
+ * @tree:  tree to merge @other into
+ * @other: tree to merge, which is consumed
+ * @less:  operator defining the (partial) node order
+ */
+extern inline void avl_union(struct avl_node **restrict tree, struct avl_node *restrict other, bool (*less)(const void *, const void *)) { avl_union_pool(tree, other, NULL, less); }
+
+/**
+ * avl_intersection - removes the keys not in @other from @tree
+ *
+ * @tree:  tree to intersect with @other
+ * @other: tree to intersect with, which is consumed
+ * @less:  operator defining the (partial) node order
+ */
+extern inline void avl_intersection(struct avl_node **restrict tree, struct avl_node *restrict other, bool (*less)(const void *, const void *)) { avl_intersection_pool(tree, other, NULL, less); }
+
+/**
+ * avl_difference - removes the keys in @other from @tree
+ *
+ * @tree:  tree to remove the keys from
+ * @other: tree of the keys to remove, which is consumed
+ * @less:  operator defining the (partial) node order
+ */
+extern inline void avl_difference(struct avl_node **restrict tree, struct avl_node *restrict other, bool (*less)(const void *, const void *)) { avl_difference_pool(tree, other, NULL, less); }
+
 /**
  * avl_preorder - applies @func to each node of @tree preorderwise
  *
@@ -305,4 +896,496 @@ extern inline void avl_inorder(const struct avl_node *restrict tree, void (*func
  */
 extern inline void avl_postorder(const struct avl_node *restrict tree, void (*func)(const struct avl_node *restrict)) { if (tree != NULL) { avl_postorder(tree->left, func); avl_postorder(tree->right, func); func(tree); } }
 
+/**
+ * struct avl_iter - cursor over the nodes of AVL tree in key order
+ *
+ * @path: the nodes from the root down to the current node, which is on top
+ *
+ * The iterator is usually declared as a local variable and positioned with avl_iter_first,
+ * avl_iter_last or avl_iter_seek, so walking the tree neither recurses nor allocates.
+ * It is invalidated by any insertion or erasure on the tree.
+ */
+struct avl_iter {
+  struct path_stack path;
+};
+
+/**
+ * avl_iter_get - returns the current node of @iter, or NULL if @iter is past either end
+ *
+ * @iter: iterator to access the current node
+ */
+extern inline const struct avl_node *avl_iter_get(const struct avl_iter *restrict iter) { return path_top(&iter->path); }
+
+/**
+ * avl_iter_first - positions @iter at the node with the smallest key of @tree and returns it
+ *
+ * @iter: iterator to position
+ * @tree: tree to iterate over
+ */
+extern inline const struct avl_node *avl_iter_first(struct avl_iter *restrict iter, const struct avl_node *restrict tree) {
+  path_init(&iter->path);
+  for (; tree != NULL; tree = tree->left) path_push(&iter->path, (void *) tree);
+  return avl_iter_get(iter);
+}
+
+/**
+ * avl_iter_last - positions @iter at the node with the largest key of @tree and returns it
+ *
+ * @iter: iterator to position
+ * @tree: tree to iterate over
+ */
+extern inline const struct avl_node *avl_iter_last(struct avl_iter *restrict iter, const struct avl_node *restrict tree) {
+  path_init(&iter->path);
+  for (; tree != NULL; tree = tree->right) path_push(&iter->path, (void *) tree);
+  return avl_iter_get(iter);
+}
+
+/**
+ * avl_iter_next - advances @iter to the in-order successor and returns it, or NULL past the last node
+ *
+ * @iter: iterator positioned at a node
+ */
+extern inline const struct avl_node *avl_iter_next(struct avl_iter *restrict iter) {
+  register const struct avl_node *walk = path_top(&iter->path);
+  register const struct avl_node *child;
+
+  if (walk == NULL) return NULL;
+
+  if (walk->right != NULL) {                                            /* case of leftmost node of right subtree */
+    for (walk = walk->right; walk != NULL; walk = walk->left) path_push(&iter->path, (void *) walk);
+    return avl_iter_get(iter);
+  }
+
+  do    child = path_pop(&iter->path);                                 /* case of nearest ancestor on the right */
+  while ((walk = path_top(&iter->path)) != NULL && walk->right == child);
+  return walk;
+}
+
+/**
+ * avl_iter_prev - moves @iter back to the in-order predecessor and returns it, or NULL before the first node
+ *
+ * @iter: iterator positioned at a node
+ */
+extern inline const struct avl_node *avl_iter_prev(struct avl_iter *restrict iter) {
+  register const struct avl_node *walk = path_top(&iter->path);
+  register const struct avl_node *child;
+
+  if (walk == NULL) return NULL;
+
+  if (walk->left != NULL) {                                             /* case of rightmost node of left subtree */
+    for (walk = walk->left; walk != NULL; walk = walk->right) path_push(&iter->path, (void *) walk);
+    return avl_iter_get(iter);
+  }
+
+  do    child = path_pop(&iter->path);                                 /* case of nearest ancestor on the left */
+  while ((walk = path_top(&iter->path)) != NULL && walk->left == child);
+  return walk;
+}
+
+/**
+ * avl_iter_seek - positions @iter at the first node whose key is not less than @key and returns it,
+ * or NULL if every key of @tree is less than @key
+ *
+ * @iter: iterator to position
+ * @tree: tree to iterate over
+ * @key:  the lower bound to seek, inclusive
+ * @less: operator defining the (partial) node order
+ *
+ * The search path above the result is kept, so avl_iter_prev from the result
+ * moves to the last node whose key is less than @key.
+ */
+extern inline const struct avl_node *avl_iter_seek(struct avl_iter *restrict iter, const struct avl_node *restrict tree, const void *restrict key, bool (*less)(const void *, const void *)) {
+  register size_t size = 0;
+
+  path_init(&iter->path);
+
+  for (; tree != NULL; tree = less(tree->key, key) ? tree->right : tree->left) {
+    path_push(&iter->path, (void *) tree);
+    if (!less(tree->key, key)) size = iter->path.size;                  /* remember the deepest candidate */
+  }
+
+  iter->path.size = size;
+  return avl_iter_get(iter);
+}
+
+/**
+ * avl_link - returns the link of @node to its child in direction @dir
+ *
+ * @node: node to return the link of
+ * @dir:  false for the left child, true for the right child
+ */
+static inline struct avl_node **avl_link(struct avl_node *restrict node, const bool dir) { return dir ? &node->right : &node->left; }
+
+/**
+ * avl_finger_climb - pops @path up to the lowest node on it whose subtree holds the position of @key
+ *
+ * @path:  the path from the root to a node whose key is not equal to @key
+ * @key:   the key to find the position of
+ * @less:  operator defining the (partial) node order
+ * @bound: where to store the size of @path up to the nearest ancestor greater than @key, or 0 if none is known;
+ *         NULL if the caller does not need it
+ *
+ * Toward greater keys, the subtree of a node is bounded above by the nearest ancestor it lies to the left of,
+ * so only those ancestors are compared with @key, and likewise toward smaller keys.
+ * The node is popped from @path and returned, and @path is left as the path to its parent.
+ */
+static inline struct avl_node *avl_finger_climb(struct path_stack *restrict path, const void *restrict key, bool (*less)(const void *, const void *), size_t *restrict bound) {
+  register size_t               i     = path->size - 1;
+  register size_t               j;
+  const    bool                 right = less(((struct avl_node *) path->value[i])->key, key);
+  const    struct avl_node      *ancestor;
+
+  if (bound != NULL) *bound = 0;
+
+  for (;; i = j - 1) {
+    for (j = i; j > 0 && *avl_link(path->value[j - 1], !right) != path->value[j]; --j);
+
+    if (j == 0) break;
+
+    ancestor = path->value[j - 1];
+    if (right ? less(key, ancestor->key) : less(ancestor->key, key)) { if (right && bound != NULL) *bound = j; break; }
+  }
+
+  path->size = i;
+  return path->value[i];
+}
+
+/**
+ * avl_finger_seek - positions @finger at the first node whose key is not less than @key and returns it,
+ * or NULL if every key of @tree is less than @key
+ *
+ * @finger: iterator positioned by a previous call or by avl_iter_*; one past either end starts from the root
+ * @tree:   tree to iterate over
+ * @key:    the lower bound to seek, inclusive
+ * @less:   operator defining the (partial) node order
+ *
+ * Behaves as avl_iter_seek, but the search starts from the current node of @finger
+ * and climbs only to the lowest subtree that holds @key, so its cost depends on the height
+ * of that subtree rather than of @tree. Keys close to the current node are usually found in a few steps,
+ * and keys past the last node in one.
+ * @finger must not outlive a modification of @tree through any function but avl_finger_insert.
+ */
+extern inline const struct avl_node *avl_finger_seek(struct avl_iter *restrict finger, const struct avl_node *restrict tree, const void *restrict key, bool (*less)(const void *, const void *)) {
+  register const struct avl_node *walk = avl_iter_get(finger);
+           size_t                size;
+
+  if (walk == NULL) return avl_iter_seek(finger, tree, key, less);
+
+  if (!less(walk->key, key) && !less(key, walk->key)) return walk;
+
+  walk = avl_finger_climb(&finger->path, key, less, &size);
+
+  for (; walk != NULL; walk = less(walk->key, key) ? walk->right : walk->left) {
+    path_push(&finger->path, (void *) walk);
+    if (!less(walk->key, key)) size = finger->path.size;                /* remember the deepest candidate */
+  }
+
+  finger->path.size = size;
+  return avl_iter_get(finger);
+}
+
+/**
+ * avl_finger_insert_pool - inserts @key and @value into @tree using @pool, searching from @finger,
+ * and positions @finger at the node holding @key
+ *
+ * @tree:   tree to insert @key and @value into
+ * @pool:   pool to allocate the new node from, or NULL to use malloc
+ * @finger: iterator positioned by a previous call or by avl_iter_*; one past either end starts from the root
+ * @key:    the key to insert
+ * @value:  the value to insert
+ * @less:   operator defining the (partial) node order
+ *
+ * Returns the node holding @key, which is not replaced if @tree already contained @key.
+ * The search climbs from @finger as in avl_finger_seek, so a key greater than every key of @tree
+ * is placed next to the last node without a descent from the root. Rebalancing stops at the first ancestor
+ * whose height is unchanged, and @finger keeps the part of the path it did not reach
+ * and descends from there to the new node.
+ */
+extern inline const struct avl_node *avl_finger_insert_pool(struct avl_node **restrict tree, struct pool *restrict pool, struct avl_iter *restrict finger, const void *restrict key, void *restrict value, bool (*less)(const void *, const void *)) {
+  register struct avl_node    *walk = path_top(&finger->path);
+  register struct avl_node    *parent;
+           bool               dir   = false;
+
+  if      (walk == NULL)                                   walk = *tree;
+  else if (!less(walk->key, key) && !less(key, walk->key)) return walk;
+  else                                                     walk = avl_finger_climb(&finger->path, key, less, NULL);
+
+  while (walk != NULL) {
+    if      (less(key, walk->key)) dir = false;
+    else if (less(walk->key, key)) dir = true;
+    else                           { path_push(&finger->path, walk); return walk; }
+    path_push(&finger->path, walk);
+    walk = *avl_link(walk, dir);
+  }
+
+  walk        = avl_get_node(pool);
+  walk->key   = key;
+  walk->value = value;
+
+  if ((parent = path_top(&finger->path)) == NULL) *tree                  = walk;
+  else                                            *avl_link(parent, dir) = walk;
+
+  avl_rebalance(tree, &finger->path);
+
+  if ((parent = path_top(&finger->path)) == NULL) parent = *tree;
+  else                                            parent = *avl_link(parent, less(parent->key, key));
+
+  for (; parent != walk; parent = *avl_link(parent, less(parent->key, key))) path_push(&finger->path, parent);
+  path_push(&finger->path, walk);
+
+  return walk;
+}
+
+/**
+ * avl_finger_insert - inserts @key and @value into @tree, searching from @finger,
+ * and positions @finger at the node holding @key
+ *
+ * @tree:   tree to insert @key and @value into
+ * @finger: iterator positioned by a previous call or by avl_iter_*; one past either end starts from the root
+ * @key:    the key to insert
+ * @value:  the value to insert
+ * @less:   operator defining the (partial) node order
+ */
+extern inline const struct avl_node *avl_finger_insert(struct avl_node **restrict tree, struct avl_iter *restrict finger, const void *restrict key, void *restrict value, bool (*less)(const void *, const void *)) { return avl_finger_insert_pool(tree, NULL, finger, key, value, less); }
+
+/**
+ * AVL_GENERATE_NODE - defines the node of AVL_GENERATE and its accessors
+ */
+#define AVL_GENERATE_NODE(name, type)                                                                                      \
+struct name##_node {                                                                                                       \
+  type                      key;                                                                                           \
+  void                      *value;                                                                                        \
+  struct name##_node        *left;                                                                                         \
+  struct name##_node        *right;                                                                                        \
+  uint32_t                  height;                                                                                        \
+} __attribute__((aligned(__BIGGEST_ALIGNMENT__)));                                                                         \
+                                                                                                                           \
+static inline struct name##_node *name##_left(const struct name##_node *restrict node) { return node->left; }              \
+                                                                                                                           \
+static inline struct name##_node *name##_right(const struct name##_node *restrict node) { return node->right; }            \
+                                                                                                                           \
+static inline uint32_t name##_height(const struct name##_node *restrict tree) { return tree == NULL ? 0 : tree->height; }  \
+                                                                                                                           \
+static inline void name##_set_left(struct name##_node *restrict node, struct name##_node *child) { node->left = child; }   \
+                                                                                                                           \
+static inline void name##_set_right(struct name##_node *restrict node, struct name##_node *child) { node->right = child; } \
+                                                                                                                           \
+static inline void name##_set_height(struct name##_node *restrict node, const uint32_t height) { node->height = height; }  \
+                                                                                                                           \
+static inline struct name##_node *name##_get_node(struct pool *restrict pool) {                                            \
+  struct name##_node *node = pool == NULL ? malloc(sizeof(struct name##_node)) : pool_alloc(pool);                         \
+  node->left               = NULL;                                                                                         \
+  node->right              = NULL;                                                                                         \
+  node->height             = 1;                                                                                            \
+  return node;                                                                                                             \
+}
+
+/**
+ * AVL_GENERATE_COMPACT_NODE - defines the node of AVL_GENERATE_COMPACT and its accessors
+ *
+ * The height is split across the 3 lowest bits of both links, which are always clear
+ * in a node address, so it is at most 63; an AVL tree that high holds over 10^13 nodes.
+ */
+#define AVL_GENERATE_COMPACT_NODE(name, type)                                                                                                              \
+struct name##_node {                                                                                                                                       \
+  type                      key;                                                                                                                           \
+  void                      *value;                                                                                                                        \
+  uintptr_t                 left;                                                                                                                          \
+  uintptr_t                 right;                                                                                                                         \
+} __attribute__((aligned(__BIGGEST_ALIGNMENT__)));                                                                                                         \
+                                                                                                                                                           \
+_Static_assert(_Alignof(struct name##_node) >= 8, "AVL_GENERATE_COMPACT needs 3 free bits in each child pointer");                                         \
+                                                                                                                                                           \
+static inline struct name##_node *name##_left(const struct name##_node *restrict node) { return (struct name##_node *) (node->left & ~(uintptr_t) 7); }    \
+                                                                                                                                                           \
+static inline struct name##_node *name##_right(const struct name##_node *restrict node) { return (struct name##_node *) (node->right & ~(uintptr_t) 7); }  \
+                                                                                                                                                           \
+static inline uint32_t name##_height(const struct name##_node *restrict tree) { return tree == NULL ? 0 : (tree->left & 7) | (tree->right & 7) << 3; }     \
+                                                                                                                                                           \
+static inline void name##_set_left(struct name##_node *restrict node, struct name##_node *child) { node->left = (uintptr_t) child | (node->left & 7); }    \
+                                                                                                                                                           \
+static inline void name##_set_right(struct name##_node *restrict node, struct name##_node *child) { node->right = (uintptr_t) child | (node->right & 7); } \
+                                                                                                                                                           \
+static inline void name##_set_height(struct name##_node *restrict node, const uint32_t height) {                                                           \
+  node->left  = (node->left & ~(uintptr_t) 7) | (height & 7);                                                                                              \
+  node->right = (node->right & ~(uintptr_t) 7) | (height >> 3 & 7);                                                                                        \
+}                                                                                                                                                          \
+                                                                                                                                                           \
+static inline struct name##_node *name##_get_node(struct pool *restrict pool) {                                                                            \
+  struct name##_node *node = pool == NULL ? malloc(sizeof(struct name##_node)) : pool_alloc(pool);                                                         \
+  node->left               = 1;                                                                                                                            \
+  node->right              = 0;                                                                                                                            \
+  return node;                                                                                                                                             \
+}
+
+/**
+ * AVL_GENERATE_BODY - defines the functions of AVL_GENERATE over the accessors of the node
+ *
+ * name##_rebalance stops at the first node that keeps both its balance and its height, as avl_rebalance does.
+ */
+#define AVL_GENERATE_BODY(name, type, less)                                                                                                                                                   \
+static inline void name##_put_node(struct pool *restrict pool, struct name##_node *restrict node) { pool == NULL ? free(node) : pool_free(pool, node); }                                      \
+                                                                                                                                                                                              \
+static inline void name##_update(struct name##_node *restrict node) { name##_set_height(node, 1 + max(name##_height(name##_left(node)), name##_height(name##_right(node)))); }                \
+                                                                                                                                                                                              \
+static inline void name##_replace(struct name##_node **restrict root, struct name##_node *restrict parent, struct name##_node *restrict node, struct name##_node *child) {                    \
+  if      (parent == NULL)                *root = child;                                                                                                                                      \
+  else if (name##_left(parent) == node)   name##_set_left(parent, child);                                                                                                                     \
+  else                                    name##_set_right(parent, child);                                                                                                                    \
+}                                                                                                                                                                                             \
+                                                                                                                                                                                              \
+static inline void name##_rotate_left(struct name##_node **restrict root, struct name##_node *restrict x, struct name##_node *restrict parent) {                                              \
+  struct name##_node *rchild = name##_right(x);                                                                                                                                               \
+  name##_set_right(x, name##_left(rchild));                                                                                                                                                   \
+  name##_set_left(rchild, x);                                                                                                                                                                 \
+  name##_replace(root, parent, x, rchild);                                                                                                                                                    \
+}                                                                                                                                                                                             \
+                                                                                                                                                                                              \
+static inline void name##_rotate_right(struct name##_node **restrict root, struct name##_node *restrict x, struct name##_node *restrict parent) {                                             \
+  struct name##_node *lchild = name##_left(x);                                                                                                                                                \
+  name##_set_left(x, name##_right(lchild));                                                                                                                                                   \
+  name##_set_right(lchild, x);                                                                                                                                                                \
+  name##_replace(root, parent, x, lchild);                                                                                                                                                    \
+}                                                                                                                                                                                             \
+                                                                                                                                                                                              \
+static inline void name##_rebalance(struct name##_node **restrict tree, struct path_stack *restrict stack) {                                                                                  \
+  register struct name##_node *walk;                                                                                                                                                          \
+           struct name##_node *child;                                                                                                                                                         \
+           uint32_t           old;                                                                                                                                                            \
+                                                                                                                                                                                              \
+  while (!path_empty(stack)) {                                                                                                                                                                \
+    old = name##_height(walk = path_pop(stack));                                                                                                                                              \
+    name##_update(walk);                                                                                                                                                                      \
+                                                                                                                                                                                              \
+    if        (1 + name##_height(name##_right(walk)) < name##_height(name##_left(walk))) {                                                                                                    \
+      child = name##_left(walk);                                                                                                                                                              \
+      if      (name##_height(name##_left(child)) < name##_height(name##_right(child))) {                                                                                                      \
+        name##_rotate_left(tree, child, walk);                                                                                                                                                \
+        name##_update(child);                                                                                                                                                                 \
+        child = name##_left(walk);                                                                                                                                                            \
+      }                                                                                                                                                                                       \
+      name##_rotate_right(tree, walk, path_top(stack));                                                                                                                                       \
+      name##_update(walk);                                                                                                                                                                    \
+      name##_update(child);                                                                                                                                                                   \
+    } else if (1 + name##_height(name##_left(walk)) < name##_height(name##_right(walk))) {                                                                                                    \
+      child = name##_right(walk);                                                                                                                                                             \
+      if      (name##_height(name##_right(child)) < name##_height(name##_left(child))) {                                                                                                      \
+        name##_rotate_right(tree, child, walk);                                                                                                                                               \
+        name##_update(child);                                                                                                                                                                 \
+        child = name##_right(walk);                                                                                                                                                           \
+      }                                                                                                                                                                                       \
+      name##_rotate_left(tree, walk, path_top(stack));                                                                                                                                        \
+      name##_update(walk);                                                                                                                                                                    \
+      name##_update(child);                                                                                                                                                                   \
+    } else if (name##_height(walk) == old) break;                                                                                                                                             \
+  }                                                                                                                                                                                           \
+}                                                                                                                                                                                             \
+                                                                                                                                                                                              \
+static inline struct name##_node *name##_search(struct name##_node *tree, type key) {                                                                                                         \
+  while (tree != NULL) {                                                                                                                                                                      \
+    if      (less(key, tree->key)) tree = name##_left(tree);                                                                                                                                  \
+    else if (less(tree->key, key)) tree = name##_right(tree);                                                                                                                                 \
+    else                           return tree;                                                                                                                                               \
+  }                                                                                                                                                                                           \
+  return NULL;                                                                                                                                                                                \
+}                                                                                                                                                                                             \
+                                                                                                                                                                                              \
+static inline void name##_insert_pool(struct name##_node **restrict tree, struct pool *restrict pool, type key, void *restrict value) {                                                       \
+  register struct name##_node *walk = *tree;                                                                                                                                                  \
+           struct name##_node *parent;                                                                                                                                                        \
+           struct path_stack  stack;                                                                                                                                                          \
+           bool               dir   = false;                                                                                                                                                  \
+                                                                                                                                                                                              \
+  path_init(&stack);                                                                                                                                                                          \
+                                                                                                                                                                                              \
+  while (walk != NULL) {                                                                                                                                                                      \
+    if      (less(key, walk->key)) dir = false;                                                                                                                                               \
+    else if (less(walk->key, key)) dir = true;                                                                                                                                                \
+    else                           return;                                                                                                                                                    \
+    path_push(&stack, walk);                                                                                                                                                                  \
+    walk = dir ? name##_right(walk) : name##_left(walk);                                                                                                                                      \
+  }                                                                                                                                                                                           \
+                                                                                                                                                                                              \
+  walk        = name##_get_node(pool);                                                                                                                                                        \
+  walk->key   = key;                                                                                                                                                                          \
+  walk->value = value;                                                                                                                                                                        \
+                                                                                                                                                                                              \
+  if      ((parent = path_top(&stack)) == NULL) *tree = walk;                                                                                                                                 \
+  else if (dir)                                 name##_set_right(parent, walk);                                                                                                               \
+  else                                          name##_set_left(parent, walk);                                                                                                                \
+                                                                                                                                                                                              \
+  name##_rebalance(tree, &stack);                                                                                                                                                             \
+}                                                                                                                                                                                             \
+                                                                                                                                                                                              \
+static inline void name##_erase_pool(struct name##_node **restrict tree, struct pool *restrict pool, type key) {                                                                              \
+  register struct name##_node *walk = *tree;                                                                                                                                                  \
+           struct name##_node *parent;                                                                                                                                                        \
+           struct path_stack  stack;                                                                                                                                                          \
+                                                                                                                                                                                              \
+  path_init(&stack);                                                                                                                                                                          \
+                                                                                                                                                                                              \
+  while (walk != NULL) {                                                                                                                                                                      \
+    if      (less(key, walk->key)) { path_push(&stack, walk); walk = name##_left(walk); }                                                                                                     \
+    else if (less(walk->key, key)) { path_push(&stack, walk); walk = name##_right(walk); }                                                                                                    \
+    else                           break;                                                                                                                                                     \
+  }                                                                                                                                                                                           \
+                                                                                                                                                                                              \
+  if (walk == NULL) return;                                                                                                                                                                   \
+                                                                                                                                                                                              \
+  if (name##_left(walk) != NULL && name##_right(walk) != NULL) {                                                                                                                              \
+    parent = walk;                                                                                                                                                                            \
+    path_push(&stack, walk);                                                                                                                                                                  \
+                                                                                                                                                                                              \
+    if (name##_height(name##_left(walk)) <= name##_height(name##_right(walk))) for (walk = name##_right(walk); name##_left(walk) != NULL; walk = name##_left(walk))  path_push(&stack, walk); \
+    else                                                                       for (walk = name##_left(walk); name##_right(walk) != NULL; walk = name##_right(walk)) path_push(&stack, walk); \
+                                                                                                                                                                                              \
+    parent->key   = walk->key;                                                                                                                                                                \
+    parent->value = walk->value;                                                                                                                                                              \
+  }                                                                                                                                                                                           \
+                                                                                                                                                                                              \
+  name##_replace(tree, path_top(&stack), walk, name##_left(walk) != NULL ? name##_left(walk) : name##_right(walk));                                                                           \
+  name##_put_node(pool, walk);                                                                                                                                                                \
+  name##_rebalance(tree, &stack);                                                                                                                                                             \
+}                                                                                                                                                                                             \
+                                                                                                                                                                                              \
+static inline void name##_insert(struct name##_node **restrict tree, type key, void *restrict value) { name##_insert_pool(tree, NULL, key, value); }                                          \
+                                                                                                                                                                                              \
+static inline void name##_erase(struct name##_node **restrict tree, type key) { name##_erase_pool(tree, NULL, key); }
+
+/**
+ * AVL_GENERATE - defines an AVL tree specialized for keys of @type
+ *
+ * @name: the prefix of the generated node type and functions
+ * @type: the type of the keys, which are stored by value in the nodes
+ * @less: function or function-like macro on two values of @type defining the (partial) node order
+ *
+ * Defines struct name##_node along with name##_search, name##_insert_pool, name##_insert,
+ * name##_erase_pool and name##_erase, which behave as their generic counterparts
+ * except that keys are passed by value and @less is called directly,
+ * so a comparison costs neither an indirect call nor a dereference and can be inlined.
+ * name##_search returns the node holding the key, or NULL if there is none.
+ *
+ * The links of a node are read by name##_left and name##_right rather than directly,
+ * so the same code walks the nodes of AVL_GENERATE_COMPACT.
+ *
+ * Expand it once per translation unit at file scope, e.g.
+ *
+ *    #define int_less(a, b) ((a) < (b))
+ *    AVL_GENERATE(avl_int, int, int_less)
+ */
+#define AVL_GENERATE(name, type, less) AVL_GENERATE_NODE(name, type) AVL_GENERATE_BODY(name, type, less)
+
+/**
+ * AVL_GENERATE_COMPACT - defines an AVL tree specialized for keys of @type with packed heights
+ *
+ * @name: the prefix of the generated node type and functions
+ * @type: the type of the keys, which are stored by value in the nodes
+ * @less: function or function-like macro on two values of @type defining the (partial) node order
+ *
+ * Generates the same functions as AVL_GENERATE, but the height of a node is packed into its links
+ * instead of a field of its own, so a node with a key of up to 8 bytes takes 32 bytes rather than 48
+ * on x86-64. The links are only valid through name##_left and name##_right.
+ */
+#define AVL_GENERATE_COMPACT(name, type, less) AVL_GENERATE_COMPACT_NODE(name, type) AVL_GENERATE_BODY(name, type, less)
+
 #endif /* _AVLTREE_H */
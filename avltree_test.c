@@ -16,10 +16,84 @@ bool less(const void *a, const void *b) { return *(uintptr_t *)a < *(uintptr_t *
 
 void print(const struct avl_node *restrict node) { printf("%" PRIuPTR " ", *(uintptr_t *)node->key); }
 
+void print_key(const struct avl_node *restrict node) { if (node == NULL) printf("NULL "); else print(node); }
+
+void print_height(const struct avl_node *restrict node) { printf("%" PRIuPTR ":%" PRIu32 " ", *(uintptr_t *)node->key, node->height); }
+
+size_t counted;
+
+void count(const struct avl_node *restrict node) { (void) node; ++counted; }
+
+uintptr_t numbers[1 << 16];
+
+const void *keys[1 << 10];
+
+int balanced_height(const struct avl_node *restrict node) {
+  int left, right;
+
+  if (node == NULL) return 0;
+  left  = balanced_height(node->left);
+  right = balanced_height(node->right);
+  if (left < 0 || right < 0 || right + 1 < left || left + 1 < right || node->height != 1 + (uint32_t) (left < right ? right : left)) return -1;
+  return node->height;
+}
+
+#define key_less(a, b) ((a) < (b))
+
+AVL_GENERATE(avl_gen, uintptr_t, key_less)
+AVL_GENERATE_COMPACT(avl_compact, uintptr_t, key_less)
+
+#define GENERATE_CHECK(name)                                                                                                                           \
+void name##_print(const struct name##_node *restrict tree) {                                                                                           \
+  if (tree != NULL) {                                                                                                                                  \
+    name##_print(name##_left(tree));                                                                                                                   \
+    printf("%" PRIuPTR " ", tree->key);                                                                                                                \
+    name##_print(name##_right(tree));                                                                                                                  \
+  }                                                                                                                                                    \
+}                                                                                                                                                      \
+                                                                                                                                                       \
+int name##_balanced_height(const struct name##_node *restrict tree) {                                                                                  \
+  int left, right;                                                                                                                                     \
+                                                                                                                                                       \
+  if (tree == NULL) return 0;                                                                                                                          \
+  left  = name##_balanced_height(name##_left(tree));                                                                                                   \
+  right = name##_balanced_height(name##_right(tree));                                                                                                  \
+  if (left < 0 || right < 0 || right + 1 < left || left + 1 < right || name##_height(tree) != 1 + (uint32_t) (left < right ? right : left)) return -1; \
+  return name##_height(tree);                                                                                                                          \
+}                                                                                                                                                      \
+                                                                                                                                                       \
+size_t name##_disorder(const struct name##_node *restrict tree, const uintptr_t lo, const uintptr_t hi) {                                              \
+  if (tree == NULL) return 0;                                                                                                                          \
+  return (tree->key < lo || hi <= tree->key) + name##_disorder(name##_left(tree), lo, tree->key)                                                       \
+                                            + name##_disorder(name##_right(tree), tree->key + 1, hi);                                                  \
+}
+
+GENERATE_CHECK(avl_gen)
+GENERATE_CHECK(avl_compact)
+
 int main(void) {
   const uintptr_t testcases[] = {40, 11, 77, 33, 20, 90, 99, 70, 88, 80, 66, 10, 22, 30, 44, 55, 50, 60, 25, 49};
+  const uintptr_t increasing[] = {10, 11, 20, 22, 25, 30, 33, 40, 44, 49, 50, 55, 60, 66, 70, 77, 80, 88, 90, 99};
+  const uintptr_t rebalance[] = {110, 20, 50, 120, 40, 30, 60, 100, 80, 10, 70, 90};
+  const uintptr_t overlap[]   = {5, 10, 22, 35, 44, 60, 61, 77, 95, 99};
+  const uintptr_t absent      = 45;
+  const uintptr_t below       = 5;
+  const uintptr_t beyond      = 100;
+  const size_t    sizes[]     = {0, 1, 2, 3, 4, 7, 8, 15, 16, 1023, 1024};
 
-  struct avl_node *tree = NULL;
+  struct avl_node         *tree = NULL;
+  struct avl_node         *other = NULL;
+  struct avl_node         *left;
+  struct avl_node         *right;
+  struct avl_node         *node;
+  struct avl_gen_node     *gen = NULL;
+  struct avl_compact_node *compact = NULL;
+  struct pool             pool;
+  struct avl_iter         iter;
+  struct avl_iter         finger;
+  const char              *next;
+  const struct avl_node   *walk;
+  size_t                  bad;
 
   for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); ++it) {
     avl_insert(&tree, it, NULL, less);
@@ -41,6 +115,227 @@ int main(void) {
     avl_inorder(tree, print);
     printf("\n");
   }
+  for (const uintptr_t *it = rebalance; it < rebalance + sizeof(rebalance)/sizeof(uintptr_t); ++it) avl_insert(&tree, it, NULL, less);
+  avl_preorder(tree, print_height);
+  printf("\n");
+  avl_erase(&tree, &rebalance[4], less);                                   /* rotates at two levels */
+  avl_preorder(tree, print_height);
+  printf("\n");
+  for (const uintptr_t *it = rebalance; it < rebalance + sizeof(rebalance)/sizeof(uintptr_t); ++it) avl_erase(&tree, it, less);
+
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); ++it) avl_insert(&tree, it, NULL, less);
+  node = avl_split(tree, &testcases[1], &left, &right, less);              /* splits at a present key */
+  print(node);
+  printf("\n");
+  avl_inorder(left, print);
+  printf("\n");
+  avl_inorder(right, print);
+  printf("\n");
+  tree = avl_join(left, node, right);                                      /* joins trees of heights 1 and 5 */
+  avl_preorder(tree, print_height);
+  printf("\n");
+  node = avl_split(tree, &absent, &left, &right, less);                    /* splits at an absent key */
+  printf(node == NULL ? "NULL\n" : "\n");
+  avl_inorder(left, print);
+  printf("\n");
+  avl_inorder(right, print);
+  printf("\n");
+  avl_union(&left, right, less);
+  tree = left;
+  avl_inorder(tree, print);
+  printf("\n");
+
+  for (const uintptr_t *it = overlap; it < overlap + sizeof(overlap)/sizeof(uintptr_t); ++it) avl_insert(&other, it, NULL, less);
+  avl_union(&tree, other, less);
+  avl_inorder(tree, print);
+  printf("\n");
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); ++it) avl_erase(&tree, it, less);
+  for (const uintptr_t *it = overlap; it < overlap + sizeof(overlap)/sizeof(uintptr_t); ++it) avl_erase(&tree, it, less);
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); ++it) avl_insert(&tree, it, NULL, less);
+  other = NULL;
+  for (const uintptr_t *it = overlap; it < overlap + sizeof(overlap)/sizeof(uintptr_t); ++it) avl_insert(&other, it, NULL, less);
+  avl_intersection(&tree, other, less);
+  avl_inorder(tree, print);
+  printf("\n");
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); ++it) avl_erase(&tree, it, less);
+  for (const uintptr_t *it = overlap; it < overlap + sizeof(overlap)/sizeof(uintptr_t); ++it) avl_erase(&tree, it, less);
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); ++it) avl_insert(&tree, it, NULL, less);
+  other = NULL;
+  for (const uintptr_t *it = overlap; it < overlap + sizeof(overlap)/sizeof(uintptr_t); ++it) avl_insert(&other, it, NULL, less);
+  avl_difference(&tree, other, less);
+  avl_inorder(tree, print);
+  printf("\n");
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); ++it) avl_erase(&tree, it, less);
+  for (const uintptr_t *it = overlap; it < overlap + sizeof(overlap)/sizeof(uintptr_t); ++it) avl_erase(&tree, it, less);
+
+  for (uintptr_t i = 0; i < sizeof(numbers)/sizeof(uintptr_t); ++i) numbers[i] = i;
+  pool_init(&pool, sizeof(struct avl_node));
+  other = NULL;
+  for (const uintptr_t *it = numbers; it < numbers + sizeof(numbers)/sizeof(uintptr_t); it += 2) avl_insert_pool(&tree, &pool, it, NULL, less);
+  for (const uintptr_t *it = numbers; it < numbers + sizeof(numbers)/sizeof(uintptr_t); it += 3) avl_insert_pool(&other, &pool, it, NULL, less);
+  avl_union_pool(&tree, other, &pool, less);                                 /* forks above AVL_PARALLEL_HEIGHT under OpenMP */
+  counted = 0;
+  avl_inorder(tree, count);
+  printf("%zu %" PRIu32 "\n", counted, tree->height);
+  pool_destroy(&pool);
+  tree = NULL;
+  pool_init(&pool, sizeof(struct avl_node));
+  other = NULL;
+  for (const uintptr_t *it = numbers; it < numbers + sizeof(numbers)/sizeof(uintptr_t); it += 2) avl_insert_pool(&tree, &pool, it, NULL, less);
+  for (const uintptr_t *it = numbers; it < numbers + sizeof(numbers)/sizeof(uintptr_t); it += 3) avl_insert_pool(&other, &pool, it, NULL, less);
+  avl_intersection_pool(&tree, other, &pool, less);
+  counted = 0;
+  avl_inorder(tree, count);
+  printf("%zu %" PRIu32 "\n", counted, tree->height);
+  pool_destroy(&pool);
+  tree = NULL;
+  pool_init(&pool, sizeof(struct avl_node));
+  other = NULL;
+  for (const uintptr_t *it = numbers; it < numbers + sizeof(numbers)/sizeof(uintptr_t); it += 2) avl_insert_pool(&tree, &pool, it, NULL, less);
+  for (const uintptr_t *it = numbers; it < numbers + sizeof(numbers)/sizeof(uintptr_t); it += 3) avl_insert_pool(&other, &pool, it, NULL, less);
+  avl_difference_pool(&tree, other, &pool, less);
+  counted = 0;
+  avl_inorder(tree, count);
+  printf("%zu %" PRIu32 "\n", counted, tree->height);
+  pool_destroy(&pool);
+  tree = NULL;
+
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); ++it) avl_insert(&tree, it, NULL, less);
+  for (const struct avl_node *node = avl_iter_first(&iter, tree); node != NULL; node = avl_iter_next(&iter)) print(node);
+  print_key(avl_iter_get(&iter));
+  print_key(avl_iter_next(&iter));
+  printf("\n");
+  for (const struct avl_node *node = avl_iter_last(&iter, tree); node != NULL; node = avl_iter_prev(&iter)) print(node);
+  print_key(avl_iter_get(&iter));
+  print_key(avl_iter_prev(&iter));
+  printf("\n");
+  print_key(avl_iter_seek(&iter, tree, &testcases[12], less));            /* seeks a present key */
+  print_key(avl_iter_next(&iter));
+  print_key(avl_iter_next(&iter));
+  print_key(avl_iter_seek(&iter, tree, &absent, less));
+  print_key(avl_iter_prev(&iter));
+  print_key(avl_iter_seek(&iter, tree, &below, less));
+  print_key(avl_iter_prev(&iter));
+  print_key(avl_iter_seek(&iter, tree, &testcases[6], less));             /* seeks the last key */
+  print_key(avl_iter_next(&iter));
+  print_key(avl_iter_seek(&iter, tree, &beyond, less));                   /* seeks past the end */
+  print_key(avl_iter_next(&iter));
+  print_key(avl_iter_prev(&iter));
+  printf("\n");
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); ++it) avl_erase(&tree, it, less);
+  print_key(avl_iter_first(&iter, tree));
+  print_key(avl_iter_last(&iter, tree));
+  print_key(avl_iter_seek(&iter, tree, &below, less));
+  printf("\n");
+
+  avl_iter_first(&finger, tree);                                          /* past the end of the empty tree */
+  for (const uintptr_t *it = increasing; it < increasing + sizeof(increasing)/sizeof(uintptr_t); ++it) {
+    avl_finger_insert(&tree, &finger, it, NULL, less);
+    avl_inorder(tree, print);
+    printf("\n");
+  }
+  avl_preorder(tree, print_height);
+  printf("\n");
+  print_key(avl_iter_get(&finger));
+  print_key(avl_finger_insert(&tree, &finger, &absent, NULL, less));
+  print_key(avl_iter_next(&finger));
+  print_key(avl_iter_prev(&finger));
+  print_key(avl_iter_prev(&finger));
+  printf("\n");
+  print_key(avl_finger_seek(&finger, tree, &testcases[12], less));        /* seeks backwards */
+  print_key(avl_finger_seek(&finger, tree, &below, less));
+  print_key(avl_iter_prev(&finger));
+  printf("\n");
+  print_key(avl_finger_seek(&finger, tree, &beyond, less));               /* moves past the end */
+  print_key(avl_finger_seek(&finger, tree, &testcases[17], less));
+  print_key(avl_iter_next(&finger));
+  print_key(avl_finger_seek(&finger, tree, &beyond, less));
+  print_key(avl_finger_insert(&tree, &finger, &beyond, NULL, less));
+  print_key(avl_iter_next(&finger));
+  print_key(avl_finger_insert(&tree, &finger, &below, NULL, less));
+  print_key(avl_iter_prev(&finger));
+  printf("\n");
+  avl_inorder(tree, print);
+  printf("\n");
+  for (const uintptr_t *it = increasing; it < increasing + sizeof(increasing)/sizeof(uintptr_t); ++it) avl_erase(&tree, it, less);
+  avl_erase(&tree, &absent, less);
+  avl_erase(&tree, &below, less);
+  avl_erase(&tree, &beyond, less);
+
+  pool_init(&pool, sizeof(struct avl_node));
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); ++it) avl_insert_pool(&tree, &pool, it, NULL, less);
+  next = pool.next;
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); it += 2) avl_erase_pool(&tree, &pool, it, less);
+  avl_inorder(tree, print);
+  printf("\n");
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); it += 2) avl_insert_pool(&tree, &pool, it, NULL, less);
+  avl_inorder(tree, print);
+  printf("\n");
+  printf("%d %d\n", pool.next == next, pool.free == NULL);                   /* reuses every erased node before carving a new one */
+  pool_destroy(&pool);
+  tree = NULL;
+
+  for (size_t i = 0; i < sizeof(keys)/sizeof(void *); ++i) keys[i] = &numbers[2*i];
+  for (const size_t *n = sizes; n < sizes + sizeof(sizes)/sizeof(size_t); ++n) {
+    avl_build_sorted(&tree, keys, NULL, *n);
+    bad  = 0;
+    walk = avl_iter_first(&iter, tree);
+    for (size_t i = 0; i < *n; ++i, walk = avl_iter_next(&iter)) bad += walk == NULL || walk->key != keys[i];
+    bad += walk != NULL;
+    printf("%zu %d %zu", *n, balanced_height(tree), bad);
+    for (size_t i = 1; i < *n; i += 2) avl_erase(&tree, keys[i], less);
+    printf(" %d", balanced_height(tree));
+    for (size_t i = 0; i < *n; i += 2) avl_erase(&tree, keys[i], less);
+    printf(" %s\n", tree == NULL ? "NULL" : "not empty");
+  }
+
+  bad = 0;
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); ++it) {
+    avl_gen_insert(&gen, *it, NULL);
+    avl_gen_print(gen);
+    printf("\n");
+    bad += avl_gen_balanced_height(gen) < 0;
+  }
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); ++it) {
+    avl_gen_erase(&gen, *it);
+    avl_gen_print(gen);
+    printf("\n");
+    bad += avl_gen_balanced_height(gen) < 0;
+  }
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); ++it) {
+    avl_gen_insert(&gen, *it, NULL);
+    avl_gen_print(gen);
+    printf("\n");
+    bad += avl_gen_balanced_height(gen) < 0;
+  }
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); ++it) printf("%d", avl_gen_search(gen, *it) != NULL && avl_gen_search(gen, *it)->key == *it);
+  printf(" %d%d%d\n", avl_gen_search(gen, absent) != NULL, avl_gen_search(gen, below) != NULL, avl_gen_search(gen, beyond) != NULL);
+  for (const uintptr_t *it = testcases + sizeof(testcases)/sizeof(uintptr_t) - 1; testcases <= it; --it) {
+    avl_gen_erase(&gen, *it);
+    avl_gen_print(gen);
+    printf("\n");
+    bad += avl_gen_balanced_height(gen) < 0;
+  }
+  printf("%zu %s\n", bad, gen == NULL ? "NULL" : "not empty");
+
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); ++it) avl_compact_insert(&compact, *it, NULL);
+  avl_compact_print(compact);
+  printf("\n");
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); it += 2) avl_compact_erase(&compact, *it);
+  avl_compact_print(compact);
+  printf("\n");
+  for (const uintptr_t *it = testcases+1; it < testcases + sizeof(testcases)/sizeof(uintptr_t); it += 2) avl_compact_erase(&compact, *it);
+  for (size_t i = 0; i < sizeof(numbers)/sizeof(uintptr_t); ++i) avl_compact_insert(&compact, numbers[i*7919 % (sizeof(numbers)/sizeof(uintptr_t))], NULL);
+  bad = avl_compact_disorder(compact, 0, UINTPTR_MAX);
+  for (size_t i = 0; i < sizeof(numbers)/sizeof(uintptr_t); ++i) bad += avl_compact_search(compact, numbers[i]) == NULL;
+  bad += avl_compact_search(compact, numbers[sizeof(numbers)/sizeof(uintptr_t) - 1] + 1) != NULL;
+  printf("%zu %d %zu", sizeof(numbers)/sizeof(uintptr_t), avl_compact_balanced_height(compact), bad);
+  for (size_t i = 1; i < sizeof(numbers)/sizeof(uintptr_t); i += 2) avl_compact_erase(&compact, numbers[i]);
+  bad = avl_compact_disorder(compact, 0, UINTPTR_MAX);
+  for (size_t i = 0; i < sizeof(numbers)/sizeof(uintptr_t); ++i) bad += (avl_compact_search(compact, numbers[i]) == NULL) != (i % 2 == 1);
+  printf(" %d %zu", avl_compact_balanced_height(compact), bad);
+  for (size_t i = 0; i < sizeof(numbers)/sizeof(uintptr_t); i += 2) avl_compact_erase(&compact, numbers[i]);
+  printf(" %s\n", compact == NULL ? "NULL" : "not empty");
   /*
    * 40
    * 11 40
@@ -122,5 +417,157 @@ int main(void) {
    * 11 40
    * 40
    *
+   * 50:5 30:3 20:2 10:1 40:1 80:4 60:2 70:1 110:3 100:2 90:1 120:1
+   * 80:4 50:3 20:2 10:1 30:1 60:2 70:1 110:3 100:2 90:1 120:1
+   *
+   * 11
+   * 10
+   * 20 22 25 30 33 40 44 49 50 55 60 66 70 77 80 88 90 99
+   * 40:5 22:3 11:2 10:1 20:1 30:2 25:1 33:1 77:4 55:3 49:2 44:1 50:1 66:2 60:1 70:1 88:3 80:1 90:2 99:1
+   * NULL
+   * 10 11 20 22 25 30 33 40 44
+   * 49 50 55 60 66 70 77 80 88 90 99
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70 77 80 88 90 99
+   * 5 10 11 20 22 25 30 33 35 40 44 49 50 55 60 61 66 70 77 80 88 90 95 99
+   * 10 22 44 60 77 99
+   * 11 20 25 30 33 40 49 50 55 66 70 80 88 90
+   * 43691 16
+   * 10923 14
+   * 21845 15
+   *
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70 77 80 88 90 99 NULL NULL
+   * 99 90 88 80 77 70 66 60 55 50 49 44 40 33 30 25 22 20 11 10 NULL NULL
+   * 22 25 30 49 44 10 NULL 99 NULL NULL NULL NULL
+   * NULL NULL NULL
+   *
+   * 10
+   * 10 11
+   * 10 11 20
+   * 10 11 20 22
+   * 10 11 20 22 25
+   * 10 11 20 22 25 30
+   * 10 11 20 22 25 30 33
+   * 10 11 20 22 25 30 33 40
+   * 10 11 20 22 25 30 33 40 44
+   * 10 11 20 22 25 30 33 40 44 49
+   * 10 11 20 22 25 30 33 40 44 49 50
+   * 10 11 20 22 25 30 33 40 44 49 50 55
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70 77
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70 77 80
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70 77 80 88
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70 77 80 88 90
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70 77 80 88 90 99
+   * 40:5 22:3 11:2 10:1 20:1 30:2 25:1 33:1 77:4 55:3 49:2 44:1 50:1 66:2 60:1 70:1 88:3 80:1 90:2 99:1
+   * 99 45 49 45 44
+   * 22 10 NULL
+   * NULL 60 66 NULL 100 NULL 5 NULL
+   * 5 10 11 20 22 25 30 33 40 44 45 49 50 55 60 66 70 77 80 88 90 99 100
+   *
+   * 10 11 30 33 49 55 60 70 80 90
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70 77 80 88 90 99
+   * 1 1
+   *
+   * 0 0 0 0 NULL
+   * 1 1 0 1 NULL
+   * 2 2 0 1 NULL
+   * 3 2 0 2 NULL
+   * 4 3 0 2 NULL
+   * 7 3 0 3 NULL
+   * 8 4 0 3 NULL
+   * 15 4 0 4 NULL
+   * 16 5 0 4 NULL
+   * 1023 10 0 10 NULL
+   * 1024 11 0 10 NULL
+   *
+   * 40
+   * 11 40
+   * 11 40 77
+   * 11 33 40 77
+   * 11 20 33 40 77
+   * 11 20 33 40 77 90
+   * 11 20 33 40 77 90 99
+   * 11 20 33 40 70 77 90 99
+   * 11 20 33 40 70 77 88 90 99
+   * 11 20 33 40 70 77 80 88 90 99
+   * 11 20 33 40 66 70 77 80 88 90 99
+   * 10 11 20 33 40 66 70 77 80 88 90 99
+   * 10 11 20 22 33 40 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 44 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 44 55 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 44 50 55 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 44 50 55 60 66 70 77 80 88 90 99
+   * 10 11 20 22 25 30 33 40 44 50 55 60 66 70 77 80 88 90 99
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70 77 80 88 90 99
+   * 10 11 20 22 25 30 33 44 49 50 55 60 66 70 77 80 88 90 99
+   * 10 20 22 25 30 33 44 49 50 55 60 66 70 77 80 88 90 99
+   * 10 20 22 25 30 33 44 49 50 55 60 66 70 80 88 90 99
+   * 10 20 22 25 30 44 49 50 55 60 66 70 80 88 90 99
+   * 10 22 25 30 44 49 50 55 60 66 70 80 88 90 99
+   * 10 22 25 30 44 49 50 55 60 66 70 80 88 99
+   * 10 22 25 30 44 49 50 55 60 66 70 80 88
+   * 10 22 25 30 44 49 50 55 60 66 80 88
+   * 10 22 25 30 44 49 50 55 60 66 80
+   * 10 22 25 30 44 49 50 55 60 66
+   * 10 22 25 30 44 49 50 55 60
+   * 22 25 30 44 49 50 55 60
+   * 25 30 44 49 50 55 60
+   * 25 44 49 50 55 60
+   * 25 49 50 55 60
+   * 25 49 50 60
+   * 25 49 60
+   * 25 49
+   * 49
+   *
+   * 40
+   * 11 40
+   * 11 40 77
+   * 11 33 40 77
+   * 11 20 33 40 77
+   * 11 20 33 40 77 90
+   * 11 20 33 40 77 90 99
+   * 11 20 33 40 70 77 90 99
+   * 11 20 33 40 70 77 88 90 99
+   * 11 20 33 40 70 77 80 88 90 99
+   * 11 20 33 40 66 70 77 80 88 90 99
+   * 10 11 20 33 40 66 70 77 80 88 90 99
+   * 10 11 20 22 33 40 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 44 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 44 55 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 44 50 55 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 44 50 55 60 66 70 77 80 88 90 99
+   * 10 11 20 22 25 30 33 40 44 50 55 60 66 70 77 80 88 90 99
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70 77 80 88 90 99
+   * 11111111111111111111 000
+   * 10 11 20 22 25 30 33 40 44 50 55 60 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 44 50 55 60 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 44 50 55 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 44 55 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 44 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 66 70 77 80 88 90 99
+   * 10 11 20 22 33 40 66 70 77 80 88 90 99
+   * 10 11 20 33 40 66 70 77 80 88 90 99
+   * 11 20 33 40 66 70 77 80 88 90 99
+   * 11 20 33 40 70 77 80 88 90 99
+   * 11 20 33 40 70 77 88 90 99
+   * 11 20 33 40 70 77 90 99
+   * 11 20 33 40 77 90 99
+   * 11 20 33 40 77 90
+   * 11 20 33 40 77
+   * 11 33 40 77
+   * 11 40 77
+   * 11 40
+   * 40
+   *
+   * 0 NULL
+   *
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70 77 80 88 90 99
+   * 10 11 30 33 49 55 60 70 80 90
+   * 65536 20 0 19 0 NULL
+   *
    */
 }
@@ -8,55 +8,46 @@
  * B+-tree implementation
  */
 
+#include <stdint.h>
+
+#include "search.h"
 #include "stack.h"
 #include "bplustree.h"
 
 /**
  * getTerminalNode returns a new terminal node.
+ * The header and K share a single allocation aligned to a cache line,
+ * and K has a spare entry so that an overflowing node is split in place.
  * @param m: fanout of B+-tree
  */
 static inline TerminalNode *getTerminalNode(const unsigned int m) {
-  TerminalNode *node  = malloc(sizeof(TerminalNode));
+  const size_t size   = sizeof(TerminalNode)+sizeof(int)*(m+1)+CACHE_LINE_SIZE-1 & ~(size_t)(CACHE_LINE_SIZE-1);
+  TerminalNode *node  = aligned_alloc(CACHE_LINE_SIZE, size);
   node -> q           = 0;
-  node -> K           = malloc(sizeof(int)*m);
+  node -> K           = (int *)(node+1);
   node -> P           = NULL;
   return node;
 }
 
 /**
  * getInternalNode returns a new internal node.
+ * The header, K and either Pi or Pt share a single allocation aligned to a cache line,
+ * and K and the pointers have a spare entry so that an overflowing node is split in place.
  * @param m: fanout of B+-tree
+ * @param terminal: whether the children of the node are terminal nodes
  */
-static inline InternalNode *getInternalNode(const unsigned int m) {
-  InternalNode *node  = malloc(sizeof(InternalNode));
-  node -> n           = 0;
-  node -> K           = malloc(sizeof(int)*(m-1));
-  node -> Pi          = NULL;
-  node -> Pt          = NULL;
+static inline InternalNode *getInternalNode(const unsigned int m, const bool terminal) {
+  const size_t  offset  = sizeof(InternalNode)+(sizeof(int)*m+sizeof(void *)-1 & ~(sizeof(void *)-1)),
+                size    = offset+sizeof(void *)*(m+1)+CACHE_LINE_SIZE-1 & ~(size_t)(CACHE_LINE_SIZE-1);
+  InternalNode *node    = aligned_alloc(CACHE_LINE_SIZE, size);
+  void **P              = memset((char *)node+offset, 0, sizeof(void *)*(m+1));
+  node -> n             = 0;
+  node -> K             = (int *)(node+1);
+  node -> Pi            = terminal ? NULL : (InternalNode **)P;
+  node -> Pt            = terminal ? (TerminalNode **)P : NULL;
   return node;
 }
 
-/**
- * binarySearch returns index i where K[i-1] < key <= K[i].
- * @param K: an array
- * @param n: size of array
- * @param key: a key to search
- */
-static inline unsigned int binarySearch(const int *K, const unsigned int n, const int key) {
-  register int  i = 0,
-                j = n-1;
-  register unsigned int mid;
-
-  while (i <= j) {
-    mid = i+j>>1;
-    if (key == K[mid])  return mid;
-    if (key < K[mid])   j = mid-1;
-    else                i = mid+1;
-  }
-
-  return i;
-}
-
 /**
  * insertBPT inserts newKey into T.
  * @param T: a B+-tree
@@ -73,15 +64,18 @@ void insertBPT(Tree *T, const unsigned int m, const int newKey) {
   register InternalNode *x  = (*T) -> IndexSet,
                         *y  = NULL;
   TerminalNode *z           = (*T) -> SequenceSet;
-  stack stack               = NULL,
-        iStack              = NULL;
+  struct path_stack stack,
+                    iStack;
   register int key          = newKey;
   register unsigned int i;
 
+  path_init(&stack);
+  path_init(&iStack);
+
   while (x != NULL) {                             /* find position to insert newKey while storing x on the stack */
-    i = binarySearch(x -> K, x -> n, newKey);
-    push(&stack, x);
-    push(&iStack, i);
+    i = lower_bound(x -> K, x -> n, newKey);
+    path_push(&stack, x);
+    path_push(&iStack, (void *)(uintptr_t)i);
     if (x -> Pi != NULL)  { x = x -> Pi[i]; }
     else                  { z = x -> Pt[i]; x = NULL; }
   }
@@ -90,131 +84,74 @@ void insertBPT(Tree *T, const unsigned int m, const int newKey) {
     (*T) -> SequenceSet         = getTerminalNode(m);
     (*T) -> SequenceSet -> K[0] = key;
     (*T) -> SequenceSet -> q++;
-    clear(&stack);
-    clear(&iStack);
     return;
   }
 
-  if ((i = binarySearch(z -> K, z -> q, newKey)) < z -> q && newKey == z -> K[i]) { clear(&stack); clear(&iStack); return; }
+  if ((i = lower_bound(z -> K, z -> q, newKey)) < z -> q && newKey == z -> K[i]) return;
 
-  if (z -> q < m) {
-    memcpy(&z -> K[i+1], &z -> K[i], sizeof(int)*(z -> q-i));
-    z -> K[i] = key;
-    z -> q++;
-    clear(&stack);
-    clear(&iStack);
-    return;
-  }
+  memmove(&z -> K[i+1], &z -> K[i], sizeof(int)*(z -> q-i));
+  z -> K[i] = key;
 
-  TerminalNode *TempNode  = getTerminalNode(m+1),
-               *newNode   = getTerminalNode(m);
-  memcpy(TempNode -> K, z -> K, sizeof(int)*i);
-  memcpy(&TempNode -> K[i+1], &z -> K[i], sizeof(int)*(z -> q-i));
-  TempNode -> K[i] = key;
+  if (++z -> q <= m) return;
 
-  memcpy(z -> K, TempNode -> K, sizeof(int)*(m+1>>1));
-  memcpy(newNode -> K, &TempNode -> K[(m+1)/2], sizeof(int)*((m>>1)+1));
+  TerminalNode *newNode = getTerminalNode(m); /* split z, which overflows into its spare entry */
+  memcpy(newNode -> K, &z -> K[(m+1)/2], sizeof(int)*((m>>1)+1));
   z -> q        = m+1>>1;
   newNode -> q  = (m>>1)+1;
   key           = z -> K[z -> q-1];
   newNode -> P  = z -> P;
   z -> P        = newNode;
 
-  free(TempNode);
-
-  if (empty(stack)) {
-    (*T) -> IndexSet          = getInternalNode(m);
-    (*T) -> IndexSet -> Pt    = calloc(m, sizeof(TerminalNode *));
+  if (path_empty(&stack)) {
+    (*T) -> IndexSet          = getInternalNode(m, true);
     (*T) -> IndexSet -> K[0]  = key;
     (*T) -> IndexSet -> Pt[0] = z;
     (*T) -> IndexSet -> Pt[1] = newNode;
     (*T) -> IndexSet -> n++;
-    clear(&stack);
-    clear(&iStack);
     return;
   }
 
-  x = pop(&stack);
-  i = pop(&iStack);
+  x = path_pop(&stack);
+  i = (uintptr_t)path_pop(&iStack);
 
-  if (x -> n < m-1) {
-    memcpy(&x -> K[i+1], &x -> K[i], sizeof(int)*(x -> n-i));
-    memcpy(&x -> Pt[i+2], &x -> Pt[i+1], sizeof(TerminalNode *)*(x -> n-i));
-    x -> K[i]     = key;
-    x -> Pt[i+1]  = newNode;
-    x -> n++;
-    clear(&stack);
-    clear(&iStack);
-    return;
-  }
+  memmove(&x -> K[i+1], &x -> K[i], sizeof(int)*(x -> n-i));
+  memmove(&x -> Pt[i+2], &x -> Pt[i+1], sizeof(TerminalNode *)*(x -> n-i));
+  x -> K[i]     = key;
+  x -> Pt[i+1]  = newNode;
+
+  if (++x -> n < m) return;
 
-  register InternalNode *tempNode = getInternalNode(m+1);
-  tempNode -> Pt                  = calloc(m+1, sizeof(TerminalNode *));
-  memcpy(tempNode -> K, x -> K, sizeof(int)*i);
-  memcpy(&tempNode -> K[i+1], &x -> K[i], sizeof(int)*(x -> n-i));
-  memcpy(tempNode -> Pt, x -> Pt, sizeof(TerminalNode *)*(i+1));
-  memcpy(&tempNode -> Pt[i+2], &x -> Pt[i+1], sizeof(TerminalNode *)*(x -> n-i));
-  tempNode -> K[i]    = key;
-  tempNode -> Pt[i+1] = newNode;
-
-  y       = getInternalNode(m);
-  y -> Pt = calloc(m, sizeof(TerminalNode *));
-  memcpy(x -> K, tempNode -> K, sizeof(int)*(m>>1));
-  memcpy(x -> Pt, tempNode -> Pt, sizeof(TerminalNode *)*((m>>1)+1));
-  memcpy(y -> K, &tempNode -> K[m/2+1], sizeof(int)*(m-(m>>1)-1));
-  memcpy(y -> Pt, &tempNode -> Pt[m/2+1], sizeof(TerminalNode *)*(m-(m>>1)));
+  y = getInternalNode(m, true);                 /* split x, which overflows into its spare entry */
+  memcpy(y -> K, &x -> K[m/2+1], sizeof(int)*(m-(m>>1)-1));
+  memcpy(y -> Pt, &x -> Pt[m/2+1], sizeof(TerminalNode *)*(m-(m>>1)));
   x -> n  = m>>1;
   y -> n  = m-(m>>1)-1;
-  key     = tempNode -> K[m>>1];
+  key     = x -> K[m>>1];
 
-  free(tempNode);
+  while (!path_empty(&stack)) {
+    x = path_pop(&stack);
+    i = (uintptr_t)path_pop(&iStack);
 
-  while (!empty(stack)) {
-    x = pop(&stack);
-    i = pop(&iStack);
+    memmove(&x -> K[i+1], &x -> K[i], sizeof(int)*(x -> n-i));
+    memmove(&x -> Pi[i+2], &x -> Pi[i+1], sizeof(InternalNode *)*(x -> n-i));
+    x -> K[i]     = key;
+    x -> Pi[i+1]  = y;
 
-    if (x -> n < m-1) {
-      memcpy(&x -> K[i+1], &x -> K[i], sizeof(int)*(x -> n-i));
-      memcpy(&x -> Pi[i+2], &x -> Pi[i+1], sizeof(InternalNode *)*(x -> n-i));
-      x -> K[i]     = key;
-      x -> Pi[i+1]  = y;
-      x -> n++;
-      clear(&stack);
-      clear(&iStack);
-      return;
-    }
+    if (++x -> n < m) return;
 
-    tempNode        = getInternalNode(m+1);
-    tempNode -> Pi  = calloc(m+1, sizeof(InternalNode *));
-    memcpy(tempNode -> K, x -> K, sizeof(int)*i);
-    memcpy(&tempNode -> K[i+1], &x -> K[i], sizeof(int)*(x -> n-i));
-    memcpy(tempNode -> Pi, x -> Pi, sizeof(InternalNode *)*(i+1));
-    memcpy(&tempNode -> Pi[i+2], &x -> Pi[i+1], sizeof(InternalNode *)*(x -> n-i));
-    tempNode -> K[i]    = key;
-    tempNode -> Pi[i+1] = y;
-
-    y       = getInternalNode(m);
-    y -> Pi = calloc(m, sizeof(InternalNode *));
-    memcpy(x -> K, tempNode -> K, sizeof(int)*(m>>1));
-    memcpy(x -> Pi, tempNode -> Pi, sizeof(InternalNode *)*((m>>1)+1));
-    memcpy(y -> K, &tempNode -> K[m/2+1], sizeof(int)*(m-(m>>1)-1));
-    memcpy(y -> Pi, &tempNode -> Pi[m/2+1], sizeof(InternalNode *)*(m-(m>>1)));
+    y = getInternalNode(m, false);              /* split x, which overflows into its spare entry */
+    memcpy(y -> K, &x -> K[m/2+1], sizeof(int)*(m-(m>>1)-1));
+    memcpy(y -> Pi, &x -> Pi[m/2+1], sizeof(InternalNode *)*(m-(m>>1)));
     x -> n  = m>>1;
     y -> n  = m-(m>>1)-1;
-    key     = tempNode -> K[m>>1];
-
-    free(tempNode);
+    key     = x -> K[m>>1];
   }
 
-  (*T) -> IndexSet          = getInternalNode(m); /* the level of tree increases */
-  (*T) -> IndexSet -> Pi    = calloc(m, sizeof(InternalNode *));
+  (*T) -> IndexSet          = getInternalNode(m, false); /* the level of tree increases */
   (*T) -> IndexSet -> K[0]  = key;
   (*T) -> IndexSet -> Pi[0] = x;
   (*T) -> IndexSet -> Pi[1] = y;
   (*T) -> IndexSet -> n     = 1;
-
-  clear(&stack);
-  clear(&iStack);
 }
 
 /**
@@ -229,34 +166,35 @@ void deleteBPT(Tree *T, const unsigned int m, const int oldKey) {
   register InternalNode *x  = (*T) -> IndexSet,
                         *y  = NULL;
   TerminalNode *z           = (*T) -> SequenceSet;
-  stack stack               = NULL,
-        iStack              = NULL;
+  struct path_stack stack,
+                    iStack;
   register unsigned int i;
 
+  path_init(&stack);
+  path_init(&iStack);
+
   while (x != NULL) {                                                                 /* find position of oldKey while storing x on the stack */
-    i = binarySearch(x -> K, x -> n, oldKey);
-    push(&stack, x);
-    push(&iStack, i);
+    i = lower_bound(x -> K, x -> n, oldKey);
+    path_push(&stack, x);
+    path_push(&iStack, (void *)(uintptr_t)i);
     if (x -> Pi != NULL)  { x = x -> Pi[i]; }
     else                  { z = x -> Pt[i]; x = NULL; }
   }
 
-  if ((i = binarySearch(z -> K, z -> q, oldKey)) < z -> q && oldKey != z -> K[i] || z -> q <= i) { clear(&stack); clear(&iStack); return; }
+  if ((i = lower_bound(z -> K, z -> q, oldKey)) < z -> q && oldKey != z -> K[i] || z -> q <= i) return;
 
   z -> q--;
-  memcpy(&z -> K[i], &z -> K[i+1], sizeof(int)*(z -> q-i));
+  memmove(&z -> K[i], &z -> K[i+1], sizeof(int)*(z -> q-i));
 
-  if (m+1>>1 <= z -> q) { clear(&stack); clear(&iStack); return; }
+  if (m+1>>1 <= z -> q) return;
 
-  if    (empty(stack)) {
+  if    (path_empty(&stack)) {
     if  (z -> q == 0) { (*T) -> SequenceSet = NULL; *T = NULL; free(z); }
-    clear(&stack);
-    clear(&iStack);
     return;
   }
 
-  x                         = pop(&stack);
-  i                         = pop(&iStack);
+  x                         = path_pop(&stack);
+  i                         = (uintptr_t)path_pop(&iStack);
   register unsigned int b   = i == 0                                ? i+1
                             : i == x -> n                           ? i-1
                             : x -> Pt[i-1] -> q < x -> Pt[i+1] -> q ? i+1
@@ -265,32 +203,30 @@ void deleteBPT(Tree *T, const unsigned int m, const int oldKey) {
 
   if    (m+1>>1 < BestSibling -> q) {                                                 /* case of key redistribution */
     if  (b < i) {
-      memcpy(&z -> K[1], z -> K, sizeof(int)*z -> q);
+      memmove(&z -> K[1], z -> K, sizeof(int)*z -> q);
       z -> K[0]   = BestSibling -> K[BestSibling -> q-1];
       x -> K[i-1] = BestSibling -> K[BestSibling -> q-2];
     } else {
       z -> K[z -> q]  = BestSibling -> K[0];
       x -> K[i]       = z -> K[z -> q];
-      memcpy(BestSibling -> K, &BestSibling -> K[1], sizeof(int)*(BestSibling -> q-1));
+      memmove(BestSibling -> K, &BestSibling -> K[1], sizeof(int)*(BestSibling -> q-1));
     }
     z -> q++;
     BestSibling -> q--;
-    clear(&stack);
-    clear(&iStack);
     return;
   }
 
   if (b < i) {                                                                        /* case of terminal node merge */
     memcpy(&BestSibling -> K[BestSibling -> q], z -> K, sizeof(int)*z -> q);
-    memcpy(&x -> K[i-1], &x -> K[i], sizeof(int)*(x -> n-i));
-    memcpy(&x -> Pt[i], &x -> Pt[i+1], sizeof(TerminalNode *)*(x -> n-i));
+    memmove(&x -> K[i-1], &x -> K[i], sizeof(int)*(x -> n-i));
+    memmove(&x -> Pt[i], &x -> Pt[i+1], sizeof(TerminalNode *)*(x -> n-i));
     BestSibling -> q += z -> q;
     BestSibling -> P  = z -> P;
     free(z);
   } else {
     memcpy(&z -> K[z -> q], BestSibling -> K, sizeof(int)*BestSibling -> q);
-    memcpy(&x -> K[i], &x -> K[i+1], sizeof(int)*(x -> n-i-1));
-    memcpy(&x -> Pt[i+1], &x -> Pt[i+2], sizeof(TerminalNode *)*(x -> n-i-1));
+    memmove(&x -> K[i], &x -> K[i+1], sizeof(int)*(x -> n-i-1));
+    memmove(&x -> Pt[i+1], &x -> Pt[i+2], sizeof(TerminalNode *)*(x -> n-i-1));
     z -> q += BestSibling -> q;
     z -> P  = BestSibling -> P;
     free(BestSibling);
@@ -298,16 +234,14 @@ void deleteBPT(Tree *T, const unsigned int m, const int oldKey) {
   x -> Pt[x -> n] = NULL;
   x -> n--;
 
-  if    (m-1>>1 <= x -> n) { clear(&stack); clear(&iStack); return; }
-  if    (empty(stack)) {
+  if    (m-1>>1 <= x -> n) return;
+  if    (path_empty(&stack)) {
     if  (x -> n == 0) { (*T) -> IndexSet = NULL; free(x); }
-    clear(&stack);
-    clear(&iStack);
     return;
   }
 
-  y                                   = pop(&stack);
-  i                                   = pop(&iStack);
+  y                                   = path_pop(&stack);
+  i                                   = (uintptr_t)path_pop(&iStack);
   b                                   = i == 0                                ? i+1
                                       : i == y -> n                           ? i-1
                                       : y -> Pi[i-1] -> n < y -> Pi[i+1] -> n ? i+1
@@ -316,8 +250,8 @@ void deleteBPT(Tree *T, const unsigned int m, const int oldKey) {
 
   if    (m-1>>1 < bestSibling -> n) {                                                 /* case of key redistribution */
     if  (b < i) {
-      memcpy(&x -> K[1], x -> K, sizeof(int)*x -> n);
-      memcpy(&x -> Pt[1], x -> Pt, sizeof(TerminalNode *)*(x -> n+1));
+      memmove(&x -> K[1], x -> K, sizeof(int)*x -> n);
+      memmove(&x -> Pt[1], x -> Pt, sizeof(TerminalNode *)*(x -> n+1));
       x -> K[0]   = y -> K[i-1];
       y -> K[i-1] = bestSibling -> K[bestSibling -> n-1];
       x -> Pt[0]  = bestSibling -> Pt[bestSibling -> n];
@@ -325,14 +259,12 @@ void deleteBPT(Tree *T, const unsigned int m, const int oldKey) {
       x -> K[x -> n]    = y -> K[i];
       y -> K[i]         = bestSibling -> K[0];
       x -> Pt[x -> n+1] = bestSibling -> Pt[0];
-      memcpy(bestSibling -> K, &bestSibling -> K[1], sizeof(int)*(bestSibling -> n-1));
-      memcpy(bestSibling -> Pt, &bestSibling -> Pt[1], sizeof(TerminalNode *)*(bestSibling -> n));
+      memmove(bestSibling -> K, &bestSibling -> K[1], sizeof(int)*(bestSibling -> n-1));
+      memmove(bestSibling -> Pt, &bestSibling -> Pt[1], sizeof(TerminalNode *)*(bestSibling -> n));
     }
     bestSibling -> Pt[bestSibling -> n] = NULL;
     bestSibling -> n--;
     x -> n++;
-    clear(&stack);
-    clear(&iStack);
     return;
   }
 
@@ -340,16 +272,16 @@ void deleteBPT(Tree *T, const unsigned int m, const int oldKey) {
     bestSibling -> K[bestSibling -> n] = y -> K[i-1];
     memcpy(&bestSibling -> K[bestSibling -> n+1], x -> K, sizeof(int)*x -> n);
     memcpy(&bestSibling -> Pt[bestSibling -> n+1], x -> Pt, sizeof(TerminalNode *)*(x -> n+1));
-    memcpy(&y -> K[i-1], &y -> K[i], sizeof(int)*(y -> n-i));
-    memcpy(&y -> Pi[i], &y -> Pi[i+1], sizeof(InternalNode *)*(y -> n-i));
+    memmove(&y -> K[i-1], &y -> K[i], sizeof(int)*(y -> n-i));
+    memmove(&y -> Pi[i], &y -> Pi[i+1], sizeof(InternalNode *)*(y -> n-i));
     bestSibling -> n += x -> n+1;
     free(x);
   } else {
     x -> K[x -> n] = y -> K[i];
     memcpy(&x -> K[x -> n+1], bestSibling -> K, sizeof(int)*bestSibling -> n);
     memcpy(&x -> Pt[x -> n+1], bestSibling -> Pt, sizeof(TerminalNode *)*(bestSibling -> n+1));
-    memcpy(&y -> K[i], &y -> K[i+1], sizeof(int)*(y -> n-i-1));
-    memcpy(&y -> Pi[i+1], &y -> Pi[i+2], sizeof(InternalNode *)*(y -> n-i-1));
+    memmove(&y -> K[i], &y -> K[i+1], sizeof(int)*(y -> n-i-1));
+    memmove(&y -> Pi[i+1], &y -> Pi[i+2], sizeof(InternalNode *)*(y -> n-i-1));
     x -> n += bestSibling -> n+1;
     free(bestSibling);
   }
@@ -357,11 +289,11 @@ void deleteBPT(Tree *T, const unsigned int m, const int oldKey) {
   y -> n--;
   x = y;
 
-  while (!empty(stack)) {
-    if  (m-1>>1 <= x -> n) { clear(&stack); clear(&iStack); return; }
+  while (!path_empty(&stack)) {
+    if  (m-1>>1 <= x -> n) return;
 
-    y           = pop(&stack);
-    i           = pop(&iStack);
+    y           = path_pop(&stack);
+    i           = (uintptr_t)path_pop(&iStack);
     b           = i == 0                                ? i+1
                 : i == y -> n                           ? i-1
                 : y -> Pi[i-1] -> n < y -> Pi[i+1] -> n ? i+1
@@ -370,8 +302,8 @@ void deleteBPT(Tree *T, const unsigned int m, const int oldKey) {
 
     if    (m-1>>1 < bestSibling -> n) {                                               /* case of key redistribution */
       if  (b < i) {
-        memcpy(&x -> K[1], x -> K, sizeof(int)*x -> n);
-        memcpy(&x -> Pi[1], x -> Pi, sizeof(InternalNode *)*(x -> n+1));
+        memmove(&x -> K[1], x -> K, sizeof(int)*x -> n);
+        memmove(&x -> Pi[1], x -> Pi, sizeof(InternalNode *)*(x -> n+1));
         x -> K[0]   = y -> K[i-1];
         y -> K[i-1] = bestSibling -> K[bestSibling -> n-1];
         x -> Pi[0]  = bestSibling -> Pi[bestSibling -> n];
@@ -379,8 +311,8 @@ void deleteBPT(Tree *T, const unsigned int m, const int oldKey) {
         x -> K[x -> n]    = y -> K[i];
         y -> K[i]         = bestSibling -> K[0];
         x -> Pi[x -> n+1] = bestSibling -> Pi[0];
-        memcpy(bestSibling -> K, &bestSibling -> K[1], sizeof(int)*(bestSibling -> n-1));
-        memcpy(bestSibling -> Pi, &bestSibling -> Pi[1], sizeof(InternalNode *)*bestSibling -> n);
+        memmove(bestSibling -> K, &bestSibling -> K[1], sizeof(int)*(bestSibling -> n-1));
+        memmove(bestSibling -> Pi, &bestSibling -> Pi[1], sizeof(InternalNode *)*bestSibling -> n);
       }
       bestSibling -> Pi[bestSibling -> n] = NULL;
       bestSibling -> n--;
@@ -392,16 +324,16 @@ void deleteBPT(Tree *T, const unsigned int m, const int oldKey) {
       bestSibling -> K[bestSibling -> n] = y -> K[i-1];
       memcpy(&bestSibling -> K[bestSibling -> n+1], x -> K, sizeof(int)*x -> n);
       memcpy(&bestSibling -> Pi[bestSibling -> n+1], x -> Pi, sizeof(InternalNode *)*(x -> n+1));
-      memcpy(&y -> K[i-1], &y -> K[i], sizeof(int)*(y -> n-i));
-      memcpy(&y -> Pi[i], &y -> Pi[i+1], sizeof(InternalNode *)*(y -> n-i));
+      memmove(&y -> K[i-1], &y -> K[i], sizeof(int)*(y -> n-i));
+      memmove(&y -> Pi[i], &y -> Pi[i+1], sizeof(InternalNode *)*(y -> n-i));
       bestSibling -> n += x -> n+1;
       free(x);
     } else {
       x -> K[x -> n] = y -> K[i];
       memcpy(&x -> K[x -> n+1], bestSibling -> K, sizeof(int)*bestSibling -> n);
       memcpy(&x -> Pi[x -> n+1], bestSibling -> Pi, sizeof(InternalNode *)*(bestSibling -> n+1));
-      memcpy(&y -> K[i], &y -> K[i+1], sizeof(int)*(y -> n-i-1));
-      memcpy(&y -> Pi[i+1], &y -> Pi[i+2], sizeof(InternalNode *)*(y -> n-i-1));
+      memmove(&y -> K[i], &y -> K[i+1], sizeof(int)*(y -> n-i-1));
+      memmove(&y -> Pi[i+1], &y -> Pi[i+2], sizeof(InternalNode *)*(y -> n-i-1));
       x -> n += bestSibling -> n+1;
       free(bestSibling);
     }
@@ -411,9 +343,176 @@ void deleteBPT(Tree *T, const unsigned int m, const int oldKey) {
   }
 
   if (x -> n == 0) { (*T) -> IndexSet = x -> Pi[0]; free(x); }                        /* the level of tree decreases */
+}
+
+/**
+ * groups returns the number of nodes that n entries are evenly packed into.
+ * @param n: number of entries
+ * @param c: target number of entries per node
+ * @param min: minimum number of entries per node
+ * @param max: maximum number of entries per node
+ */
+static inline size_t groups(const size_t n, const unsigned int c, const unsigned int min, const unsigned int max) {
+  const size_t g = (n+c-1)/c;
+  return 1 < g && n/g < min ? (n+max-1)/max : g;  /* pack as tightly as possible if c would underflow the nodes */
+}
+
+/**
+ * bulkLoadBPT builds T bottom-up from n keys sorted in strictly increasing order.
+ * Each node is packed to about fill of its capacity, but never below the minimum occupancy.
+ * @param T: an empty B+-tree
+ * @param m: fanout of B+-tree
+ * @param keys: sorted keys to load
+ * @param n: number of keys
+ * @param fill: fill factor of nodes, in (0, 1]
+ */
+void bulkLoadBPT(Tree *T, const unsigned int m, const int *keys, const size_t n, const double fill) {
+  if (n == 0) return;
+
+  const unsigned int  c     = fill*m+.5,
+                      min   = m+1>>1,
+                      cmin  = (m-1>>1)+1;
+  register size_t     g     = groups(n, c < min ? min : m < c ? m : c, min, m),
+                      j,
+                      k     = 0;
+  register unsigned int i,
+                        q;
+  void **P                  = malloc(sizeof(void *)*g);
+  int *max                  = malloc(sizeof(int)*g);
+  TerminalNode *z           = NULL,
+               *w;
+  bool terminal             = true;
+
+  *T = malloc(sizeof(struct Tree));
+
+  for (j=0; j<g; ++j) {                                           /* pack the sequence set */
+    w       = getTerminalNode(m);
+    w -> q  = n/g+(j < n%g);
+    memcpy(w -> K, &keys[k], sizeof(int)*w -> q);
+    k      += w -> q;
+    max[j]  = keys[k-1];
+    if (z != NULL)  z -> P              = w;
+    else            (*T) -> SequenceSet = w;
+    P[j]    = z = w;
+  }
+
+  for (; 1 < g; terminal = false) {                               /* build the index set level by level */
+    register InternalNode *x;
+    const size_t        children  = g;
+
+    g = groups(children, c < cmin ? cmin : m < c ? m : c, cmin, m);
+    for (j=0, k=0; j<g; ++j) {
+      x = getInternalNode(m, terminal);
+      q = children/g+(j < children%g);
+      for (i=0; i<q; ++i, ++k) {
+        if (terminal) x -> Pt[i] = P[k];
+        else          x -> Pi[i] = P[k];
+        if (i < q-1)  x -> K[i] = max[k];
+      }
+      x -> n  = q-1;
+      P[j]    = x;
+      max[j]  = max[k-1];
+    }
+  }
+
+  (*T) -> IndexSet = terminal ? NULL : P[0];
+
+  free(P);
+  free(max);
+}
+
+/**
+ * searchBPT returns the slot holding key in T, or NULL if T does not contain key.
+ * @param T: a B+-tree
+ * @param m: fanout of B+-tree
+ * @param key: a key to search
+ */
+const int *searchBPT(const Tree T, const unsigned int m, const int key) {
+  if (T == NULL) return NULL;
+
+  register const InternalNode *x  = T -> IndexSet;
+  register const TerminalNode *z  = T -> SequenceSet;
+  register unsigned int i;
+
+  while (x != NULL) {                             /* fetch the keys of the next node before descending */
+    i = lower_bound(x -> K, x -> n, key);
+    if (x -> Pi != NULL)  { prefetch_range(x -> Pi[i], sizeof(InternalNode)+sizeof(int)*(m-1)); x = x -> Pi[i]; }
+    else                  { prefetch_range(x -> Pt[i], sizeof(TerminalNode)+sizeof(int)*m); z = x -> Pt[i]; x = NULL; }
+  }
+
+  if (z == NULL) return NULL;
+
+  i = lower_bound(z -> K, z -> q, key);
+  return i < z -> q && key == z -> K[i] ? &z -> K[i] : NULL;
+}
+
+/**
+ * seekBPT positions cursor at the first key in T not less than lo.
+ * @param cursor: a cursor to position
+ * @param T: a B+-tree
+ * @param m: fanout of B+-tree
+ * @param lo: the lower bound of the range, inclusive
+ * @param hi: the upper bound of the range, inclusive
+ */
+void seekBPT(Cursor *cursor, const Tree T, const unsigned int m, const int lo, const int hi) {
+  cursor -> node  = NULL;
+  cursor -> i     = 0;
+  cursor -> hi    = hi;
+  cursor -> m     = m;
+
+  if (T == NULL || hi < lo) return;
+
+  register const InternalNode *x  = T -> IndexSet;
+  register const TerminalNode *z  = T -> SequenceSet;
+  register unsigned int i;
+
+  while (x != NULL) {
+    i = lower_bound(x -> K, x -> n, lo);
+    if (x -> Pi != NULL)  { prefetch_range(x -> Pi[i], sizeof(InternalNode)+sizeof(int)*(m-1)); x = x -> Pi[i]; }
+    else                  { prefetch_range(x -> Pt[i], sizeof(TerminalNode)+sizeof(int)*m); z = x -> Pt[i]; x = NULL; }
+  }
+
+  if (z == NULL) return;
+
+  if ((i = lower_bound(z -> K, z -> q, lo)) == z -> q) { z = z -> P; i = 0; } /* every key of z is less than lo */
+  if (z != NULL) prefetch_range(z -> P, sizeof(TerminalNode)+sizeof(int)*m);
+
+  cursor -> node  = z;
+  cursor -> i     = i;
+}
+
+/**
+ * nextBPT copies up to size keys from cursor into keys and advances cursor past them.
+ * It returns the number of keys copied, which is 0 once the range is exhausted.
+ * @param cursor: a cursor positioned by seekBPT
+ * @param keys: a buffer of at least size keys
+ * @param size: size of buffer
+ */
+unsigned int nextBPT(Cursor *cursor, int *keys, const unsigned int size) {
+  register const TerminalNode *z;
+  register unsigned int count = 0,
+                        end,
+                        n;
+
+  while (count < size && (z = cursor -> node) != NULL) {
+    end = z -> K[z -> q-1] <= cursor -> hi ? z -> q : lower_bound(z -> K, z -> q, cursor -> hi); /* find the end of the range within z */
+    if (end < z -> q && z -> K[end] == cursor -> hi) end++;
+    if (end <= cursor -> i) { cursor -> node = NULL; break; }
+
+    n = end-cursor -> i < size-count ? end-cursor -> i : size-count;
+    memcpy(&keys[count], &z -> K[cursor -> i], sizeof(int)*n);
+    count       += n;
+    cursor -> i += n;
+
+    if (cursor -> i < end)  break;                                                                /* the batch is full */
+    if (end < z -> q)       { cursor -> node = NULL; break; }                                     /* the range ends within z */
+
+    cursor -> node  = z -> P;                                                                     /* move on to the next terminal node */
+    cursor -> i     = 0;
+    if (z -> P != NULL) prefetch_range(z -> P -> P, sizeof(TerminalNode)+sizeof(int)*cursor -> m);
+  }
 
-  clear(&stack);
-  clear(&iStack);
+  return count;
 }
 
 /**
@@ -16,6 +16,7 @@
 
 /**
  * TerminalNode represents a terminal node in B+-tree.
+ * K points into the same cache-line-aligned allocation as the node itself.
  */
 typedef struct TerminalNode {
   int                 *K;
@@ -25,6 +26,7 @@ typedef struct TerminalNode {
 
 /**
  * InternalNode represents an internal node in B+-tree.
+ * K and either Pi or Pt point into the same cache-line-aligned allocation as the node itself.
  */
 typedef struct InternalNode {
   int                 *K;
@@ -38,6 +40,16 @@ typedef struct Tree {
   TerminalNode *SequenceSet;
 } *Tree;
 
+/**
+ * Cursor represents a position in the sequence set of B+-tree during a range scan.
+ */
+typedef struct Cursor {
+  const TerminalNode  *node;
+  unsigned int        i;
+  int                 hi;
+  unsigned int        m;
+} Cursor;
+
 /**
  * insertBPT inserts newKey into T.
  * @param T: a B+-tree
@@ -54,6 +66,44 @@ void insertBPT(Tree *T, const unsigned int m, const int newKey);
  */
 void deleteBPT(Tree *T, const unsigned int m, const int oldKey);
 
+/**
+ * bulkLoadBPT builds T bottom-up from n keys sorted in strictly increasing order.
+ * Each node is packed to about fill of its capacity, but never below the minimum occupancy.
+ * @param T: an empty B+-tree
+ * @param m: fanout of B+-tree
+ * @param keys: sorted keys to load
+ * @param n: number of keys
+ * @param fill: fill factor of nodes, in (0, 1]
+ */
+void bulkLoadBPT(Tree *T, const unsigned int m, const int *keys, const size_t n, const double fill);
+
+/**
+ * searchBPT returns the slot holding key in T, or NULL if T does not contain key.
+ * @param T: a B+-tree
+ * @param m: fanout of B+-tree
+ * @param key: a key to search
+ */
+const int *searchBPT(const Tree T, const unsigned int m, const int key);
+
+/**
+ * seekBPT positions cursor at the first key in T not less than lo.
+ * @param cursor: a cursor to position
+ * @param T: a B+-tree
+ * @param m: fanout of B+-tree
+ * @param lo: the lower bound of the range, inclusive
+ * @param hi: the upper bound of the range, inclusive
+ */
+void seekBPT(Cursor *cursor, const Tree T, const unsigned int m, const int lo, const int hi);
+
+/**
+ * nextBPT copies up to size keys from cursor into keys and advances cursor past them.
+ * It returns the number of keys copied, which is 0 once the range is exhausted.
+ * @param cursor: a cursor positioned by seekBPT
+ * @param keys: a buffer of at least size keys
+ * @param size: size of buffer
+ */
+unsigned int nextBPT(Cursor *cursor, int *keys, const unsigned int size);
+
 /**
  * traverseBPT implements sequential access in T.
  * @param T: a B+-tree
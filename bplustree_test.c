@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2020, 9rum. All rights reserved.
+ * Use of this source code is governed by a BSD-style
+ * license that can be found in the LICENSE file.
+ *
+ * File Processing, 2020
+ *
+ * bplustree_test.c - B+-tree unit test
+ */
+#include <stdio.h>
+
+#include "bplustree.h"
+
+#define NR_KEYS 10000
+
+/**
+ * check searches every key from -1 to 2*NR_KEYS in T and returns the number of searches
+ * that disagree with T holding exactly the multiples of step below 2*NR_KEYS.
+ * @param T: a B+-tree
+ * @param m: fanout of B+-tree
+ * @param step: the step between the keys of T
+ */
+static unsigned int check(const Tree T, const unsigned int m, const int step) {
+  const int     *slot;
+  unsigned int  bad = 0;
+
+  for (int key=-1; key<=2*NR_KEYS; ++key) {
+    slot = searchBPT(T, m, key);
+    bad += 0 <= key && key < 2*NR_KEYS && key%step == 0 ? slot == NULL || *slot != key : slot != NULL;
+  }
+
+  return bad;
+}
+
+/**
+ * scan prints the keys of T between lo and hi in batches of size keys, each followed by a bar.
+ * @param T: a B+-tree
+ * @param m: fanout of B+-tree
+ * @param lo: the lower bound of the range, inclusive
+ * @param hi: the upper bound of the range, inclusive
+ * @param size: the number of keys per batch
+ */
+static void scan(const Tree T, const unsigned int m, const int lo, const int hi, const unsigned int size) {
+  Cursor        cursor;
+  int           keys[NR_KEYS];
+  unsigned int  n;
+
+  seekBPT(&cursor, T, m, lo, hi);
+  while ((n = nextBPT(&cursor, keys, size)) > 0) {
+    for (unsigned int i=0; i<n; ++i) printf("%d ", keys[i]);
+    printf("| ");
+  }
+  printf("\n");
+}
+
+/**
+ * occupancy prints the number of keys of each terminal node of T and the height of its index set.
+ * @param T: a B+-tree
+ */
+static void occupancy(const Tree T) {
+  unsigned int h = 0;
+
+  if (T != NULL) {
+    for (const TerminalNode *z = T -> SequenceSet; z != NULL; z = z -> P) printf("%u ", z -> q);
+    for (const InternalNode *x = T -> IndexSet; x != NULL; x = x -> Pi == NULL ? NULL : x -> Pi[0]) h++;
+  }
+  printf("/ %u\n", h);
+}
+
+int main(void) {
+  const int           testcases[] = {40, 11, 77, 33, 20, 90, 99, 70, 88, 80, 66, 10, 22, 30, 44, 55, 50, 60, 25, 49};
+  const int           absent[]    = {5, 45, 100};
+  const unsigned int  fanouts[]   = {4, 64};
+  const size_t        sizes[]     = {0, 1, 4, 5};
+  int                 keys[NR_KEYS];
+  Tree                T           = NULL;
+
+  for (const int *it = testcases; it < testcases + sizeof(testcases)/sizeof(int); ++it) insertBPT(&T, 4, *it);
+  traverseBPT(T);
+  printf("\n");
+  for (const int *it = testcases; it < testcases + sizeof(testcases)/sizeof(int); ++it) printf("%d", searchBPT(T, 4, *it) != NULL);
+  printf("\n");
+  for (const int *it = absent; it < absent + sizeof(absent)/sizeof(int); ++it) printf("%d", searchBPT(T, 4, *it) != NULL);
+  printf("\n");
+  printf("%d %d\n", *searchBPT(T, 4, 10), *searchBPT(T, 4, 99));                 /* the least and the greatest key */
+  occupancy(T);
+  scan(T, 4, 0, 100, NR_KEYS);                                              /* spans every terminal node */
+  scan(T, 4, 0, 100, 3);                                                    /* in batches smaller than a node */
+  scan(T, 4, 20, 44, 1);                                                    /* ends exactly on a key */
+  scan(T, 4, 45, 65, 2);
+  scan(T, 4, 66, 66, 2);
+  scan(T, 4, 100, 200, 2);                                                  /* past the last key */
+  scan(T, 4, -5, 5, 2);
+  scan(T, 4, 50, 40, 2);                                                    /* hi is less than lo */
+  for (const int *it = testcases; it < testcases + sizeof(testcases)/sizeof(int); it += 2) deleteBPT(&T, 4, *it);
+  traverseBPT(T);
+  printf("\n");
+  for (const int *it = testcases; it < testcases + sizeof(testcases)/sizeof(int); ++it) printf("%d", searchBPT(T, 4, *it) != NULL);
+  printf("\n");
+  for (const int *it = testcases+1; it < testcases + sizeof(testcases)/sizeof(int); it += 2) deleteBPT(&T, 4, *it);
+  printf("%s %d\n", T == NULL ? "NULL" : "not empty", searchBPT(T, 4, testcases[0]) != NULL);
+  scan(T, 4, 0, 100, 2);
+
+  for (const size_t *n = sizes; n < sizes + sizeof(sizes)/sizeof(size_t); ++n) { /* none, one, exactly m and m+1 keys */
+    for (size_t i=0; i<*n; ++i) keys[i] = 10*(i+1);
+    bulkLoadBPT(&T, 4, keys, *n, 1.);
+    occupancy(T);
+    traverseBPT(T);
+    printf("\n");
+    for (int key=5; key<=10*(int)*n+5; key += 5) printf("%d", searchBPT(T, 4, key) != NULL);
+    printf("\n");
+    for (int key=5; key<=10*(int)*n+5; key += 10) insertBPT(&T, 4, key);
+    occupancy(T);
+    traverseBPT(T);
+    printf("\n");
+    for (size_t i=0; i<*n; ++i) deleteBPT(&T, 4, keys[i]);
+    occupancy(T);
+    traverseBPT(T);
+    printf("\n");
+    for (int key=5; key<=10*(int)*n+5; key += 10) deleteBPT(&T, 4, key);
+    printf("%s\n", T == NULL ? "NULL" : "not empty");
+  }
+
+  for (const unsigned int *m = fanouts; m < fanouts + sizeof(fanouts)/sizeof(unsigned int); ++m) {
+    for (int i=0; i<NR_KEYS; ++i) insertBPT(&T, *m, i*7919%NR_KEYS*2);         /* inserts the even keys out of order */
+    printf("%u %u", *m, check(T, *m, 2));
+    for (int key=2; key<2*NR_KEYS; key += 4) deleteBPT(&T, *m, key);
+    printf(" %u\n", check(T, *m, 4));
+    for (int key=0; key<2*NR_KEYS; key += 4) deleteBPT(&T, *m, key);
+  }
+  /*
+   * gcc -Iinclude bplustree_test.c bplustree.c
+   *
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70 77 80 88 90 99
+   * 11111111111111111111
+   * 000
+   * 10 99
+   * 3 2 3 4 4 4 / 2
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70 77 80 88 90 99 |
+   * 10 11 20 | 22 25 30 | 33 40 44 | 49 50 55 | 60 66 70 | 77 80 88 | 90 99 |
+   * 20 | 22 | 25 | 30 | 33 | 40 | 44 |
+   * 49 50 | 55 60 |
+   * 66 |
+   *
+   *
+   *
+   * 10 11 30 33 49 55 60 70 80 90
+   * 01010101010101010101
+   * NULL 0
+   *
+   * / 0
+   *
+   * 0
+   * 1 / 0
+   * 5
+   * 1 / 0
+   * 5
+   * NULL
+   * 1 / 0
+   * 10
+   * 010
+   * 3 / 0
+   * 5 10 15
+   * 2 / 0
+   * 5 15
+   * NULL
+   * 4 / 0
+   * 10 20 30 40
+   * 010101010
+   * 2 2 2 3 / 1
+   * 5 10 15 20 25 30 35 40 45
+   * 2 3 / 1
+   * 5 15 25 35 45
+   * NULL
+   * 3 2 / 1
+   * 10 20 30 40 50
+   * 01010101010
+   * 2 4 2 3 / 1
+   * 5 10 15 20 25 30 35 40 45 50 55
+   * 2 2 2 / 1
+   * 5 15 25 35 45 55
+   * NULL
+   * 4 0 0
+   * 64 0 0
+   *
+   */
+}
@@ -8,42 +8,28 @@
  * B-tree implementation
  */
 
+#include <stdint.h>
+
+#include "search.h"
 #include "stack.h"
 #include "btree.h"
 
 /**
  * getNode returns a new node.
+ * The header, K and P share a single allocation aligned to a cache line,
+ * and K and P have a spare entry so that an overflowing node is split in place.
  * @param m: fanout of B-tree
  */
 static inline Node *getNode(const unsigned int m) {
-  Node *node  = malloc(sizeof(Node));
+  const size_t  offset  = sizeof(Node)+(sizeof(int)*m+sizeof(Node *)-1 & ~(sizeof(Node *)-1)),
+                size    = offset+sizeof(Node *)*(m+1)+CACHE_LINE_SIZE-1 & ~(size_t)(CACHE_LINE_SIZE-1);
+  Node *node  = aligned_alloc(CACHE_LINE_SIZE, size);
   node -> n   = 0;
-  node -> K   = malloc(sizeof(int)*(m-1));
-  node -> P   = calloc(m, sizeof(Node *));
+  node -> K   = (int *)(node+1);
+  node -> P   = memset((char *)node+offset, 0, sizeof(Node *)*(m+1));
   return node;
 }
 
-/**
- * binarySearch returns index i where K[i-1] < key <= K[i].
- * @param K: an array
- * @param n: size of array
- * @param key: a key to search
- */
-static inline unsigned int binarySearch(const int *K, const unsigned int n, const int key) {
-  register int  i = 0,
-                j = n-1;
-  register unsigned int mid;
-
-  while (i <= j) {
-    mid = i+j>>1;
-    if (key == K[mid])  return mid;
-    if (key < K[mid])   j = mid-1;
-    else                i = mid+1;
-  }
-
-  return i;
-}
-
 /**
  * insertBT inserts newKey into T.
  * @param T: a B-tree
@@ -51,53 +37,40 @@ static inline unsigned int binarySearch(const int *K, const unsigned int n, cons
  * @param newKey: a key to insert
  */
 void insertBT(Tree *T, const unsigned int m, const int newKey) {
-  register Node *tempNode,
-                *x  = *T,
+  register Node *x  = *T,
                 *y  = NULL;
-  stack stack       = NULL,
-        iStack      = NULL;
+  struct path_stack stack,
+                    iStack;
   register int key  = newKey;
   register unsigned int i;
 
+  path_init(&stack);
+  path_init(&iStack);
+
   while (x != NULL) {         /* find position to insert newKey while storing x on the stack */
-    if  ((i = binarySearch(x -> K, x -> n, newKey)) < x -> n && newKey == x -> K[i]) { clear(&stack); clear(&iStack); return; }
-    push(&stack, x);
-    push(&iStack, i);
+    if  ((i = lower_bound(x -> K, x -> n, newKey)) < x -> n && newKey == x -> K[i]) return;
+    path_push(&stack, x);
+    path_push(&iStack, (void *)(uintptr_t)i);
     x = x -> P[i];
   }
 
-  while (!empty(stack)) {
-    x = pop(&stack);
-    i = pop(&iStack);
+  while (!path_empty(&stack)) {
+    x = path_pop(&stack);
+    i = (uintptr_t)path_pop(&iStack);
 
-    if (x -> n < m-1) {
-      memcpy(&x -> K[i+1], &x -> K[i], sizeof(int)*(x -> n-i));
-      x -> K[i] = key;
-      if (y != NULL) { memcpy(&x -> P[i+2], &x -> P[i+1], sizeof(Node *)*(x -> n-i)); x -> P[i+1] = y; }
-      x -> n++;
-      clear(&stack);
-      clear(&iStack);
-      return;
-    }
+    memmove(&x -> K[i+1], &x -> K[i], sizeof(int)*(x -> n-i));
+    memmove(&x -> P[i+2], &x -> P[i+1], sizeof(Node *)*(x -> n-i));
+    x -> K[i]   = key;
+    x -> P[i+1] = y;
+
+    if (++x -> n < m) return;
 
-    tempNode = getNode(m+1);
-    memcpy(tempNode -> K, x -> K, sizeof(int)*i);
-    memcpy(&tempNode -> K[i+1], &x -> K[i], sizeof(int)*(x -> n-i));
-    memcpy(tempNode -> P, x -> P, sizeof(Node *)*(i+1));
-    memcpy(&tempNode -> P[i+2], &x -> P[i+1], sizeof(Node *)*(x -> n-i));
-    tempNode -> K[i]    = key;
-    tempNode -> P[i+1]  = y;
-
-    y = getNode(m);
-    memcpy(x -> K, tempNode -> K, sizeof(int)*(m>>1));
-    memcpy(x -> P, tempNode -> P, sizeof(Node *)*((m>>1)+1));
-    memcpy(y -> K, &tempNode -> K[(m>>1)+1], sizeof(int)*(m-(m>>1)-1));
-    memcpy(y -> P, &tempNode -> P[(m>>1)+1], sizeof(Node *)*(m-(m>>1)));
+    y = getNode(m);           /* split x, which overflows into its spare entry */
+    memcpy(y -> K, &x -> K[(m>>1)+1], sizeof(int)*(m-(m>>1)-1));
+    memcpy(y -> P, &x -> P[(m>>1)+1], sizeof(Node *)*(m-(m>>1)));
     x -> n  = m>>1;
     y -> n  = m-(m>>1)-1;
-    key     = tempNode -> K[m>>1];
-
-    free(tempNode);
+    key     = x -> K[m>>1];
   }
 
   *T            = getNode(m); /* the level of the tree increases */
@@ -105,9 +78,6 @@ void insertBT(Tree *T, const unsigned int m, const int newKey) {
   (*T) -> P[0]  = x;
   (*T) -> P[1]  = y;
   (*T) -> n     = 1;
-
-  clear(&stack);
-  clear(&iStack);
 }
 
 /**
@@ -120,51 +90,54 @@ void deleteBT(Tree *T, const unsigned int m, const int oldKey) {
   register Node *bestSibling,
                 *y,
                 *x  = *T;
-  stack stack       = NULL,
-        iStack      = NULL;
+  struct path_stack stack,
+                    iStack;
   register unsigned int i,
                         b;
 
+  path_init(&stack);
+  path_init(&iStack);
+
   while (x != NULL) {                                         /* find position of oldKey while storing x on the stack */
-    i = binarySearch(x -> K, x -> n, oldKey);
-    push(&stack, x);
-    push(&iStack, i);
+    i = lower_bound(x -> K, x -> n, oldKey);
+    path_push(&stack, x);
+    path_push(&iStack, (void *)(uintptr_t)i);
     if (i < x -> n && oldKey == x -> K[i]) break;
     x = x -> P[i];
   }
 
-  if (x == NULL) { clear(&stack); clear(&iStack); return; }
+  if (x == NULL) return;
 
-  Node *internalNode  = pop(&stack);
-  i                   = pop(&iStack);
+  Node *internalNode  = path_pop(&stack);
+  i                   = (uintptr_t)path_pop(&iStack);
 
   if (x -> P[i+1] != NULL) {                                  /* found in internal node */
-    push(&stack, x);
-    push(&iStack, i+1);
+    path_push(&stack, x);
+    path_push(&iStack, (void *)(uintptr_t)(i+1));
     x = x -> P[i+1];
 
     while (x != NULL) {
-      push(&stack, x);
-      push(&iStack, 0);
+      path_push(&stack, x);
+      path_push(&iStack, (void *)(uintptr_t)0);
       x = x -> P[0];
     }
   }
 
   if (x == NULL) {                                            /* exchange oldKey and the subsequent key */
-    x                     = pop(&stack);
+    x                     = path_pop(&stack);
     internalNode -> K[i]  = x -> K[0];
     x -> K[0]             = oldKey;
-    i                     = pop(&iStack);
+    i                     = (uintptr_t)path_pop(&iStack);
   }
 
   x -> n--;
-  memcpy(&x -> K[i], &x -> K[i+1], sizeof(int)*(x -> n-i));
+  memmove(&x -> K[i], &x -> K[i+1], sizeof(int)*(x -> n-i));
 
-  while (!empty(stack)) {
-    if  (m-1>>1 <= x -> n) { clear(&stack); clear(&iStack); return; }
+  while (!path_empty(&stack)) {
+    if  (m-1>>1 <= x -> n) return;
 
-    y           = pop(&stack);
-    i           = pop(&iStack);
+    y           = path_pop(&stack);
+    i           = (uintptr_t)path_pop(&iStack);
     b           = i == 0                              ? i+1
                 : i == y -> n                         ? i-1
                 : y -> P[i-1] -> n < y -> P[i+1] -> n ? i+1
@@ -173,8 +146,8 @@ void deleteBT(Tree *T, const unsigned int m, const int oldKey) {
 
     if    (m-1>>1 < bestSibling -> n) {                       /* case of key redistribution */
       if  (b < i) {
-        memcpy(&x -> K[1], x -> K, sizeof(int)*x -> n);
-        memcpy(&x -> P[1], x -> P, sizeof(Node *)*(x -> n+1));
+        memmove(&x -> K[1], x -> K, sizeof(int)*x -> n);
+        memmove(&x -> P[1], x -> P, sizeof(Node *)*(x -> n+1));
         x -> K[0]   = y -> K[i-1];
         y -> K[i-1] = bestSibling -> K[bestSibling -> n-1];
         x -> P[0]   = bestSibling -> P[bestSibling -> n];
@@ -182,8 +155,8 @@ void deleteBT(Tree *T, const unsigned int m, const int oldKey) {
         x -> K[x -> n]    = y -> K[i];
         y -> K[i]         = bestSibling -> K[0];
         x -> P[x -> n+1]  = bestSibling -> P[0];
-        memcpy(bestSibling -> K, &bestSibling -> K[1], sizeof(int)*(bestSibling -> n-1));
-        memcpy(bestSibling -> P, &bestSibling -> P[1], sizeof(Node *)*bestSibling -> n);
+        memmove(bestSibling -> K, &bestSibling -> K[1], sizeof(int)*(bestSibling -> n-1));
+        memmove(bestSibling -> P, &bestSibling -> P[1], sizeof(Node *)*bestSibling -> n);
       }
       bestSibling -> P[bestSibling -> n] = NULL;
       bestSibling -> n--;
@@ -194,16 +167,16 @@ void deleteBT(Tree *T, const unsigned int m, const int oldKey) {
       bestSibling -> K[bestSibling -> n] = y -> K[i-1];
       memcpy(&bestSibling -> K[bestSibling -> n+1], x -> K, sizeof(int)*x -> n);
       memcpy(&bestSibling -> P[bestSibling -> n+1], x -> P, sizeof(Node *)*(x -> n+1));
-      memcpy(&y -> K[i-1], &y -> K[i], sizeof(int)*(y -> n-i));
-      memcpy(&y -> P[i], &y -> P[i+1], sizeof(Node *)*(y -> n-i));
+      memmove(&y -> K[i-1], &y -> K[i], sizeof(int)*(y -> n-i));
+      memmove(&y -> P[i], &y -> P[i+1], sizeof(Node *)*(y -> n-i));
       bestSibling -> n += x -> n+1;
       free(x);
     } else {
       x -> K[x -> n] = y -> K[i];
       memcpy(&x -> K[x -> n+1], bestSibling -> K, sizeof(int)*bestSibling -> n);
       memcpy(&x -> P[x -> n+1], bestSibling -> P, sizeof(Node *)*(bestSibling -> n+1));
-      memcpy(&y -> K[i], &y -> K[i+1], sizeof(int)*(y -> n-i-1));
-      memcpy(&y -> P[i+1], &y -> P[i+2], sizeof(Node *)*(y -> n-i-1));
+      memmove(&y -> K[i], &y -> K[i+1], sizeof(int)*(y -> n-i-1));
+      memmove(&y -> P[i+1], &y -> P[i+2], sizeof(Node *)*(y -> n-i-1));
       x -> n += bestSibling -> n+1;
       free(bestSibling);
     }
@@ -213,9 +186,99 @@ void deleteBT(Tree *T, const unsigned int m, const int oldKey) {
   }
 
   if (x -> n == 0) { *T = x -> P[0]; free(x); }               /* the level of the tree decreases */
+}
+
+/**
+ * power returns b to the power of h, saturating at SIZE_MAX.
+ * A subtree of height h with fanout b holds power(b, h)-1 keys.
+ * @param b: fanout of subtree
+ * @param h: height of subtree
+ */
+static inline size_t power(const size_t b, unsigned int h) {
+  register size_t p = 1;
+  while (0 < h--) p = p <= SIZE_MAX/b ? p*b : SIZE_MAX;
+  return p;
+}
+
+/**
+ * buildBT returns a subtree of height h holding n sorted keys.
+ * @param keys: sorted keys
+ * @param n: number of keys
+ * @param h: height of subtree
+ * @param m: fanout of B-tree
+ * @param t: target number of keys per node
+ * @param c: minimum number of children of the root of subtree
+ */
+static Node *buildBT(const int *keys, const size_t n, const unsigned int h, const unsigned int m, const unsigned int t, const unsigned int c) {
+  register Node *x = getNode(m);
+
+  if (h == 1) { memcpy(x -> K, keys, sizeof(int)*n); x -> n = n; return x; }
+
+  const size_t  lo  = power((m-1>>1)+1, h-1),                       /* bounds on the keys per child plus one */
+                hi  = power(m, h-1);
+  register size_t k = 0,
+                  q,
+                  d = n/power(t+1, h-1)+1;                            /* number of children of x */
+
+  if (d < n/hi+1)   d = n/hi+1;
+  if (d < c)        d = c;
+  if ((n+1)/lo < d) d = (n+1)/lo;
+  if (m < d)        d = m;
+
+  for (unsigned int i=0; i<d; ++i) {                                  /* spread the keys evenly over the children */
+    q         = (n+1)/d-1+(i < (n+1)%d);
+    x -> P[i] = buildBT(&keys[k], q, h-1, m, t, (m-1>>1)+1);
+    k        += q;
+    if (i < d-1) x -> K[i] = keys[k++];
+  }
+  x -> n = d-1;
+
+  return x;
+}
+
+/**
+ * bulkLoadBT builds T from n keys sorted in strictly increasing order in linear time.
+ * Each node holds about fill of its capacity, but never less than the minimum occupancy.
+ * @param T: an empty B-tree
+ * @param m: fanout of B-tree
+ * @param keys: sorted keys to load
+ * @param n: number of keys
+ * @param fill: fill factor of nodes, in (0, 1]
+ */
+void bulkLoadBT(Tree *T, const unsigned int m, const int *keys, const size_t n, const double fill) {
+  if (n == 0) return;
+
+  register unsigned int t = fill*(m-1)+.5,
+                        h = 1;
+
+  if (t < (m-1>>1))     t = m-1>>1;
+  if (t < 1)            t = 1;
+  if (m-1 < t)          t = m-1;
+
+  while (power(t+1, h) <= n) h++;                                     /* the lowest tree holding n keys at the target occupancy */
+  if (1 < h && n+1 < 2*power((m-1>>1)+1, h-1)) h--;                  /* the root could not have two children of minimum occupancy */
+
+  *T = buildBT(keys, n, h, m, t, 2);
+}
+
+/**
+ * searchBT returns the slot holding key in T, or NULL if T does not contain key.
+ * @param T: a B-tree
+ * @param m: fanout of B-tree
+ * @param key: a key to search
+ */
+const int *searchBT(const Tree T, const unsigned int m, const int key) {
+  register const Node *x = T;
+  register unsigned int i;
+
+  while (x != NULL) {
+    i = lower_bound(x -> K, x -> n, key);
+    if (i < x -> n && key == x -> K[i]) return &x -> K[i];
+    prefetch_range(x -> P[i], sizeof(Node)+sizeof(int)*(m-1)); /* fetch the keys of the next node only when the search goes on */
+    x = x -> P[i];
+  }
 
-  clear(&stack);
-  clear(&iStack);
+  return NULL;
 }
 
 /**
@@ -16,6 +16,7 @@
 
 /**
  * Node represents a node in B-tree.
+ * K and P point into the same cache-line-aligned allocation as the node itself.
  * @see https://infolab.usc.edu/csci585/Spring2010/den_ar/indexing.pdf
  */
 typedef struct Node {
@@ -42,6 +43,25 @@ void insertBT(Tree *T, const unsigned int m, const int newKey);
  */
 void deleteBT(Tree *T, const unsigned int m, const int oldKey);
 
+/**
+ * bulkLoadBT builds T from n keys sorted in strictly increasing order in linear time.
+ * Each node holds about fill of its capacity, but never less than the minimum occupancy.
+ * @param T: an empty B-tree
+ * @param m: fanout of B-tree
+ * @param keys: sorted keys to load
+ * @param n: number of keys
+ * @param fill: fill factor of nodes, in (0, 1]
+ */
+void bulkLoadBT(Tree *T, const unsigned int m, const int *keys, const size_t n, const double fill);
+
+/**
+ * searchBT returns the slot holding key in T, or NULL if T does not contain key.
+ * @param T: a B-tree
+ * @param m: fanout of B-tree
+ * @param key: a key to search
+ */
+const int *searchBT(const Tree T, const unsigned int m, const int key);
+
 /**
  * inorderBT implements inorder traversal in T.
  * @param T: a B-tree
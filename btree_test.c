@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2020, 9rum. All rights reserved.
+ * Use of this source code is governed by a BSD-style
+ * license that can be found in the LICENSE file.
+ *
+ * File Processing, 2020
+ *
+ * btree_test.c - B-tree unit test
+ */
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "btree.h"
+
+#define NR_KEYS 10000
+
+/**
+ * check searches every key from -1 to n in T and returns the number of searches
+ * that disagree with T holding exactly the multiples of step below n.
+ * @param T: a B-tree
+ * @param m: fanout of B-tree
+ * @param n: a bound above every key of T
+ * @param step: the step between the keys of T
+ */
+static unsigned int check(const Tree T, const unsigned int m, const int n, const int step) {
+  const int     *slot;
+  unsigned int  bad = 0;
+
+  for (int key=-1; key<=n; ++key) {
+    slot = searchBT(T, m, key);
+    bad += 0 <= key && key < n && key%step == 0 ? slot == NULL || *slot != key : slot != NULL;
+  }
+
+  return bad;
+}
+
+/**
+ * height returns the height of T, or -1 if a node of T is out of order, overflows or underflows,
+ * or if the leaves of T are not all at the same depth.
+ * @param T: a B-tree
+ * @param m: fanout of B-tree
+ * @param lo: a bound below every key of T
+ * @param hi: a bound above every key of T
+ * @param root: whether T is the root of the whole tree
+ */
+static int height(const Tree T, const unsigned int m, const int lo, const int hi, const bool root) {
+  int h;
+
+  if (T == NULL)                                  return 0;
+  if (m-1 < T -> n || (!root && T -> n < m-1>>1)) return -1;
+  for (unsigned int i=0; i<T -> n; ++i) if (T -> K[i] <= (i ? T -> K[i-1] : lo) || hi <= T -> K[i]) return -1;
+
+  h = height(T -> P[0], m, lo, T -> n ? T -> K[0] : hi, false);
+  for (unsigned int i=1; i<=T -> n; ++i) if (height(T -> P[i], m, T -> K[i-1], i < T -> n ? T -> K[i] : hi, false) != h) return -1;
+
+  return h < 0 ? -1 : h+1;
+}
+
+int main(void) {
+  const int           testcases[] = {40, 11, 77, 33, 20, 90, 99, 70, 88, 80, 66, 10, 22, 30, 44, 55, 50, 60, 25, 49};
+  const int           absent[]    = {5, 45, 100};
+  const unsigned int  fanouts[]   = {3, 64};
+  const size_t        sizes[][10] = {{0, 1, 2, 3, 7, 8, 9, 25, 26, 27}, {1, 4, 5, 24, 25, 26, 124, 125, 624, 625}};
+  int                 keys[NR_KEYS];
+  Tree                T           = NULL;
+
+  for (const int *it = testcases; it < testcases + sizeof(testcases)/sizeof(int); ++it) insertBT(&T, 3, *it);
+  inorderBT(T);
+  printf("\n");
+  for (const int *it = testcases; it < testcases + sizeof(testcases)/sizeof(int); ++it) printf("%d", searchBT(T, 3, *it) != NULL);
+  printf("\n");
+  for (const int *it = absent; it < absent + sizeof(absent)/sizeof(int); ++it) printf("%d", searchBT(T, 3, *it) != NULL);
+  printf("\n");
+  printf("%d %d\n", *searchBT(T, 3, 10), *searchBT(T, 3, 99));                 /* the least and the greatest key */
+  for (const int *it = testcases; it < testcases + sizeof(testcases)/sizeof(int); it += 2) deleteBT(&T, 3, *it);
+  inorderBT(T);
+  printf("\n");
+  for (const int *it = testcases; it < testcases + sizeof(testcases)/sizeof(int); ++it) printf("%d", searchBT(T, 3, *it) != NULL);
+  printf("\n");
+  for (const int *it = testcases+1; it < testcases + sizeof(testcases)/sizeof(int); it += 2) deleteBT(&T, 3, *it);
+  printf("%s %d\n", T == NULL ? "NULL" : "not empty", searchBT(T, 3, testcases[0]) != NULL);
+
+  for (unsigned int i=0; i<NR_KEYS; ++i) keys[i] = 2*i;
+  bulkLoadBT(&T, 3, keys, 9, 1.);
+  inorderBT(T);
+  printf("\n");
+  for (int i=0; i<9; ++i) printf("%d", searchBT(T, 3, keys[i]) != NULL && searchBT(T, 3, keys[i]+1) == NULL);
+  printf("\n");
+  for (int i=0; i<9; i += 2) deleteBT(&T, 3, keys[i]);
+  inorderBT(T);
+  printf("\n");
+  for (int i=1; i<9; i += 2) deleteBT(&T, 3, keys[i]);
+  for (unsigned int j=0; j<2; ++j) {                                            /* sizes around the capacities of full trees at m=3 and m=5 */
+    const unsigned int m = 3+2*j;
+
+    for (const size_t *n = sizes[j]; n < sizes[j] + sizeof(sizes[j])/sizeof(size_t); ++n) {
+      bulkLoadBT(&T, m, keys, *n, 1.);
+      printf("%zu %d %u", *n, height(T, m, -1, 2*(int)*n, true), check(T, m, 2*(int)*n, 2));
+      for (size_t i=1; i<*n; i += 2) deleteBT(&T, m, keys[i]);
+      printf(" %d %u", height(T, m, -1, 2*(int)*n, true), check(T, m, 2*(int)*n, 4));
+      for (size_t i=0; i<*n; i += 2) deleteBT(&T, m, keys[i]);
+      printf(" %s\n", T == NULL ? "NULL" : "not empty");
+    }
+  }
+
+  for (const unsigned int *m = fanouts; m < fanouts + sizeof(fanouts)/sizeof(unsigned int); ++m) {
+    for (int i=0; i<NR_KEYS; ++i) insertBT(&T, *m, i*7919%NR_KEYS*2);         /* inserts the even keys out of order */
+    printf("%u %u", *m, check(T, *m, 2*NR_KEYS, 2));
+    for (int key=2; key<2*NR_KEYS; key += 4) deleteBT(&T, *m, key);
+    printf(" %u\n", check(T, *m, 2*NR_KEYS, 4));
+    for (int key=0; key<2*NR_KEYS; key += 4) deleteBT(&T, *m, key);
+  }
+  /*
+   * gcc -Iinclude btree_test.c btree.c
+   *
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70 77 80 88 90 99
+   * 11111111111111111111
+   * 000
+   * 10 99
+   * 10 11 30 33 49 55 60 70 80 90
+   * 01010101010101010101
+   * NULL 0
+   * 0 2 4 6 8 10 12 14 16
+   * 111111111
+   * 2 6 10 14
+   * 0 0 0 0 0 NULL
+   * 1 1 0 1 0 NULL
+   * 2 1 0 1 0 NULL
+   * 3 2 0 1 0 NULL
+   * 7 2 0 2 0 NULL
+   * 8 2 0 2 0 NULL
+   * 9 3 0 2 0 NULL
+   * 25 3 0 3 0 NULL
+   * 26 3 0 3 0 NULL
+   * 27 4 0 3 0 NULL
+   * 1 1 0 1 0 NULL
+   * 4 1 0 1 0 NULL
+   * 5 2 0 1 0 NULL
+   * 24 2 0 2 0 NULL
+   * 25 3 0 2 0 NULL
+   * 26 3 0 2 0 NULL
+   * 124 3 0 3 0 NULL
+   * 125 4 0 4 0 NULL
+   * 624 4 0 4 0 NULL
+   * 625 5 0 5 0 NULL
+   * 3 0 0
+   * 64 0 0
+   *
+   */
+}
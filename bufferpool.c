@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2020, 9rum. All rights reserved.
+ * Use of this source code is governed by a BSD-style
+ * license that can be found in the LICENSE file.
+ *
+ * File Processing, 2020
+ * bufferpool.c
+ * Buffer pool implementation
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "search.h"
+#include "bufferpool.h"
+
+#define UNLOGGED UINT64_MAX
+
+/**
+ * hash returns the bucket of page id in pool.
+ * @param pool: a buffer pool
+ * @param id: a page
+ */
+static inline size_t hash(const BufferPool *pool, const PageId id) { return (id*0x9E3779B97F4A7C15ull>>32) & pool -> mask; }
+
+/**
+ * page returns the contents of frame f of pool.
+ * @param pool: a buffer pool
+ * @param f: index of a frame
+ */
+static inline void *page(const BufferPool *pool, const size_t f) { return pool -> pages+f*pool -> file -> pageSize; }
+
+/**
+ * lookup returns the frame holding page id in pool, or -1 if it is not cached.
+ * @param pool: a buffer pool
+ * @param id: a page
+ */
+static inline int32_t lookup(const BufferPool *pool, const PageId id) {
+  register int32_t f;
+  for (f = pool -> buckets[hash(pool, id)]; f != -1 && pool -> frames[f].id != id; f = pool -> frames[f].next);
+  return f;
+}
+
+/**
+ * detach removes frame f from the hash table of pool and marks it free.
+ * @param pool: a buffer pool
+ * @param f: index of a frame
+ */
+static void detach(BufferPool *pool, const int32_t f) {
+  register int32_t *link;
+  for (link = &pool -> buckets[hash(pool, pool -> frames[f].id)]; *link != f; link = &pool -> frames[*link].next);
+  *link                   = pool -> frames[f].next;
+  pool -> frames[f].id    = 0;
+  pool -> frames[f].dirty = false;
+}
+
+/**
+ * victim returns a free frame of pool, evicting an unpinned page with CLOCK if none is free.
+ * Pages with unlogged changes are not evicted. It aborts if no frame can be evicted.
+ * @param pool: a buffer pool
+ */
+static int32_t victim(BufferPool *pool) {
+  register Frame *x;
+
+  for (size_t i=0; i<pool -> size<<1; ++i) {
+    x           = &pool -> frames[pool -> hand];
+    pool -> hand = pool -> hand+1 == pool -> size ? 0 : pool -> hand+1;
+    if (x -> pin != 0 || x -> dirty && x -> lsn == UNLOGGED) continue;
+    if (x -> id != 0 && x -> ref) { x -> ref = false; continue; }      /* give a second chance */
+
+    const int32_t f = x-pool -> frames;
+    if (x -> id != 0) {
+      if (x -> dirty) {
+        if (pool -> log != NULL && pool -> log -> durable < x -> lsn) commitWAL(pool -> log);  /* write-ahead rule */
+        writePage(pool -> file, x -> id, page(pool, f));
+        pool -> writeBacks++;
+      }
+      detach(pool, f);
+      pool -> evictions++;
+    }
+    return f;
+  }
+
+  fprintf(stderr, "buffer pool: none of %zu frames can be evicted\n", pool -> size);
+  abort();
+}
+
+/**
+ * attach pins page id in frame f of pool.
+ * @param pool: a buffer pool
+ * @param f: index of a free frame
+ * @param id: a page
+ */
+static void attach(BufferPool *pool, const int32_t f, const PageId id) {
+  register Frame *x = &pool -> frames[f];
+  register size_t h = hash(pool, id);
+  x -> id           = id;
+  x -> lsn          = 0;
+  x -> pin          = 1;
+  x -> dirty        = false;
+  x -> ref          = true;
+  x -> next         = pool -> buckets[h];
+  pool -> buckets[h] = f;
+}
+
+/**
+ * touch marks frame f of pool dirty, remembering it for the next log record if pool has a log.
+ * @param pool: a buffer pool
+ * @param f: index of a frame
+ */
+static void touch(BufferPool *pool, const int32_t f) {
+  register Frame *x = &pool -> frames[f];
+  x -> dirty = true;
+  if (pool -> log == NULL || x -> lsn == UNLOGGED) return;
+  x -> lsn = UNLOGGED;
+  pool -> pending[pool -> pendingCount++] = f;
+}
+
+/**
+ * openBufferPool returns a buffer pool over file using at most budget bytes for pages.
+ * It returns NULL if budget holds fewer than BUFFER_POOL_MIN_FRAMES pages.
+ * @param file: a page file
+ * @param budget: memory budget in bytes
+ * @param log: a write-ahead log covering file, or NULL
+ */
+BufferPool *openBufferPool(PageFile *file, const size_t budget, WriteAheadLog *log) {
+  const size_t size = budget/file -> pageSize;
+  if (size < BUFFER_POOL_MIN_FRAMES || INT32_MAX < size) return NULL;
+
+  register size_t buckets = 1;
+  while (buckets < size) buckets <<= 1;
+
+  BufferPool *pool  = calloc(1, sizeof(BufferPool));
+  pool -> file      = file;
+  pool -> log       = log;
+  pool -> pending   = malloc(sizeof(int32_t)*size);
+  pool -> size      = size;
+  pool -> mask      = buckets-1;
+  pool -> frames    = calloc(size, sizeof(Frame));
+  pool -> buckets   = malloc(sizeof(int32_t)*buckets);
+  pool -> pages     = aligned_alloc(CACHE_LINE_SIZE, (size*file -> pageSize+CACHE_LINE_SIZE-1) & ~(size_t)(CACHE_LINE_SIZE-1));
+  memset(pool -> buckets, -1, sizeof(int32_t)*buckets);
+  return pool;
+}
+
+/**
+ * closeBufferPool writes back the dirty pages of pool and releases it.
+ * @param pool: a buffer pool
+ */
+void closeBufferPool(BufferPool *pool) {
+  flushBufferPool(pool);
+  free(pool -> pages);
+  free(pool -> pending);
+  free(pool -> buckets);
+  free(pool -> frames);
+  free(pool);
+}
+
+/**
+ * flushBufferPool writes back the logged dirty pages of pool, committing its log first.
+ * @param pool: a buffer pool
+ */
+void flushBufferPool(BufferPool *pool) {
+  if (pool -> log != NULL) commitWAL(pool -> log);
+
+  for (size_t f=0; f<pool -> size; ++f)
+    if (pool -> frames[f].dirty && pool -> frames[f].lsn != UNLOGGED) {
+      writePage(pool -> file, pool -> frames[f].id, page(pool, f));
+      pool -> frames[f].dirty = false;
+      pool -> writeBacks++;
+    }
+}
+
+/**
+ * pinPage pins page id in pool and returns its contents, reading it in on a miss.
+ * It aborts if no frame can be evicted.
+ * @param pool: a buffer pool
+ * @param id: a page to pin
+ */
+void *pinPage(BufferPool *pool, const PageId id) {
+  register int32_t f = lookup(pool, id);
+
+  if (f != -1) {
+    pool -> frames[f].pin++;
+    pool -> frames[f].ref = true;
+    pool -> hits++;
+    return page(pool, f);
+  }
+
+  pool -> misses++;
+  attach(pool, f = victim(pool), id);
+  readPage(pool -> file, id, page(pool, f));
+  return page(pool, f);
+}
+
+/**
+ * unpinPage unpins page in pool, marking it dirty if it was modified.
+ * @param pool: a buffer pool
+ * @param page: contents of a pinned page
+ * @param dirty: whether page was modified
+ */
+void unpinPage(BufferPool *pool, void *page, const bool dirty) {
+  register Frame *x = &pool -> frames[((char *)page-pool -> pages)/pool -> file -> pageSize];
+  x -> pin--;
+  if (dirty) touch(pool, x-pool -> frames);
+}
+
+/**
+ * allocPoolPage allocates a page of the file of pool and returns its pinned, zeroed contents.
+ * @param pool: a buffer pool
+ * @param id: where to store the ID of the page
+ */
+void *allocPoolPage(BufferPool *pool, PageId *id) {
+  register PageFile *file = pool -> file;
+  register char *x;
+
+  if (file -> freeList != 0) {                                        /* reuse a freed page */
+    x = pinPage(pool, *id = file -> freeList);
+    memcpy(&file -> freeList, x, sizeof(PageId));
+  } else {
+    register const int32_t f = victim(pool);
+    attach(pool, f, *id = file -> pageCount++);
+    x = page(pool, f);
+  }
+
+  touch(pool, (x-pool -> pages)/file -> pageSize);
+  return memset(x, 0, file -> pageSize);
+}
+
+/**
+ * freePoolPage unpins page in pool and returns it to the free list of the file.
+ * @param pool: a buffer pool
+ * @param page: contents of a pinned page
+ */
+void freePoolPage(BufferPool *pool, void *page) {
+  register Frame *x = &pool -> frames[((char *)page-pool -> pages)/pool -> file -> pageSize];
+  memcpy(page, &pool -> file -> freeList, sizeof(PageId));
+  pool -> file -> freeList = x -> id;
+  unpinPage(pool, page, true);
+}
+
+/**
+ * logBufferPool appends the images of the pages modified since the last call to the log of pool,
+ * followed by a commit record holding the header of the file.
+ * The operation becomes durable on the next commitWAL.
+ * @param pool: a buffer pool with a write-ahead log
+ */
+void logBufferPool(BufferPool *pool) {
+  register Frame *x;
+  LogCommit commit = {
+    .pageCount  = pool -> file -> pageCount,
+    .freeList   = pool -> file -> freeList,
+  };
+  memcpy(commit.meta, pool -> file -> meta, sizeof(commit.meta));
+
+  for (size_t i=0; i<pool -> pendingCount; ++i) {
+    x = &pool -> frames[pool -> pending[i]];
+    appendWAL(pool -> log, WAL_PAGE, &x -> id, sizeof(PageId), page(pool, pool -> pending[i]), pool -> file -> pageSize);
+  }
+
+  const uint64_t lsn = appendWAL(pool -> log, WAL_COMMIT, &commit, sizeof(LogCommit), NULL, 0);
+  for (size_t i=0; i<pool -> pendingCount; ++i) pool -> frames[pool -> pending[i]].lsn = lsn;
+  pool -> pendingCount = 0;
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2020, 9rum. All rights reserved.
+ * Use of this source code is governed by a BSD-style
+ * license that can be found in the LICENSE file.
+ *
+ * File Processing, 2020
+ * bufferpool.h
+ * Buffer pool implementation
+ */
+
+#ifndef _BUFFERPOOL_H
+#define _BUFFERPOOL_H
+
+#include <stddef.h>
+
+#include "pagefile.h"
+#include "wal.h"
+
+#define BUFFER_POOL_MIN_FRAMES 32
+
+/**
+ * Frame represents a slot of buffer pool holding page id.
+ * pin counts the clients using the page, and ref is the reference bit of CLOCK.
+ * lsn is the LSN of the last commit record logging the page, or UINT64_MAX while
+ * the page has changes that are not logged yet.
+ */
+typedef struct Frame {
+  PageId        id;
+  uint64_t      lsn;
+  uint32_t      pin;
+  bool          dirty;
+  bool          ref;
+  int32_t       next;
+} Frame;
+
+/**
+ * BufferPool caches the pages of a page file in a fixed number of frames.
+ * Unpinned pages are evicted with CLOCK, writing back dirty pages on eviction.
+ * Frames are found by page ID through a chained hash table of buckets.
+ * hits, misses, evictions and writeBacks count the traffic of the pool since it was opened.
+ *
+ * With a write-ahead log, pages modified since the last logBufferPool are pinned in memory
+ * and a dirty page is written back only after the log covering it is durable.
+ */
+typedef struct BufferPool {
+  PageFile      *file;
+  WriteAheadLog *log;
+  int32_t       *pending;
+  size_t        pendingCount;
+  Frame         *frames;
+  char          *pages;
+  int32_t       *buckets;
+  size_t        size;
+  size_t        mask;
+  size_t        hand;
+  uint64_t      hits;
+  uint64_t      misses;
+  uint64_t      evictions;
+  uint64_t      writeBacks;
+} BufferPool;
+
+/**
+ * openBufferPool returns a buffer pool over file using at most budget bytes for pages.
+ * It returns NULL if budget holds fewer than BUFFER_POOL_MIN_FRAMES pages.
+ * @param file: a page file
+ * @param budget: memory budget in bytes
+ * @param log: a write-ahead log covering file, or NULL
+ */
+BufferPool *openBufferPool(PageFile *file, const size_t budget, WriteAheadLog *log);
+
+/**
+ * closeBufferPool writes back the dirty pages of pool and releases it.
+ * @param pool: a buffer pool
+ */
+void closeBufferPool(BufferPool *pool);
+
+/**
+ * flushBufferPool writes back the logged dirty pages of pool, committing its log first.
+ * @param pool: a buffer pool
+ */
+void flushBufferPool(BufferPool *pool);
+
+/**
+ * pinPage pins page id in pool and returns its contents, reading it in on a miss.
+ * It aborts if no frame can be evicted.
+ * @param pool: a buffer pool
+ * @param id: a page to pin
+ */
+void *pinPage(BufferPool *pool, const PageId id);
+
+/**
+ * unpinPage unpins page in pool, marking it dirty if it was modified.
+ * @param pool: a buffer pool
+ * @param page: contents of a pinned page
+ * @param dirty: whether page was modified
+ */
+void unpinPage(BufferPool *pool, void *page, const bool dirty);
+
+/**
+ * allocPoolPage allocates a page of the file of pool and returns its pinned, zeroed contents.
+ * @param pool: a buffer pool
+ * @param id: where to store the ID of the page
+ */
+void *allocPoolPage(BufferPool *pool, PageId *id);
+
+/**
+ * freePoolPage unpins page in pool and returns it to the free list of the file.
+ * @param pool: a buffer pool
+ * @param page: contents of a pinned page
+ */
+void freePoolPage(BufferPool *pool, void *page);
+
+/**
+ * logBufferPool appends the images of the pages modified since the last call to the log of pool,
+ * followed by a commit record holding the header of the file.
+ * The operation becomes durable on the next commitWAL.
+ * @param pool: a buffer pool with a write-ahead log
+ */
+void logBufferPool(BufferPool *pool);
+
+#endif /* _BUFFERPOOL_H */
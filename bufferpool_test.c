@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2020, 9rum. All rights reserved.
+ * Use of this source code is governed by a BSD-style
+ * license that can be found in the LICENSE file.
+ *
+ * File Processing, 2020
+ *
+ * bufferpool_test.c - buffer pool unit test
+ */
+#include <stdio.h>
+#include <inttypes.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "bufferpool.h"
+
+#define PAGE_SIZE 128
+#define NR_PAGES  (2*BUFFER_POOL_MIN_FRAMES)
+
+int main(void) {
+  const char  *path = "bufferpool_test.db";
+  char        buf[PAGE_SIZE];
+  PageId      ids[NR_PAGES],
+              id;
+  PageFile    *file;
+  BufferPool  *pool;
+  char        *page;
+  unsigned int bad = 0;
+
+  unlink(path);
+
+  file = openPageFile(path, PAGE_SIZE);
+  printf("%s\n", openBufferPool(file, PAGE_SIZE*(BUFFER_POOL_MIN_FRAMES-1), NULL) == NULL ? "NULL" : "opened");
+
+  pool = openBufferPool(file, PAGE_SIZE*BUFFER_POOL_MIN_FRAMES, NULL);
+  for (unsigned int i=0; i<NR_PAGES; ++i) {                             /* twice as many pages as frames */
+    page = allocPoolPage(pool, &ids[i]);
+    memset(page, 'a'+i%26, PAGE_SIZE);
+    unpinPage(pool, page, true);
+  }
+  printf("%" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 "\n", pool -> hits, pool -> misses, pool -> evictions, pool -> writeBacks);
+
+  for (unsigned int i=0; i<NR_PAGES; ++i) {                             /* reads the evicted pages back */
+    page = pinPage(pool, ids[i]);
+    bad += page[0] != (char)('a'+i%26) || page[PAGE_SIZE-1] != (char)('a'+i%26);
+    unpinPage(pool, page, false);
+  }
+  printf("%u\n", bad);
+  printf("%" PRIu64 " %" PRIu64 " %" PRIu64 " %" PRIu64 "\n", pool -> hits, pool -> misses, pool -> evictions, pool -> writeBacks);
+
+  page = pinPage(pool, ids[NR_PAGES-1]);                                 /* pins a resident page twice */
+  printf("%d\n", pinPage(pool, ids[NR_PAGES-1]) == page);
+  unpinPage(pool, page, false);
+  unpinPage(pool, page, false);
+
+  freePoolPage(pool, pinPage(pool, ids[1]));
+  page = allocPoolPage(pool, &id);                                       /* reuses the freed page, zeroed */
+  printf("%" PRIu64 " %d\n", id, page[0]);
+  memset(page, 'z', PAGE_SIZE);
+  unpinPage(pool, page, true);
+  closeBufferPool(pool);
+  closePageFile(file);
+
+  file = openPageFile(path, PAGE_SIZE);                                  /* reads the pages written back on close */
+  bad = 0;
+  for (unsigned int i=0; i<NR_PAGES; ++i) {
+    readPage(file, ids[i], buf);
+    bad += buf[PAGE_SIZE-1] != (char)(i == 1 ? 'z' : 'a'+i%26);
+  }
+  printf("%u\n", bad);
+  closePageFile(file);
+
+  unlink(path);
+  /*
+   * gcc -Iinclude bufferpool_test.c bufferpool.c wal.c pagefile.c
+   *
+   * NULL
+   * 0 0 32 32
+   * 0
+   * 0 64 96 64
+   * 1
+   * 2 0
+   * 0
+   *
+   */
+}
@@ -0,0 +1,471 @@
+/*
+ * Copyright (c) 2020, 9rum. All rights reserved.
+ * Use of this source code is governed by a BSD-style
+ * license that can be found in the LICENSE file.
+ *
+ * File Processing, 2020
+ * cowbplustree.c
+ * Copy-on-write B+-tree implementation
+ */
+
+#include <stdlib.h>
+
+#include "search.h"
+#include "cowbplustree.h"
+
+/**
+ * getNode returns a new node.
+ * The header, K and P share a single allocation aligned to a cache line,
+ * and K and P have a spare entry so that an overflowing copy is split in place.
+ * @param m: fanout of B+-tree
+ * @param level: level of the node, 0 for terminal nodes
+ */
+static inline CowNode *getNode(const unsigned int m, const unsigned int level) {
+  const size_t  offset  = sizeof(CowNode)+(sizeof(int)*(m+1)+sizeof(void *)-1 & ~(sizeof(void *)-1)),
+                size    = (level == 0 ? offset : offset+sizeof(void *)*(m+1))+CACHE_LINE_SIZE-1 & ~(size_t)(CACHE_LINE_SIZE-1);
+  CowNode *node         = aligned_alloc(CACHE_LINE_SIZE, size);
+  node -> n             = 0;
+  node -> level         = level;
+  node -> P             = level == 0 ? NULL : (CowNode **)((char *)node+offset);
+  return node;
+}
+
+/**
+ * copyNode returns a private copy of node x.
+ * @param m: fanout of B+-tree
+ * @param x: a node to copy
+ */
+static inline CowNode *copyNode(const unsigned int m, const CowNode *x) {
+  CowNode *y = getNode(m, x -> level);
+  y -> n     = x -> n;
+  memcpy(y -> K, x -> K, sizeof(int)*x -> n);
+  if (x -> level != 0) memcpy(y -> P, x -> P, sizeof(CowNode *)*(x -> n+1));
+  return y;
+}
+
+/**
+ * freeNodes frees the subtree rooted at x.
+ * @param x: a node
+ */
+static void freeNodes(CowNode *x) {
+  if (x -> level != 0) for (unsigned int i=0; i<=x -> n; ++i) freeNodes(x -> P[i]);
+  free(x);
+}
+
+/**
+ * retire defers freeing node x of T, which readers of the current epoch may still reach.
+ * @param T: a copy-on-write B+-tree
+ * @param x: a node replaced by the current operation
+ */
+static void retire(CowTree *T, CowNode *x) {
+  if (T -> retiredCount == T -> retiredCapacity) {
+    T -> retiredCapacity  = T -> retiredCapacity == 0 ? 64 : T -> retiredCapacity<<1;
+    T -> retired          = realloc(T -> retired, sizeof(Retired)*T -> retiredCapacity);
+  }
+  T -> retired[T -> retiredCount].node  = x;
+  T -> retired[T -> retiredCount].epoch = atomic_load_explicit(&T -> epoch, memory_order_relaxed);
+  T -> retiredCount++;
+}
+
+/**
+ * reclaim frees the retired nodes of T that no pinned reader can reach.
+ * @param T: a copy-on-write B+-tree
+ */
+static void reclaim(CowTree *T) {
+  register uint64_t min = UINT64_MAX,
+                    epoch;
+  register size_t   n   = 0;
+
+  for (unsigned int slot=0; slot<COW_MAX_READERS; ++slot)
+    if ((epoch = atomic_load(&T -> slots[slot])) != 0 && epoch < min) min = epoch;
+
+  for (size_t i=0; i<T -> retiredCount; ++i) {
+    if  (T -> retired[i].epoch < min) free(T -> retired[i].node);
+    else                              T -> retired[n++] = T -> retired[i];
+  }
+  T -> retiredCount = n;
+}
+
+/**
+ * publish makes root the current version of T and reclaims the nodes it replaced if possible.
+ * @param T: a copy-on-write B+-tree
+ * @param root: root of the new version
+ */
+static void publish(CowTree *T, CowNode *root) {
+  atomic_store(&T -> root, root);
+  atomic_fetch_add(&T -> epoch, 1);
+  reclaim(T);
+}
+
+/**
+ * insert returns a copy of the subtree rooted at x with key inserted, or x itself if it already contains key.
+ * If the copy overflows, it is split and right and separator receive the right half and the key between them.
+ * @param T: a copy-on-write B+-tree
+ * @param x: root of a subtree
+ * @param key: a key to insert
+ * @param right: where to store the right half of a split, or NULL if x is not split
+ * @param separator: where to store the maximum key of the left half of a split
+ */
+static CowNode *insert(CowTree *T, CowNode *x, const int key, CowNode **right, int *separator) {
+  register const unsigned int m = T -> m;
+  register const unsigned int i = lower_bound(x -> K, x -> n, key);
+  register CowNode  *y;
+  CowNode           *z;
+
+  *right = NULL;
+
+  if (x -> level == 0) {
+    if (i < x -> n && key == x -> K[i]) return x;
+
+    y       = getNode(m, 0);
+    memcpy(y -> K, x -> K, sizeof(int)*i);
+    memcpy(&y -> K[i+1], &x -> K[i], sizeof(int)*(x -> n-i));
+    y -> K[i] = key;
+    y -> n  = x -> n+1;
+    retire(T, x);
+
+    if (y -> n <= m) return y;
+
+    z           = getNode(m, 0);                      /* split y, which overflows into its spare entry */
+    memcpy(z -> K, &y -> K[(m+1)/2], sizeof(int)*((m>>1)+1));
+    y -> n      = m+1>>1;
+    z -> n      = (m>>1)+1;
+    *separator  = y -> K[y -> n-1];
+    *right      = z;
+    return y;
+  }
+
+  register CowNode *child = insert(T, x -> P[i], key, &z, separator);
+  if (child == x -> P[i]) return x;
+
+  y         = copyNode(m, x);
+  y -> P[i] = child;
+  retire(T, x);
+
+  if (z == NULL) return y;
+
+  memmove(&y -> K[i+1], &y -> K[i], sizeof(int)*(y -> n-i));
+  memmove(&y -> P[i+2], &y -> P[i+1], sizeof(CowNode *)*(y -> n-i));
+  y -> K[i]   = *separator;
+  y -> P[i+1] = z;
+
+  if (++y -> n < m) return y;
+
+  z           = getNode(m, y -> level);               /* split y, which overflows into its spare entry */
+  memcpy(z -> K, &y -> K[m/2+1], sizeof(int)*(m-(m>>1)-1));
+  memcpy(z -> P, &y -> P[m/2+1], sizeof(CowNode *)*(m-(m>>1)));
+  y -> n      = m>>1;
+  z -> n      = m-(m>>1)-1;
+  *separator  = y -> K[m>>1];
+  *right      = z;
+  return y;
+}
+
+/**
+ * erase returns a copy of the subtree rooted at x with key deleted, or x itself if it does not contain key.
+ * The root of the copy may underflow, which is left to the caller.
+ * @param T: a copy-on-write B+-tree
+ * @param x: root of a subtree
+ * @param key: a key to delete
+ */
+static CowNode *erase(CowTree *T, CowNode *x, const int key) {
+  register const unsigned int m = T -> m;
+  register const unsigned int i = lower_bound(x -> K, x -> n, key);
+  register CowNode  *y,
+                    *z,
+                    *bestSibling;
+
+  if (x -> level == 0) {
+    if (i == x -> n || key != x -> K[i]) return x;
+
+    y       = getNode(m, 0);
+    memcpy(y -> K, x -> K, sizeof(int)*i);
+    memcpy(&y -> K[i], &x -> K[i+1], sizeof(int)*(x -> n-i-1));
+    y -> n  = x -> n-1;
+    retire(T, x);
+    return y;
+  }
+
+  if ((z = erase(T, x -> P[i], key)) == x -> P[i]) return x;
+
+  y         = copyNode(m, x);
+  y -> P[i] = z;
+  retire(T, x);
+
+  const unsigned int min = z -> level == 0 ? m+1>>1 : m-1>>1;
+  if (min <= z -> n) return y;
+
+  const unsigned int b  = i == 0                                ? i+1
+                        : i == y -> n                           ? i-1
+                        : y -> P[i-1] -> n < y -> P[i+1] -> n   ? i+1
+                                                                : i-1;            /* choose bestSibling of z node */
+
+  if (min < y -> P[b] -> n) {                                                     /* case of key redistribution */
+    bestSibling = copyNode(m, y -> P[b]);
+    retire(T, y -> P[b]);
+    y -> P[b]   = bestSibling;
+
+    if (z -> level == 0) {
+      if  (b < i) {
+        memmove(&z -> K[1], z -> K, sizeof(int)*z -> n);
+        z -> K[0]   = bestSibling -> K[bestSibling -> n-1];
+        y -> K[i-1] = bestSibling -> K[bestSibling -> n-2];
+      } else {
+        z -> K[z -> n]  = bestSibling -> K[0];
+        y -> K[i]       = bestSibling -> K[0];
+        memmove(bestSibling -> K, &bestSibling -> K[1], sizeof(int)*(bestSibling -> n-1));
+      }
+    } else {
+      if  (b < i) {
+        memmove(&z -> K[1], z -> K, sizeof(int)*z -> n);
+        memmove(&z -> P[1], z -> P, sizeof(CowNode *)*(z -> n+1));
+        z -> K[0]   = y -> K[i-1];
+        z -> P[0]   = bestSibling -> P[bestSibling -> n];
+        y -> K[i-1] = bestSibling -> K[bestSibling -> n-1];
+      } else {
+        z -> K[z -> n]    = y -> K[i];
+        z -> P[z -> n+1]  = bestSibling -> P[0];
+        y -> K[i]         = bestSibling -> K[0];
+        memmove(bestSibling -> K, &bestSibling -> K[1], sizeof(int)*(bestSibling -> n-1));
+        memmove(bestSibling -> P, &bestSibling -> P[1], sizeof(CowNode *)*bestSibling -> n);
+      }
+    }
+    bestSibling -> n--;
+    z -> n++;
+    return y;
+  }
+
+  if (b < i) {                                                                    /* case of node merge into a copy of the left sibling */
+    bestSibling = copyNode(m, y -> P[b]);
+    retire(T, y -> P[b]);
+    if (z -> level == 0) {
+      memcpy(&bestSibling -> K[bestSibling -> n], z -> K, sizeof(int)*z -> n);
+      bestSibling -> n += z -> n;
+    } else {
+      bestSibling -> K[bestSibling -> n] = y -> K[i-1];
+      memcpy(&bestSibling -> K[bestSibling -> n+1], z -> K, sizeof(int)*z -> n);
+      memcpy(&bestSibling -> P[bestSibling -> n+1], z -> P, sizeof(CowNode *)*(z -> n+1));
+      bestSibling -> n += z -> n+1;
+    }
+    free(z);                                                                      /* z is private to this operation */
+    y -> P[b] = bestSibling;
+    memmove(&y -> K[i-1], &y -> K[i], sizeof(int)*(y -> n-i));
+    memmove(&y -> P[i], &y -> P[i+1], sizeof(CowNode *)*(y -> n-i));
+  } else {                                                                        /* case of node merge with the right sibling */
+    bestSibling = y -> P[b];
+    if (z -> level == 0) {
+      memcpy(&z -> K[z -> n], bestSibling -> K, sizeof(int)*bestSibling -> n);
+      z -> n += bestSibling -> n;
+    } else {
+      z -> K[z -> n] = y -> K[i];
+      memcpy(&z -> K[z -> n+1], bestSibling -> K, sizeof(int)*bestSibling -> n);
+      memcpy(&z -> P[z -> n+1], bestSibling -> P, sizeof(CowNode *)*(bestSibling -> n+1));
+      z -> n += bestSibling -> n+1;
+    }
+    retire(T, bestSibling);
+    memmove(&y -> K[i], &y -> K[i+1], sizeof(int)*(y -> n-i-1));
+    memmove(&y -> P[i+1], &y -> P[i+2], sizeof(CowNode *)*(y -> n-i-1));
+  }
+  y -> n--;
+  return y;
+}
+
+/**
+ * createCOW returns a new empty copy-on-write B+-tree.
+ * @param m: fanout of B+-tree
+ */
+CowTree *createCOW(const unsigned int m) {
+  CowTree *T = calloc(1, sizeof(CowTree));
+  atomic_init(&T -> root, NULL);
+  atomic_init(&T -> epoch, 1);
+  for (unsigned int slot=0; slot<COW_MAX_READERS; ++slot) atomic_init(&T -> slots[slot], 0);
+  T -> m     = m;
+  return T;
+}
+
+/**
+ * destroyCOW frees T, which must have no pinned readers.
+ * @param T: a copy-on-write B+-tree
+ */
+void destroyCOW(CowTree *T) {
+  CowNode *root = atomic_load(&T -> root);
+  if (root != NULL) freeNodes(root);
+  for (size_t i=0; i<T -> retiredCount; ++i) free(T -> retired[i].node);
+  free(T -> retired);
+  free(T);
+}
+
+/**
+ * insertCOW inserts newKey into T and publishes the new version.
+ * Writers must be serialized by the caller.
+ * @param T: a copy-on-write B+-tree
+ * @param newKey: a key to insert
+ */
+void insertCOW(CowTree *T, const int newKey) {
+  register CowNode  *root = atomic_load_explicit(&T -> root, memory_order_relaxed),
+                    *x;
+  CowNode           *y;
+  int               separator;
+
+  if (root == NULL) {
+    x         = getNode(T -> m, 0);
+    x -> K[0] = newKey;
+    x -> n    = 1;
+    publish(T, x);
+    return;
+  }
+
+  if ((x = insert(T, root, newKey, &y, &separator)) == root) return;
+
+  if (y != NULL) {                                    /* the level of tree increases */
+    root          = getNode(T -> m, x -> level+1);
+    root -> K[0]  = separator;
+    root -> P[0]  = x;
+    root -> P[1]  = y;
+    root -> n     = 1;
+    x             = root;
+  }
+
+  publish(T, x);
+}
+
+/**
+ * deleteCOW deletes oldKey from T and publishes the new version.
+ * Writers must be serialized by the caller.
+ * @param T: a copy-on-write B+-tree
+ * @param oldKey: a key to delete
+ */
+void deleteCOW(CowTree *T, const int oldKey) {
+  register CowNode  *root = atomic_load_explicit(&T -> root, memory_order_relaxed),
+                    *x;
+
+  if (root == NULL || (x = erase(T, root, oldKey)) == root) return;
+
+  if (x -> n == 0) {                                  /* the level of tree decreases */
+    root = x -> level == 0 ? NULL : x -> P[0];
+    free(x);
+    x = root;
+  }
+
+  publish(T, x);
+}
+
+/**
+ * pinCOW pins the current version of T in slot and returns its root, which is NULL if T is empty.
+ * The version stays immutable and reachable until unpinCOW.
+ * @param T: a copy-on-write B+-tree
+ * @param slot: a reader slot, less than COW_MAX_READERS, used by one thread at a time
+ */
+const CowNode *pinCOW(CowTree *T, const unsigned int slot) {
+  atomic_store(&T -> slots[slot], atomic_load(&T -> epoch)); /* announce the epoch before reading the root */
+  return atomic_load(&T -> root);
+}
+
+/**
+ * unpinCOW releases the version pinned in slot.
+ * @param T: a copy-on-write B+-tree
+ * @param slot: a reader slot
+ */
+void unpinCOW(CowTree *T, const unsigned int slot) { atomic_store_explicit(&T -> slots[slot], 0, memory_order_release); }
+
+/**
+ * searchCOW returns whether the version of root contains key.
+ * @param root: root of a pinned version
+ * @param key: a key to search
+ */
+bool searchCOW(const CowNode *root, const int key) {
+  if (root == NULL) return false;
+
+  register const CowNode *x = root;
+  register unsigned int i;
+
+  while (x -> level != 0) x = x -> P[lower_bound(x -> K, x -> n, key)];
+
+  i = lower_bound(x -> K, x -> n, key);
+  return i < x -> n && key == x -> K[i];
+}
+
+/**
+ * advance moves cursor to the first key of the next terminal node, or past the end of the version.
+ * @param cursor: a cursor
+ */
+static void advance(CowCursor *cursor) {
+  register const CowNode *x;
+
+  while (0 < cursor -> depth && cursor -> index[cursor -> depth-1] == cursor -> path[cursor -> depth-1] -> n) cursor -> depth--;
+
+  if (cursor -> depth == 0) { cursor -> node = NULL; return; }
+
+  for (x = cursor -> path[cursor -> depth-1] -> P[++cursor -> index[cursor -> depth-1]]; x -> level != 0; x = x -> P[0]) {
+    cursor -> path[cursor -> depth]   = x;
+    cursor -> index[cursor -> depth]  = 0;
+    cursor -> depth++;
+  }
+
+  cursor -> node  = x;
+  cursor -> i     = 0;
+}
+
+/**
+ * seekCOW positions cursor at the first key not less than lo in the version of root.
+ * @param cursor: a cursor to position
+ * @param root: root of a pinned version
+ * @param lo: the lower bound of the range, inclusive
+ * @param hi: the upper bound of the range, inclusive
+ */
+void seekCOW(CowCursor *cursor, const CowNode *root, const int lo, const int hi) {
+  cursor -> node  = NULL;
+  cursor -> i     = 0;
+  cursor -> hi    = hi;
+  cursor -> depth = 0;
+
+  if (root == NULL || hi < lo) return;
+
+  register const CowNode *x = root;
+  register unsigned int i;
+
+  while (x -> level != 0) {
+    i                                 = lower_bound(x -> K, x -> n, lo);
+    cursor -> path[cursor -> depth]   = x;
+    cursor -> index[cursor -> depth]  = i;
+    cursor -> depth++;
+    x                                 = x -> P[i];
+  }
+
+  cursor -> node  = x;
+  cursor -> i     = lower_bound(x -> K, x -> n, lo);
+
+  if (cursor -> i == x -> n) advance(cursor);         /* every key of x is less than lo */
+}
+
+/**
+ * nextCOW copies up to size keys from cursor into keys and advances cursor past them.
+ * It returns the number of keys copied, which is 0 once the range is exhausted.
+ * @param cursor: a cursor positioned by seekCOW
+ * @param keys: a buffer of at least size keys
+ * @param size: size of buffer
+ */
+unsigned int nextCOW(CowCursor *cursor, int *keys, const unsigned int size) {
+  register const CowNode *z;
+  register unsigned int count = 0,
+                        end,
+                        n;
+
+  while (count < size && (z = cursor -> node) != NULL) {
+    end = z -> K[z -> n-1] <= cursor -> hi ? z -> n : lower_bound(z -> K, z -> n, cursor -> hi);  /* find the end of the range within z */
+    if (end < z -> n && z -> K[end] == cursor -> hi) end++;
+    if (end <= cursor -> i) { cursor -> node = NULL; break; }
+
+    n = end-cursor -> i < size-count ? end-cursor -> i : size-count;
+    memcpy(&keys[count], &z -> K[cursor -> i], sizeof(int)*n);
+    count       += n;
+    cursor -> i += n;
+
+    if (cursor -> i < end)  break;                                                                /* the batch is full */
+    if (end < z -> n)       { cursor -> node = NULL; break; }                                     /* the range ends within z */
+
+    advance(cursor);                                                                              /* move on to the next terminal node */
+  }
+
+  return count;
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2020, 9rum. All rights reserved.
+ * Use of this source code is governed by a BSD-style
+ * license that can be found in the LICENSE file.
+ *
+ * File Processing, 2020
+ * cowbplustree.h
+ * Copy-on-write B+-tree implementation
+ */
+
+#ifndef _COWBPLUSTREE_H
+#define _COWBPLUSTREE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define COW_MAX_READERS 64
+#define COW_MAX_HEIGHT  32
+
+/**
+ * CowNode represents a node of copy-on-write B+-tree.
+ * Terminal nodes have level 0 and no P, and internal nodes keep their children in P.
+ * K and P share a single allocation aligned to a cache line with the node itself.
+ * A node is never modified once it is reachable from a published root.
+ */
+typedef struct CowNode {
+  unsigned int      n;
+  unsigned int      level;
+  struct CowNode    **P;
+  int               K[];
+} CowNode;
+
+/**
+ * Retired represents a node replaced by a writer, which is freed
+ * once no reader pinned at or before epoch can reach it.
+ */
+typedef struct Retired {
+  CowNode           *node;
+  uint64_t          epoch;
+} Retired;
+
+/**
+ * CowTree represents a B+-tree updated by copying the path from the root to the modified nodes.
+ * A single writer publishes a new root per operation, and readers pin the current root
+ * in a slot of their own, announcing the epoch they read it in.
+ * Replaced nodes are retired with the epoch of their replacement and reclaimed
+ * once every pinned reader announced a later epoch.
+ * Terminal nodes are not linked, since the link would tie each version to its neighbours.
+ */
+typedef struct CowTree {
+  _Atomic(CowNode *)  root;
+  _Atomic uint64_t    epoch;
+  _Atomic uint64_t    slots[COW_MAX_READERS];
+  Retired             *retired;
+  size_t              retiredCount;
+  size_t              retiredCapacity;
+  unsigned int        m;
+} CowTree;
+
+/**
+ * CowCursor represents a position in a snapshot of copy-on-write B+-tree during a range scan.
+ * It keeps the path to the current terminal node to find the next one.
+ */
+typedef struct CowCursor {
+  const CowNode     *node;
+  unsigned int      i;
+  int               hi;
+  unsigned int      depth;
+  const CowNode     *path[COW_MAX_HEIGHT];
+  unsigned int      index[COW_MAX_HEIGHT];
+} CowCursor;
+
+/**
+ * createCOW returns a new empty copy-on-write B+-tree.
+ * @param m: fanout of B+-tree
+ */
+CowTree *createCOW(const unsigned int m);
+
+/**
+ * destroyCOW frees T, which must have no pinned readers.
+ * @param T: a copy-on-write B+-tree
+ */
+void destroyCOW(CowTree *T);
+
+/**
+ * insertCOW inserts newKey into T and publishes the new version.
+ * Writers must be serialized by the caller.
+ * @param T: a copy-on-write B+-tree
+ * @param newKey: a key to insert
+ */
+void insertCOW(CowTree *T, const int newKey);
+
+/**
+ * deleteCOW deletes oldKey from T and publishes the new version.
+ * Writers must be serialized by the caller.
+ * @param T: a copy-on-write B+-tree
+ * @param oldKey: a key to delete
+ */
+void deleteCOW(CowTree *T, const int oldKey);
+
+/**
+ * pinCOW pins the current version of T in slot and returns its root, which is NULL if T is empty.
+ * The version stays immutable and reachable until unpinCOW.
+ * @param T: a copy-on-write B+-tree
+ * @param slot: a reader slot, less than COW_MAX_READERS, used by one thread at a time
+ */
+const CowNode *pinCOW(CowTree *T, const unsigned int slot);
+
+/**
+ * unpinCOW releases the version pinned in slot.
+ * @param T: a copy-on-write B+-tree
+ * @param slot: a reader slot
+ */
+void unpinCOW(CowTree *T, const unsigned int slot);
+
+/**
+ * searchCOW returns whether the version of root contains key.
+ * @param root: root of a pinned version
+ * @param key: a key to search
+ */
+bool searchCOW(const CowNode *root, const int key);
+
+/**
+ * seekCOW positions cursor at the first key not less than lo in the version of root.
+ * @param cursor: a cursor to position
+ * @param root: root of a pinned version
+ * @param lo: the lower bound of the range, inclusive
+ * @param hi: the upper bound of the range, inclusive
+ */
+void seekCOW(CowCursor *cursor, const CowNode *root, const int lo, const int hi);
+
+/**
+ * nextCOW copies up to size keys from cursor into keys and advances cursor past them.
+ * It returns the number of keys copied, which is 0 once the range is exhausted.
+ * @param cursor: a cursor positioned by seekCOW
+ * @param keys: a buffer of at least size keys
+ * @param size: size of buffer
+ */
+unsigned int nextCOW(CowCursor *cursor, int *keys, const unsigned int size);
+
+#endif /* _COWBPLUSTREE_H */
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2020, 9rum. All rights reserved.
+ * Use of this source code is governed by a BSD-style
+ * license that can be found in the LICENSE file.
+ *
+ * File Processing, 2020
+ *
+ * cowbplustree_test.c - copy-on-write B+-tree unit test
+ */
+#include <stdio.h>
+#include <limits.h>
+#include <pthread.h>
+
+#include "cowbplustree.h"
+
+#define NR_READERS  3
+#define NR_KEYS     20000
+
+static CowTree      *tree;
+static atomic_bool  done;
+
+/**
+ * print prints the keys between lo and hi in the version of root.
+ * @param root: root of a pinned version
+ * @param lo: the lower bound of the range, inclusive
+ * @param hi: the upper bound of the range, inclusive
+ */
+static void print(const CowNode *root, const int lo, const int hi) {
+  CowCursor     cursor;
+  int           keys[8];
+  unsigned int  n;
+
+  seekCOW(&cursor, root, lo, hi);
+  while ((n = nextCOW(&cursor, keys, 8)) > 0) for (unsigned int i=0; i<n; ++i) printf("%d ", keys[i]);
+  printf("\n");
+}
+
+/**
+ * reader pins versions of tree until done and returns the number of them that were not
+ * a run of consecutive keys starting at 0 or ending at NR_KEYS-1, which is what the writer publishes.
+ * @param arg: the reader slot
+ */
+static void *reader(void *arg) {
+  const unsigned int  slot  = (uintptr_t)arg;
+  uintptr_t           bad   = 0;
+  int                 keys[64];
+
+  while (!done) {
+    const CowNode *root   = pinCOW(tree, slot);
+    CowCursor     cursor;
+    unsigned int  n;
+    int           first   = -1,
+                  last    = -1;
+    bool          gap     = false;
+
+    seekCOW(&cursor, root, 0, INT_MAX);
+    while ((n = nextCOW(&cursor, keys, 64)) > 0) for (unsigned int i=0; i<n; ++i) {
+      if (first < 0)  first = keys[i];
+      else            gap  |= keys[i] != last+1;
+      last = keys[i];
+    }
+    bad += gap || (0 < first && last != NR_KEYS-1) || (0 <= first && !(searchCOW(root, first) && searchCOW(root, last)));
+    unpinCOW(tree, slot);
+  }
+
+  return (void *)bad;
+}
+
+int main(void) {
+  const int       testcases[] = {40, 11, 77, 33, 20, 90, 99, 70, 88, 80, 66, 10, 22, 30, 44, 55, 50, 60, 25, 49};
+  const CowNode   *root;
+  pthread_t       readers[NR_READERS];
+  uintptr_t       bad = 0;
+  void            *ret;
+
+  tree = createCOW(4);
+  for (const int *it = testcases; it < testcases + sizeof(testcases)/sizeof(int); ++it) insertCOW(tree, *it);
+  root = pinCOW(tree, 0);
+  print(root, 0, 100);
+  for (const int *it = testcases; it < testcases + sizeof(testcases)/sizeof(int); it += 2) deleteCOW(tree, *it);
+  print(pinCOW(tree, 1), 0, 100);
+  unpinCOW(tree, 1);
+  print(root, 0, 100);                                                    /* the pinned version is left as it was */
+  print(root, 30, 60);
+  unpinCOW(tree, 0);
+  for (const int *it = testcases+1; it < testcases + sizeof(testcases)/sizeof(int); it += 2) deleteCOW(tree, *it);
+  printf("%s\n", pinCOW(tree, 0) == NULL ? "NULL" : "not empty");
+  unpinCOW(tree, 0);
+  destroyCOW(tree);
+
+  tree = createCOW(8);
+  for (unsigned int i=0; i<NR_READERS; ++i) pthread_create(&readers[i], NULL, reader, (void *)(uintptr_t)i);
+  for (int key=0; key<NR_KEYS; ++key) insertCOW(tree, key);               /* publishes a version per key while the readers scan */
+  for (int key=0; key<NR_KEYS; ++key) deleteCOW(tree, key);
+  done = true;
+  for (unsigned int i=0; i<NR_READERS; ++i) {
+    pthread_join(readers[i], &ret);
+    bad += (uintptr_t)ret;
+  }
+  printf("%lu\n", (unsigned long)bad);
+  printf("%s\n", pinCOW(tree, 0) == NULL ? "NULL" : "not empty");
+  unpinCOW(tree, 0);
+  destroyCOW(tree);
+  /*
+   * gcc -pthread -Iinclude cowbplustree_test.c cowbplustree.c
+   *
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70 77 80 88 90 99
+   * 10 11 30 33 49 55 60 70 80 90
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70 77 80 88 90 99
+   * 30 33 40 44 49 50 55 60
+   * NULL
+   * 0
+   * NULL
+   *
+   */
+}
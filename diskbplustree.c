@@ -0,0 +1,453 @@
+/*
+ * Copyright (c) 2020, 9rum. All rights reserved.
+ * Use of this source code is governed by a BSD-style
+ * license that can be found in the LICENSE file.
+ *
+ * File Processing, 2020
+ * diskbplustree.c
+ * Disk-resident B+-tree implementation
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "search.h"
+#include "stack.h"
+#include "diskbplustree.h"
+
+enum { INDEX_SET, SEQUENCE_SET }; /* slots of the page file meta */
+
+/**
+ * offset returns the offset of the child page IDs in an internal node.
+ * K has a spare entry so that an overflowing node is split in place.
+ * @param m: fanout of internal nodes
+ */
+static inline size_t offset(const unsigned int m) { return sizeof(DiskNode)+(sizeof(int)*m+sizeof(PageId)-1 & ~(sizeof(PageId)-1)); }
+
+/**
+ * children returns the child page IDs of internal node x.
+ * @param T: a disk-resident B+-tree
+ * @param x: an internal node
+ */
+static inline PageId *children(const DiskTree T, const DiskNode *x) { return (PageId *)((char *)x+offset(T -> m)); }
+
+/**
+ * pinNode pins node id of T in the buffer pool.
+ * @param T: a disk-resident B+-tree
+ * @param id: a page to pin
+ */
+static inline DiskNode *pinNode(const DiskTree T, const PageId id) { return pinPage(T -> pool, id); }
+
+/**
+ * unpinNode unpins node x of T, which is written back on eviction if dirty.
+ * @param T: a disk-resident B+-tree
+ * @param x: a pinned node
+ * @param dirty: whether x was modified
+ */
+static inline void unpinNode(const DiskTree T, DiskNode *x, const bool dirty) { unpinPage(T -> pool, x, dirty); }
+
+/**
+ * newNode returns a new pinned node of T.
+ * @param T: a disk-resident B+-tree
+ * @param level: level of the node, 0 for terminal nodes
+ */
+static inline DiskNode *newNode(const DiskTree T, const uint32_t level) {
+  PageId id;
+  DiskNode *x = allocPoolPage(T -> pool, &id);
+  x -> id     = id;
+  x -> level  = level;
+  return x;
+}
+
+/**
+ * freeNode unpins node x of T and frees its page.
+ * @param T: a disk-resident B+-tree
+ * @param x: a pinned node
+ */
+static inline void freeNode(const DiskTree T, DiskNode *x) { freePoolPage(T -> pool, x); }
+
+/**
+ * unpinPath releases the nodes left on stack unmodified.
+ * @param T: a disk-resident B+-tree
+ * @param stack: a stack of pinned nodes
+ */
+static inline void unpinPath(const DiskTree T, struct path_stack *stack) { while (!path_empty(stack)) unpinNode(T, path_pop(stack), false); }
+
+/**
+ * descend pins the nodes from the root of T to the terminal node where key belongs,
+ * storing the internal nodes and the indices of the children taken on the stacks.
+ * It returns the terminal node.
+ * @param T: a disk-resident B+-tree
+ * @param key: a key to search
+ * @param stack: a stack to store the internal nodes on
+ * @param iStack: a stack to store the indices on
+ */
+static DiskNode *descend(const DiskTree T, const int key, struct path_stack *stack, struct path_stack *iStack) {
+  register DiskNode *x;
+  register unsigned int i;
+
+  path_init(stack);
+  path_init(iStack);
+
+  for (x = pinNode(T, T -> IndexSet != 0 ? T -> IndexSet : T -> SequenceSet); x -> level != 0; x = pinNode(T, children(T, x)[i])) {
+    i = lower_bound(x -> K, x -> n, key);
+    path_push(stack, x);
+    path_push(iStack, (void *)(uintptr_t)i);
+  }
+
+  return x;
+}
+
+/**
+ * logDBPT logs the pages modified by the last operation on T.
+ * @param T: a disk-resident B+-tree
+ */
+static void logDBPT(DiskTree T) {
+  if (T -> pool -> pendingCount == 0) return;
+
+  T -> file -> meta[INDEX_SET]    = T -> IndexSet;
+  T -> file -> meta[SEQUENCE_SET] = T -> SequenceSet;
+  logBufferPool(T -> pool);
+
+  if (WAL_CHECKPOINT_SIZE < T -> log -> end+T -> log -> used) checkpointDBPT(T);
+}
+
+/**
+ * openDBPT opens the B+-tree stored in the page file at path, creating it if it does not exist.
+ * The log of the tree is kept next to the file, with .wal appended to path,
+ * and the operations committed to the log are redone before the tree is returned.
+ * It returns NULL if the files cannot be opened or budget is too small for the buffer pool.
+ * @param path: path to the page file
+ * @param pageSize: size of each page in bytes
+ * @param budget: memory budget of the buffer pool in bytes
+ */
+DiskTree openDBPT(const char *path, const uint32_t pageSize, const size_t budget) {
+  if (pageSize % sizeof(PageId) != 0 || pageSize <= sizeof(DiskNode)) return NULL;  /* keep nodes in the buffer pool aligned */
+
+  register unsigned int m = (pageSize-sizeof(DiskNode))/(sizeof(int)+sizeof(PageId));
+  while (2 < m && pageSize < offset(m)+sizeof(PageId)*(m+1)) m--;                   /* leave room for the spare entries */
+  if (m < 3) return NULL;
+
+  char *logPath = malloc(strlen(path)+sizeof(".wal"));
+  strcat(strcpy(logPath, path), ".wal");
+
+  PageFile      *file = openPageFile(path, pageSize);
+  WriteAheadLog *log  = file == NULL ? NULL : openWAL(logPath);
+  free(logPath);
+  if (log == NULL) { if (file != NULL) closePageFile(file); return NULL; }
+
+  recoverWAL(log, file);
+
+  BufferPool *pool = openBufferPool(file, budget, log);
+  if (pool == NULL) { closeWAL(log); closePageFile(file); return NULL; }
+
+  DiskTree T          = malloc(sizeof(struct DiskTree));
+  T -> file           = file;
+  T -> log            = log;
+  T -> pool           = pool;
+  T -> IndexSet       = file -> meta[INDEX_SET];
+  T -> SequenceSet    = file -> meta[SEQUENCE_SET];
+  T -> m              = m;
+  T -> l              = (pageSize-sizeof(DiskNode))/sizeof(int)-1;
+  return T;
+}
+
+/**
+ * closeDBPT checkpoints T and closes its files.
+ * @param T: a disk-resident B+-tree
+ */
+void closeDBPT(DiskTree T) {
+  checkpointDBPT(T);
+  closeBufferPool(T -> pool);
+  closeWAL(T -> log);
+  closePageFile(T -> file);
+  free(T);
+}
+
+/**
+ * syncDBPT makes every operation on T so far durable with a single flush of the log.
+ * @param T: a disk-resident B+-tree
+ */
+void syncDBPT(DiskTree T) { commitWAL(T -> log); }
+
+/**
+ * checkpointDBPT writes back the pages of T to its page file and empties the log.
+ * @param T: a disk-resident B+-tree
+ */
+void checkpointDBPT(DiskTree T) {
+  flushBufferPool(T -> pool);
+  syncPageFile(T -> file);
+  truncateWAL(T -> log);
+}
+
+/**
+ * insert inserts newKey into T.
+ * @param T: a disk-resident B+-tree
+ * @param newKey: a key to insert
+ */
+static void insert(DiskTree T, const int newKey) {
+  register DiskNode *x,
+                    *y,
+                    *z;
+  struct path_stack stack,
+                    iStack;
+  register int key  = newKey;
+  register unsigned int i;
+  register PageId *P;
+
+  if (T -> SequenceSet == 0) {
+    z                 = newNode(T, 0);
+    z -> K[0]         = key;
+    z -> n            = 1;
+    T -> SequenceSet  = z -> id;
+    unpinNode(T, z, true);
+    return;
+  }
+
+  z = descend(T, newKey, &stack, &iStack);
+
+  if ((i = lower_bound(z -> K, z -> n, newKey)) < z -> n && newKey == z -> K[i]) { unpinNode(T, z, false); unpinPath(T, &stack); return; }
+
+  memmove(&z -> K[i+1], &z -> K[i], sizeof(int)*(z -> n-i));
+  z -> K[i] = key;
+
+  if (++z -> n <= T -> l) { unpinNode(T, z, true); unpinPath(T, &stack); return; }
+
+  y = newNode(T, 0);                                /* split z, which overflows into its spare entry */
+  memcpy(y -> K, &z -> K[(T -> l+1)/2], sizeof(int)*((T -> l>>1)+1));
+  z -> n  = T -> l+1>>1;
+  y -> n  = (T -> l>>1)+1;
+  key     = z -> K[z -> n-1];
+  y -> P  = z -> P;
+  z -> P  = y -> id;
+
+  while (!path_empty(&stack)) {
+    x = path_pop(&stack);
+    i = (uintptr_t)path_pop(&iStack);
+    P = children(T, x);
+
+    memmove(&x -> K[i+1], &x -> K[i], sizeof(int)*(x -> n-i));
+    memmove(&P[i+2], &P[i+1], sizeof(PageId)*(x -> n-i));
+    x -> K[i] = key;
+    P[i+1]    = y -> id;
+    unpinNode(T, z, true);
+    unpinNode(T, y, true);
+
+    if (++x -> n < T -> m) { unpinNode(T, x, true); unpinPath(T, &stack); return; }
+
+    y = newNode(T, x -> level);                     /* split x, which overflows into its spare entry */
+    memcpy(y -> K, &x -> K[T -> m/2+1], sizeof(int)*(T -> m-(T -> m>>1)-1));
+    memcpy(children(T, y), &P[T -> m/2+1], sizeof(PageId)*(T -> m-(T -> m>>1)));
+    x -> n  = T -> m>>1;
+    y -> n  = T -> m-(T -> m>>1)-1;
+    key     = x -> K[T -> m>>1];
+    z       = x;
+  }
+
+  x                 = newNode(T, z -> level+1);     /* the level of tree increases */
+  P                 = children(T, x);
+  x -> K[0]         = key;
+  P[0]              = z -> id;
+  P[1]              = y -> id;
+  x -> n            = 1;
+  T -> IndexSet     = x -> id;
+  unpinNode(T, x, true);
+  unpinNode(T, z, true);
+  unpinNode(T, y, true);
+}
+
+/**
+ * erase deletes oldKey from T.
+ * @param T: a disk-resident B+-tree
+ * @param oldKey: a key to delete
+ */
+static void erase(DiskTree T, const int oldKey) {
+  if (T -> SequenceSet == 0) return;
+
+  register DiskNode *x,
+                    *y,
+                    *bestSibling;
+  struct path_stack stack,
+                    iStack;
+  register unsigned int i,
+                        b;
+  register PageId *P,
+                  *Px,
+                  *Pb;
+
+  x = descend(T, oldKey, &stack, &iStack);
+
+  if ((i = lower_bound(x -> K, x -> n, oldKey)) == x -> n || oldKey != x -> K[i]) { unpinNode(T, x, false); unpinPath(T, &stack); return; }
+
+  x -> n--;
+  memmove(&x -> K[i], &x -> K[i+1], sizeof(int)*(x -> n-i));
+
+  if (path_empty(&stack)) {
+    if  (x -> n == 0) { T -> SequenceSet = 0; freeNode(T, x); }
+    else              unpinNode(T, x, true);
+    return;
+  }
+
+  while (!path_empty(&stack)) {
+    if  ((x -> level == 0 ? T -> l+1>>1 : T -> m-1>>1) <= x -> n) break;
+
+    y   = path_pop(&stack);
+    i   = (uintptr_t)path_pop(&iStack);
+    P   = children(T, y);
+
+    if      (i == 0)      bestSibling = pinNode(T, P[b = i+1]);                              /* choose bestSibling of x node */
+    else if (i == y -> n) bestSibling = pinNode(T, P[b = i-1]);
+    else {
+      register DiskNode *left   = pinNode(T, P[i-1]),
+                        *right  = pinNode(T, P[i+1]);
+      b           = left -> n < right -> n ? i+1 : i-1;
+      bestSibling = b < i ? left : right;
+      unpinNode(T, b < i ? right : left, false);
+    }
+
+    if (x -> level == 0 && T -> l+1>>1 < bestSibling -> n) {                                /* case of key redistribution */
+      if  (b < i) {
+        memmove(&x -> K[1], x -> K, sizeof(int)*x -> n);
+        x -> K[0]   = bestSibling -> K[bestSibling -> n-1];
+        y -> K[i-1] = bestSibling -> K[bestSibling -> n-2];
+      } else {
+        x -> K[x -> n]  = bestSibling -> K[0];
+        y -> K[i]       = bestSibling -> K[0];
+        memmove(bestSibling -> K, &bestSibling -> K[1], sizeof(int)*(bestSibling -> n-1));
+      }
+      bestSibling -> n--;
+      x -> n++;
+      unpinNode(T, bestSibling, true);
+      unpinNode(T, x, true);
+      unpinNode(T, y, true);
+      unpinPath(T, &stack);
+      return;
+    }
+
+    if (x -> level != 0 && T -> m-1>>1 < bestSibling -> n) {                                /* case of key redistribution */
+      Px = children(T, x);
+      Pb = children(T, bestSibling);
+      if  (b < i) {
+        memmove(&x -> K[1], x -> K, sizeof(int)*x -> n);
+        memmove(&Px[1], Px, sizeof(PageId)*(x -> n+1));
+        x -> K[0]   = y -> K[i-1];
+        Px[0]       = Pb[bestSibling -> n];
+        y -> K[i-1] = bestSibling -> K[bestSibling -> n-1];
+      } else {
+        x -> K[x -> n]  = y -> K[i];
+        Px[x -> n+1]    = Pb[0];
+        y -> K[i]       = bestSibling -> K[0];
+        memmove(bestSibling -> K, &bestSibling -> K[1], sizeof(int)*(bestSibling -> n-1));
+        memmove(Pb, &Pb[1], sizeof(PageId)*bestSibling -> n);
+      }
+      bestSibling -> n--;
+      x -> n++;
+      unpinNode(T, bestSibling, true);
+      unpinNode(T, x, true);
+      unpinNode(T, y, true);
+      unpinPath(T, &stack);
+      return;
+    }
+
+    if (b < i) {                                                                            /* case of node merge into the left sibling */
+      if (x -> level == 0) {
+        memcpy(&bestSibling -> K[bestSibling -> n], x -> K, sizeof(int)*x -> n);
+        bestSibling -> n += x -> n;
+        bestSibling -> P  = x -> P;
+      } else {
+        bestSibling -> K[bestSibling -> n] = y -> K[i-1];
+        memcpy(&bestSibling -> K[bestSibling -> n+1], x -> K, sizeof(int)*x -> n);
+        memcpy(&children(T, bestSibling)[bestSibling -> n+1], children(T, x), sizeof(PageId)*(x -> n+1));
+        bestSibling -> n += x -> n+1;
+      }
+      memmove(&y -> K[i-1], &y -> K[i], sizeof(int)*(y -> n-i));
+      memmove(&P[i], &P[i+1], sizeof(PageId)*(y -> n-i));
+      freeNode(T, x);
+      unpinNode(T, bestSibling, true);
+    } else {                                                                                /* case of node merge with the right sibling */
+      if (x -> level == 0) {
+        memcpy(&x -> K[x -> n], bestSibling -> K, sizeof(int)*bestSibling -> n);
+        x -> n += bestSibling -> n;
+        x -> P  = bestSibling -> P;
+      } else {
+        x -> K[x -> n] = y -> K[i];
+        memcpy(&x -> K[x -> n+1], bestSibling -> K, sizeof(int)*bestSibling -> n);
+        memcpy(&children(T, x)[x -> n+1], children(T, bestSibling), sizeof(PageId)*(bestSibling -> n+1));
+        x -> n += bestSibling -> n+1;
+      }
+      memmove(&y -> K[i], &y -> K[i+1], sizeof(int)*(y -> n-i-1));
+      memmove(&P[i+1], &P[i+2], sizeof(PageId)*(y -> n-i-1));
+      freeNode(T, bestSibling);
+      unpinNode(T, x, true);
+    }
+    y -> n--;
+    x = y;
+  }
+
+  if (path_empty(&stack) && x -> level != 0 && x -> n == 0) {                               /* the level of tree decreases */
+    T -> IndexSet = x -> level == 1 ? 0 : children(T, x)[0];
+    freeNode(T, x);
+  } else {
+    unpinNode(T, x, true);
+    unpinPath(T, &stack);
+  }
+}
+
+/**
+ * insertDBPT inserts newKey into T.
+ * The insertion is logged, and becomes durable on the next syncDBPT.
+ * @param T: a disk-resident B+-tree
+ * @param newKey: a key to insert
+ */
+void insertDBPT(DiskTree T, const int newKey) {
+  insert(T, newKey);
+  logDBPT(T);
+}
+
+/**
+ * deleteDBPT deletes oldKey from T.
+ * The deletion is logged, and becomes durable on the next syncDBPT.
+ * @param T: a disk-resident B+-tree
+ * @param oldKey: a key to delete
+ */
+void deleteDBPT(DiskTree T, const int oldKey) {
+  erase(T, oldKey);
+  logDBPT(T);
+}
+
+/**
+ * searchDBPT returns whether T contains key.
+ * @param T: a disk-resident B+-tree
+ * @param key: a key to search
+ */
+bool searchDBPT(const DiskTree T, const int key) {
+  if (T -> SequenceSet == 0) return false;
+
+  register DiskNode *x = pinNode(T, T -> IndexSet != 0 ? T -> IndexSet : T -> SequenceSet),
+                    *y;
+  register unsigned int i;
+
+  while (x -> level != 0) {
+    i = lower_bound(x -> K, x -> n, key);
+    y = pinNode(T, children(T, x)[i]);
+    unpinNode(T, x, false);
+    x = y;
+  }
+
+  const bool found = (i = lower_bound(x -> K, x -> n, key)) < x -> n && key == x -> K[i];
+  unpinNode(T, x, false);
+  return found;
+}
+
+/**
+ * traverseDBPT implements sequential access in T.
+ * @param T: a disk-resident B+-tree
+ */
+void traverseDBPT(const DiskTree T) {
+  register DiskNode *z;
+
+  for (PageId id = T -> SequenceSet; id != 0; id = z -> P, unpinNode(T, z, false)) {
+    z = pinNode(T, id);
+    for (unsigned int i=0; i<z -> n; ++i) printf("%d ", z -> K[i]);
+  }
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2020, 9rum. All rights reserved.
+ * Use of this source code is governed by a BSD-style
+ * license that can be found in the LICENSE file.
+ *
+ * File Processing, 2020
+ * diskbplustree.h
+ * Disk-resident B+-tree implementation
+ */
+
+#ifndef _DISKBPLUSTREE_H
+#define _DISKBPLUSTREE_H
+
+#include <stdio.h>
+#include <string.h>
+
+#include "bufferpool.h"
+
+/**
+ * DiskNode represents a node of disk-resident B+-tree, which occupies a page.
+ * Terminal nodes have level 0 and link to the next terminal node through P.
+ * Internal nodes store their children as page IDs following K.
+ */
+typedef struct DiskNode {
+  PageId        id;
+  PageId        P;
+  uint32_t      level;
+  uint32_t      n;
+  int           K[];
+} DiskNode;
+
+/**
+ * DiskTree represents a B+-tree whose nodes are pages of a page file,
+ * accessed through a buffer pool that keeps the pages on the current path pinned.
+ * Each operation logs the images of the pages it modified to a write-ahead log,
+ * so that pages are written back lazily and a crash loses no synced operation.
+ * m is the fanout of internal nodes and l the capacity of terminal nodes,
+ * both derived from the page size.
+ */
+typedef struct DiskTree {
+  PageFile      *file;
+  WriteAheadLog *log;
+  BufferPool    *pool;
+  PageId        IndexSet;
+  PageId        SequenceSet;
+  unsigned int  m;
+  unsigned int  l;
+} *DiskTree;
+
+/**
+ * openDBPT opens the B+-tree stored in the page file at path, creating it if it does not exist.
+ * The log of the tree is kept next to the file, with .wal appended to path,
+ * and the operations committed to the log are redone before the tree is returned.
+ * It returns NULL if the files cannot be opened or budget is too small for the buffer pool.
+ * @param path: path to the page file
+ * @param pageSize: size of each page in bytes
+ * @param budget: memory budget of the buffer pool in bytes
+ */
+DiskTree openDBPT(const char *path, const uint32_t pageSize, const size_t budget);
+
+/**
+ * closeDBPT checkpoints T and closes its files.
+ * @param T: a disk-resident B+-tree
+ */
+void closeDBPT(DiskTree T);
+
+/**
+ * syncDBPT makes every operation on T so far durable with a single flush of the log.
+ * @param T: a disk-resident B+-tree
+ */
+void syncDBPT(DiskTree T);
+
+/**
+ * checkpointDBPT writes back the pages of T to its page file and empties the log.
+ * @param T: a disk-resident B+-tree
+ */
+void checkpointDBPT(DiskTree T);
+
+/**
+ * insertDBPT inserts newKey into T.
+ * The insertion is logged, and becomes durable on the next syncDBPT.
+ * @param T: a disk-resident B+-tree
+ * @param newKey: a key to insert
+ */
+void insertDBPT(DiskTree T, const int newKey);
+
+/**
+ * deleteDBPT deletes oldKey from T.
+ * The deletion is logged, and becomes durable on the next syncDBPT.
+ * @param T: a disk-resident B+-tree
+ * @param oldKey: a key to delete
+ */
+void deleteDBPT(DiskTree T, const int oldKey);
+
+/**
+ * searchDBPT returns whether T contains key.
+ * @param T: a disk-resident B+-tree
+ * @param key: a key to search
+ */
+bool searchDBPT(const DiskTree T, const int key);
+
+/**
+ * traverseDBPT implements sequential access in T.
+ * @param T: a disk-resident B+-tree
+ */
+void traverseDBPT(const DiskTree T);
+
+#endif /* _DISKBPLUSTREE_H */
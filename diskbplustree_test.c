@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2020, 9rum. All rights reserved.
+ * Use of this source code is governed by a BSD-style
+ * license that can be found in the LICENSE file.
+ *
+ * File Processing, 2020
+ *
+ * diskbplustree_test.c - disk-resident B+-tree unit test
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "diskbplustree.h"
+
+#define PAGE_SIZE 96
+#define BUDGET    (PAGE_SIZE*64)
+
+int main(void) {
+  const int   testcases[] = {40, 11, 77, 33, 20, 90, 99, 70, 88, 80, 66, 10, 22, 30, 44, 55, 50, 60, 25, 49};
+  const char  *path       = "diskbplustree_test.db",
+              *logPath    = "diskbplustree_test.db.wal";
+  struct stat log;
+  DiskTree    T;
+
+  unlink(path);
+  unlink(logPath);
+
+  T = openDBPT(path, PAGE_SIZE, BUDGET);
+  for (const int *it = testcases; it < testcases + sizeof(testcases)/sizeof(int); ++it) insertDBPT(T, *it);
+  traverseDBPT(T);
+  printf("\n");
+  for (const int *it = testcases; it < testcases + sizeof(testcases)/sizeof(int); it += 2) deleteDBPT(T, *it);
+  traverseDBPT(T);
+  printf("\n");
+  closeDBPT(T);
+
+  T = openDBPT(path, PAGE_SIZE, BUDGET);                                 /* reopens after a clean close */
+  traverseDBPT(T);
+  printf("\n");
+  for (const int *it = testcases; it < testcases + sizeof(testcases)/sizeof(int); ++it) printf("%d", searchDBPT(T, *it));
+  printf("\n");
+  closeDBPT(T);
+
+  unlink(path);
+  unlink(logPath);
+
+  if (fork() == 0) {                                                      /* crashes after syncing every insertion */
+    T = openDBPT(path, PAGE_SIZE, BUDGET);
+    for (const int *it = testcases; it < testcases + sizeof(testcases)/sizeof(int); ++it) insertDBPT(T, *it);
+    syncDBPT(T);
+    _exit(0);
+  }
+  wait(NULL);
+
+  stat(logPath, &log);
+  truncate(logPath, log.st_size-sizeof(LogCommit)/2);                    /* tears the commit record of the last insertion */
+
+  T = openDBPT(path, PAGE_SIZE, BUDGET);                                 /* redoes every insertion but the last */
+  traverseDBPT(T);
+  printf("\n");
+  printf("%d\n", searchDBPT(T, testcases[sizeof(testcases)/sizeof(int)-1]));
+  insertDBPT(T, testcases[sizeof(testcases)/sizeof(int)-1]);
+  closeDBPT(T);
+
+  T = openDBPT(path, PAGE_SIZE, BUDGET);
+  traverseDBPT(T);
+  printf("\n");
+  closeDBPT(T);
+
+  unlink(path);
+  unlink(logPath);
+  /*
+   * gcc -Iinclude diskbplustree_test.c diskbplustree.c bufferpool.c wal.c pagefile.c
+   *
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70 77 80 88 90 99
+   * 10 11 30 33 49 55 60 70 80 90
+   * 10 11 30 33 49 55 60 70 80 90
+   * 01010101010101010101
+   * 10 11 20 22 25 30 33 40 44 50 55 60 66 70 77 80 88 90 99
+   * 0
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70 77 80 88 90 99
+   *
+   */
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2020, 9rum. All rights reserved.
+ * Use of this source code is governed by a BSD-style
+ * license that can be found in the LICENSE file.
+ *
+ * File Processing, 2020
+ *
+ * pool.h - fixed-size object pool implementation
+ *
+ * The pool hands out objects of a single size carved from large slabs,
+ * so allocating an object costs neither a call to malloc nor a malloc header.
+ *
+ * Freed objects are threaded onto an intrusive free list and reused
+ * in LIFO order, and all the objects of the pool are released at once
+ * by freeing its slabs.
+ */
+#ifndef _POOL_H
+#define _POOL_H
+
+#include <stdlib.h>
+#include <stddef.h>
+
+/**
+ * POOL_SLAB_SIZE - the size of each slab in bytes
+ */
+#define POOL_SLAB_SIZE (1 << 16)
+
+/**
+ * struct slab - a chunk of memory objects are carved from
+ *
+ * @next: the pointer to the previously allocated slab
+ *
+ * The objects follow the header, which is padded to the biggest alignment
+ * so that every object in the slab is suitably aligned.
+ */
+struct slab {
+  struct slab *next;
+} __attribute__((aligned(__BIGGEST_ALIGNMENT__)));
+
+/**
+ * struct pool - fixed-size object pool
+ *
+ * @size:  the size of each object
+ * @free:  the head of the intrusive list of freed objects
+ * @slabs: the most recently allocated slab
+ * @next:  the first unused byte of the most recently allocated slab
+ * @end:   the end of the most recently allocated slab
+ */
+struct pool {
+  size_t       size;
+  void        *free;
+  struct slab *slabs;
+  char        *next;
+  char        *end;
+};
+
+/**
+ * pool_init - initializes @pool to hand out objects of @size bytes
+ *
+ * @pool: pool to initialize
+ * @size: the size of each object
+ */
+extern inline void pool_init(struct pool *restrict pool, size_t size) {
+  if (size < sizeof(void *)) size = sizeof(void *);
+  pool->size  = (size + __BIGGEST_ALIGNMENT__ - 1) & ~(size_t)(__BIGGEST_ALIGNMENT__ - 1);
+  pool->free  = NULL;
+  pool->slabs = NULL;
+  pool->next  = NULL;
+  pool->end   = NULL;
+}
+
+/**
+ * pool_alloc - returns an object from @pool
+ *
+ * @pool: pool to allocate an object from
+ */
+extern inline void *pool_alloc(struct pool *restrict pool) {
+  void *object = pool->free;
+
+  if (object != NULL) { pool->free = *(void **)object; return object; }
+
+  if ((size_t)(pool->end - pool->next) < pool->size) {
+    struct slab *slab = aligned_alloc(__BIGGEST_ALIGNMENT__, POOL_SLAB_SIZE);
+    slab->next        = pool->slabs;
+    pool->slabs       = slab;
+    pool->next        = (char *)(slab + 1);
+    pool->end         = (char *)slab + POOL_SLAB_SIZE;
+  }
+
+  object      = pool->next;
+  pool->next += pool->size;
+  return object;
+}
+
+/**
+ * pool_free - returns @object to @pool
+ *
+ * @pool:   pool @object was allocated from
+ * @object: the object to return
+ */
+extern inline void pool_free(struct pool *restrict pool, void *restrict object) {
+  *(void **)object = pool->free;
+  pool->free       = object;
+}
+
+/**
+ * pool_destroy - releases every object of @pool at once
+ *
+ * @pool: pool to release
+ *
+ * The cost is proportional to the number of slabs rather than objects,
+ * so a whole tree whose nodes come from @pool is torn down without walking it.
+ * @pool is left empty and can be reused.
+ */
+extern inline void pool_destroy(struct pool *restrict pool) {
+  register struct slab *slab;
+
+  while (pool->slabs != NULL) {
+    slab        = pool->slabs;
+    pool->slabs = slab->next;
+    free(slab);
+  }
+
+  pool->free = NULL;
+  pool->next = NULL;
+  pool->end  = NULL;
+}
+
+#endif /* _POOL_H */
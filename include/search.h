@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2020, 9rum. All rights reserved.
+ * Use of this source code is governed by a BSD-style
+ * license that can be found in the LICENSE file.
+ *
+ * File Processing, 2020
+ *
+ * search.h - vectorized lower bound over sorted int arrays
+ *
+ * The lower bound narrows the range with a branchless binary search
+ * until it fits in a small window, and then counts the keys less than
+ * the search key in the window with vector compares, so neither step
+ * mispredicts on the outcome of a comparison.
+ *
+ * The vector width is chosen at build time: AVX2 when the compiler targets it
+ * (e.g. -mavx2 or -march=native), SSE2 on any other x86-64 target,
+ * and a plain scalar loop on any other target.
+ */
+#ifndef _SEARCH_H
+#define _SEARCH_H
+
+#include <stddef.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * CACHE_LINE_SIZE - the size of a cache line in bytes
+ */
+#ifndef CACHE_LINE_SIZE
+#define CACHE_LINE_SIZE 64
+#endif
+
+/**
+ * LOWER_BOUND_WINDOW - the size of the window scanned linearly
+ */
+#define LOWER_BOUND_WINDOW 16
+
+/**
+ * lower_bound_window - returns the number of keys less than @key in @K
+ *
+ * @K:   a sorted array
+ * @n:   size of array
+ * @key: a key to search
+ */
+static inline unsigned int lower_bound_window(const int *restrict K, const unsigned int n, const int key) {
+  register unsigned int i     = 0,
+                        count = 0;
+#if defined(__AVX2__)
+  const __m256i k   = _mm256_set1_epi32(key);
+        __m256i sum = _mm256_setzero_si256();
+        __m128i half;
+
+  for (; i+8 <= n; i += 8) sum = _mm256_sub_epi32(sum, _mm256_cmpgt_epi32(k, _mm256_loadu_si256((const __m256i *)&K[i]))); /* each lane counts -1 per key less than key */
+
+  half   = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+  half   = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+  half   = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+  count  = _mm_cvtsi128_si32(half);
+#elif defined(__SSE2__)
+  const __m128i k   = _mm_set1_epi32(key);
+        __m128i sum = _mm_setzero_si128();
+
+  for (; i+4 <= n; i += 4) sum = _mm_sub_epi32(sum, _mm_cmpgt_epi32(k, _mm_loadu_si128((const __m128i *)&K[i])));             /* each lane counts -1 per key less than key */
+
+  sum    = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum    = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+  count  = _mm_cvtsi128_si32(sum);
+#endif
+  for (; i < n; ++i) count += K[i] < key;
+
+  return count;
+}
+
+/**
+ * lower_bound - returns index i where K[i-1] < key <= K[i]
+ *
+ * @K:   a sorted array
+ * @n:   size of array
+ * @key: a key to search
+ */
+static inline unsigned int lower_bound(const int *restrict K, unsigned int n, const int key) {
+  register const int *base = K;
+  register unsigned int half;
+
+  while (LOWER_BOUND_WINDOW < n) {
+    half  = n>>1;
+    base  = base[half] < key ? base+half : base;
+    n    -= half;
+  }
+
+  return base-K+lower_bound_window(base, n, key);
+}
+
+/**
+ * prefetch_range - prefetches @size bytes starting at @addr for reading
+ *
+ * @addr: the start of the range
+ * @size: the size of the range
+ *
+ * Prefetching every cache line of a node up front lets the memory system
+ * fetch them in parallel instead of one by one as the search touches them.
+ *
+ * It is meant to be called on a child once lower_bound has picked it,
+ * so the fetch overlaps the rest of the descent.
+ */
+static inline void prefetch_range(const void *addr, const size_t size) {
+  for (register const char *line = addr, *end = line+size; line < end; line += CACHE_LINE_SIZE) __builtin_prefetch(line, 0, 3);
+}
+
+#endif /* _SEARCH_H */
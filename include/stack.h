@@ -11,10 +11,16 @@
  * - specifically, a LIFO (last-in, first-out) data structure.
  *
  * The stack pushes and pops the element from the top of the stack.
+ *
+ * The path stack is a bounded, array-backed variant of the stack
+ * that lives in automatic storage and never touches the heap.
+ * It is meant for recording root-to-leaf search paths in balanced trees,
+ * whose depth is bounded by the height of the tree.
  */
 #ifndef _STACK_H
 #define _STACK_H
 
+#include <assert.h>
 #include <stdlib.h>
 #include <stdbool.h>
 
@@ -87,4 +93,69 @@ extern inline void destroy(struct stack **restrict stack) {
   }
 }
 
+/**
+ * PATH_STACK_MAX - the capacity of struct path_stack
+ *
+ * The height of a red-black tree with n nodes is at most 2log(n+1)
+ * and that of an AVL tree is less than 1.45log(n+2), so 128 entries
+ * cover any tree that fits in a 64-bit address space with room to spare
+ * for the few extra entries pushed while rebalancing.
+ */
+#define PATH_STACK_MAX 128
+
+/**
+ * struct path_stack - bounded array-backed stack
+ *
+ * @size:  the number of elements
+ * @value: the values of the elements
+ *
+ * The path stack is usually declared as a local variable and initialized
+ * with path_init, so pushing and popping never call malloc and free.
+ */
+struct path_stack {
+  size_t  size;
+  void   *value[PATH_STACK_MAX];
+};
+
+/**
+ * path_init - initializes @stack to be empty
+ *
+ * @stack: stack to initialize
+ */
+extern inline void path_init(struct path_stack *restrict stack) { stack->size = 0; }
+
+/**
+ * path_empty - checks whether @stack is empty
+ *
+ * @stack: stack to check
+ */
+extern inline bool path_empty(const struct path_stack *restrict stack) { return stack->size == 0; }
+
+/**
+ * path_top - accesses the top element
+ *
+ * @stack: stack to access the top element
+ */
+extern inline void *path_top(const struct path_stack *restrict stack) { return path_empty(stack) ? NULL : stack->value[stack->size-1]; }
+
+/**
+ * path_push - inserts element at the top
+ *
+ * @stack: stack to insert element
+ * @value: the value of the element to push
+ *
+ * Pushing onto a full stack is a bug in the caller and fails the assertion.
+ */
+extern inline void path_push(struct path_stack *restrict stack, void *restrict value) {
+  assert(stack->size < PATH_STACK_MAX);
+  stack->value[stack->size++] = value;
+}
+
+/**
+ * path_pop - removes the top element
+ *
+ * @stack: stack to remove the top element
+ */
+extern inline void *path_pop(struct path_stack *restrict stack) { return path_empty(stack) ? NULL : stack->value[--stack->size]; }
+
 #endif /* _STACK_H */
@@ -0,0 +1,339 @@
+/*
+ * Copyright (c) 2020, 9rum. All rights reserved.
+ * Use of this source code is governed by a BSD-style
+ * license that can be found in the LICENSE file.
+ *
+ * File Processing, 2020
+ * olcbplustree.c
+ * Concurrent B+-tree implementation with optimistic lock coupling
+ */
+
+#include <limits.h>
+#include <sched.h>
+#include <stdlib.h>
+
+#include "search.h"
+#include "olcbplustree.h"
+
+#define OLC_LOCKED 2u
+
+/**
+ * getNode returns a new node.
+ * The header, K and P share a single allocation aligned to a cache line.
+ * @param m: fanout of B+-tree
+ * @param level: level of the node, 0 for terminal nodes
+ */
+static inline OlcNode *getNode(const unsigned int m, const unsigned int level) {
+  const size_t  offset  = sizeof(OlcNode)+(sizeof(int)*m+sizeof(void *)-1 & ~(sizeof(void *)-1)),
+                size    = offset+sizeof(void *)*(level == 0 ? 1 : m)+CACHE_LINE_SIZE-1 & ~(size_t)(CACHE_LINE_SIZE-1);
+  OlcNode *node         = aligned_alloc(CACHE_LINE_SIZE, size);
+  atomic_init(&node -> version, 0);
+  node -> n             = 0;
+  node -> level         = level;
+  node -> P             = (OlcNode **)((char *)node+offset);
+  node -> P[0]          = NULL;
+  return node;
+}
+
+/**
+ * count returns the number of keys of x, bounded by its capacity
+ * since x may be read while a writer is modifying it.
+ * @param x: a node
+ * @param m: fanout of B+-tree
+ */
+static inline unsigned int count(const OlcNode *x, const unsigned int m) {
+  register const unsigned int n   = __atomic_load_n(&x -> n, __ATOMIC_RELAXED),
+                              max = x -> level == 0 ? m : m-1;
+  return n < max ? n : max;
+}
+
+/**
+ * child returns the i-th child of internal node x, which may be read while a writer is modifying it.
+ * @param x: an internal node
+ * @param i: index of the child
+ */
+static inline OlcNode *child(const OlcNode *x, const unsigned int i) { return __atomic_load_n(&x -> P[i], __ATOMIC_RELAXED); }
+
+/**
+ * readLock stores the version of x in version and returns whether x is not write-latched.
+ * @param x: a node
+ * @param version: where to store the version
+ */
+static inline bool readLock(OlcNode *x, uint64_t *version) {
+  *version = atomic_load_explicit(&x -> version, memory_order_acquire);
+  return (*version & OLC_LOCKED) == 0;
+}
+
+/**
+ * validate returns whether x is unchanged since its version was read.
+ * @param x: a node
+ * @param version: the version read by readLock
+ */
+static inline bool validate(OlcNode *x, const uint64_t version) {
+  atomic_thread_fence(memory_order_acquire);
+  return atomic_load_explicit(&x -> version, memory_order_relaxed) == version;
+}
+
+/**
+ * upgrade write-latches x if it is unchanged since its version was read, and returns whether it did.
+ * @param x: a node
+ * @param version: the version read by readLock
+ */
+static inline bool upgrade(OlcNode *x, uint64_t version) { return atomic_compare_exchange_strong(&x -> version, &version, version+OLC_LOCKED); }
+
+/**
+ * writeUnlock releases the write latch of x, advancing its version.
+ * @param x: a write-latched node
+ */
+static inline void writeUnlock(OlcNode *x) { atomic_fetch_add_explicit(&x -> version, OLC_LOCKED, memory_order_release); }
+
+/**
+ * backoff yields the processor after repeated restarts.
+ * @param restarts: number of restarts so far
+ */
+static inline void backoff(unsigned int *restarts) { if (8 < ++*restarts) sched_yield(); }
+
+/**
+ * split splits full node x into x and a new right sibling and inserts the separator into parent,
+ * or grows T by a level if x is the root. Both x and parent must be write-latched.
+ * @param T: a concurrent B+-tree
+ * @param parent: the parent of x, or NULL if x is the root
+ * @param x: a full node
+ */
+static void split(OlcTree *T, OlcNode *parent, OlcNode *x) {
+  register const unsigned int m = T -> m;
+  register OlcNode *y           = getNode(m, x -> level);
+  register unsigned int left;
+  register int separator;
+
+  if (x -> level == 0) {
+    left          = m+1>>1;
+    y -> n        = m-left;
+    memcpy(y -> K, &x -> K[left], sizeof(int)*y -> n);
+    y -> P[0]     = x -> P[0];
+    separator     = x -> K[left-1];
+    __atomic_store_n(&x -> P[0], y, __ATOMIC_RELEASE);
+  } else {
+    left          = x -> n>>1;
+    y -> n        = x -> n-left-1;
+    memcpy(y -> K, &x -> K[left+1], sizeof(int)*y -> n);
+    memcpy(y -> P, &x -> P[left+1], sizeof(OlcNode *)*(y -> n+1));
+    separator     = x -> K[left];
+  }
+  __atomic_store_n(&x -> n, left, __ATOMIC_RELAXED);
+
+  if (parent == NULL) {                           /* the level of tree increases */
+    register OlcNode *root  = getNode(m, x -> level+1);
+    root -> K[0]            = separator;
+    root -> P[0]            = x;
+    root -> P[1]            = y;
+    root -> n               = 1;
+    atomic_store(&T -> root, root);
+    return;
+  }
+
+  register const unsigned int i = lower_bound(parent -> K, parent -> n, separator);
+  memmove(&parent -> K[i+1], &parent -> K[i], sizeof(int)*(parent -> n-i));
+  memmove(&parent -> P[i+2], &parent -> P[i+1], sizeof(OlcNode *)*(parent -> n-i));
+  parent -> K[i]    = separator;
+  parent -> P[i+1]  = y;
+  __atomic_store_n(&parent -> n, parent -> n+1, __ATOMIC_RELAXED);
+}
+
+/**
+ * createOLC returns a new empty concurrent B+-tree, or NULL if m is less than 4.
+ * @param m: fanout of B+-tree
+ */
+OlcTree *createOLC(const unsigned int m) {
+  if (m < 4) return NULL;
+
+  OlcTree *T = malloc(sizeof(OlcTree));
+  T -> m     = m;
+  atomic_init(&T -> root, getNode(m, 0));
+  return T;
+}
+
+/**
+ * freeNodes frees the subtree rooted at x.
+ * @param x: a node
+ */
+static void freeNodes(OlcNode *x) {
+  if (x -> level != 0) for (unsigned int i=0; i<=x -> n; ++i) freeNodes(x -> P[i]);
+  free(x);
+}
+
+/**
+ * destroyOLC frees T, which must no longer be shared.
+ * @param T: a concurrent B+-tree
+ */
+void destroyOLC(OlcTree *T) {
+  freeNodes(atomic_load(&T -> root));
+  free(T);
+}
+
+/**
+ * insertOLC inserts newKey into T.
+ * @param T: a concurrent B+-tree
+ * @param newKey: a key to insert
+ */
+void insertOLC(OlcTree *T, const int newKey) {
+  register const unsigned int m = T -> m;
+  register OlcNode  *x,
+                    *parent;
+  register unsigned int i,
+                        n;
+  uint64_t          version,
+                    parentVersion = 0;
+  unsigned int      restarts      = 0;
+
+restart:
+  x       = atomic_load(&T -> root);
+  parent  = NULL;
+  if (!readLock(x, &version) || x != atomic_load(&T -> root)) { backoff(&restarts); goto restart; }
+
+  for (;;) {
+    n = count(x, m);
+
+    if (x -> level == 0 ? n == m : n == m-1) {                                    /* split x eagerly, latching x and its parent */
+      if (parent != NULL && !upgrade(parent, parentVersion))  { backoff(&restarts); goto restart; }
+      if (!upgrade(x, version))                               { if (parent != NULL) writeUnlock(parent); backoff(&restarts); goto restart; }
+      if (parent == NULL && x != atomic_load(&T -> root))     { writeUnlock(x); backoff(&restarts); goto restart; }
+      split(T, parent, x);
+      writeUnlock(x);
+      if (parent != NULL) writeUnlock(parent);
+      goto restart;
+    }
+
+    if (parent != NULL && !validate(parent, parentVersion)) { backoff(&restarts); goto restart; }
+    if (x -> level == 0) break;
+
+    register OlcNode *y = child(x, lower_bound(x -> K, n, newKey));
+    if (!validate(x, version)) { backoff(&restarts); goto restart; }
+
+    parent        = x;
+    parentVersion = version;
+    x             = y;
+    if (!readLock(x, &version)) { backoff(&restarts); goto restart; }
+  }
+
+  if (!upgrade(x, version)) { backoff(&restarts); goto restart; }
+  if (parent != NULL && !validate(parent, parentVersion)) { writeUnlock(x); backoff(&restarts); goto restart; }
+
+  if ((i = lower_bound(x -> K, x -> n, newKey)) == x -> n || newKey != x -> K[i]) {
+    memmove(&x -> K[i+1], &x -> K[i], sizeof(int)*(x -> n-i));
+    x -> K[i] = newKey;
+    __atomic_store_n(&x -> n, x -> n+1, __ATOMIC_RELAXED);
+  }
+  writeUnlock(x);
+}
+
+/**
+ * descend returns the terminal node of T where key belongs, storing its version in version.
+ * It returns NULL if a concurrent write forces a restart.
+ * @param T: a concurrent B+-tree
+ * @param key: a key to search
+ * @param version: where to store the version of the terminal node
+ */
+static OlcNode *descend(OlcTree *T, const int key, uint64_t *version) {
+  register const unsigned int m = T -> m;
+  register OlcNode  *x = atomic_load(&T -> root),
+                    *y;
+  uint64_t          parentVersion;
+
+  if (!readLock(x, version) || x != atomic_load(&T -> root)) return NULL;
+
+  while (x -> level != 0) {
+    y             = child(x, lower_bound(x -> K, count(x, m), key));
+    if (!validate(x, *version)) return NULL;
+    parentVersion = *version;
+    if (!readLock(y, version) || !validate(x, parentVersion)) return NULL;
+    x             = y;
+  }
+
+  return x;
+}
+
+/**
+ * deleteOLC deletes oldKey from T.
+ * @param T: a concurrent B+-tree
+ * @param oldKey: a key to delete
+ */
+void deleteOLC(OlcTree *T, const int oldKey) {
+  register OlcNode *x;
+  register unsigned int i;
+  uint64_t version;
+  unsigned int restarts = 0;
+
+  while ((x = descend(T, oldKey, &version)) == NULL || !upgrade(x, version)) backoff(&restarts);
+
+  if ((i = lower_bound(x -> K, x -> n, oldKey)) < x -> n && oldKey == x -> K[i]) {
+    memmove(&x -> K[i], &x -> K[i+1], sizeof(int)*(x -> n-i-1));
+    __atomic_store_n(&x -> n, x -> n-1, __ATOMIC_RELAXED);
+  }
+  writeUnlock(x);
+}
+
+/**
+ * searchOLC returns whether T contains key.
+ * @param T: a concurrent B+-tree
+ * @param key: a key to search
+ */
+bool searchOLC(OlcTree *T, const int key) {
+  register OlcNode *x;
+  register unsigned int i,
+                        n;
+  register bool found;
+  uint64_t version;
+  unsigned int restarts = 0;
+
+  for (;; backoff(&restarts)) {
+    if ((x = descend(T, key, &version)) == NULL) continue;
+    n     = count(x, T -> m);
+    i     = lower_bound(x -> K, n, key);
+    found = i < n && key == x -> K[i];
+    if (validate(x, version)) return found;
+  }
+}
+
+/**
+ * scanOLC copies up to size keys of T not less than lo into keys in ascending order
+ * and returns the number of keys copied.
+ * Each terminal node is read consistently, but the scan as a whole is not atomic.
+ * @param T: a concurrent B+-tree
+ * @param lo: the lower bound of the range, inclusive
+ * @param keys: a buffer of at least size keys
+ * @param size: size of buffer
+ */
+unsigned int scanOLC(OlcTree *T, const int lo, int *keys, const unsigned int size) {
+  register OlcNode  *x,
+                    *y;
+  register unsigned int copied  = 0,
+                        i,
+                        n,
+                        c;
+  register int      from        = lo;
+  uint64_t          version;
+  unsigned int      restarts    = 0;
+
+  while (copied < size) {
+    if ((x = descend(T, from, &version)) == NULL) { backoff(&restarts); continue; }
+
+    for (;;) {                                                                    /* copy the keys of x, then move on to its right sibling */
+      n = count(x, T -> m);
+      i = lower_bound(x -> K, n, from);
+      c = n-i < size-copied ? n-i : size-copied;
+      memcpy(&keys[copied], &x -> K[i], sizeof(int)*c);
+      y = __atomic_load_n(&x -> P[0], __ATOMIC_ACQUIRE);
+      if (!validate(x, version)) break;                                          /* restart from the last key copied */
+
+      copied += c;
+      if (copied == size || y == NULL || c != 0 && keys[copied-1] == INT_MAX) return copied;
+      if (c != 0) from = keys[copied-1]+1;
+      x = y;
+      if (!readLock(x, &version)) break;
+    }
+    backoff(&restarts);
+  }
+
+  return copied;
+}
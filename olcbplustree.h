@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2020, 9rum. All rights reserved.
+ * Use of this source code is governed by a BSD-style
+ * license that can be found in the LICENSE file.
+ *
+ * File Processing, 2020
+ * olcbplustree.h
+ * Concurrent B+-tree implementation with optimistic lock coupling
+ */
+
+#ifndef _OLCBPLUSTREE_H
+#define _OLCBPLUSTREE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * OlcNode represents a node of concurrent B+-tree.
+ * version holds a write latch in bit 1 and a counter in the bits above it,
+ * which changes on every unlock, so that readers detect concurrent writes by comparing versions.
+ * Terminal nodes have level 0 and link to their right sibling through P[0],
+ * and internal nodes keep their children in P.
+ */
+typedef struct OlcNode {
+  _Atomic uint64_t  version;
+  unsigned int      n;
+  unsigned int      level;
+  struct OlcNode    **P;
+  int               K[];
+} OlcNode;
+
+/**
+ * OlcTree represents a B+-tree shared by threads.
+ * Readers take no latches: they read a node optimistically and validate its version
+ * before trusting what they read, restarting from the root if it changed.
+ * Writers descend the same way, latch only the nodes they modify,
+ * and split full nodes on the way down so that a split latches one node and its parent.
+ * Deletion does not merge nodes, so nodes are never freed while the tree is in use.
+ */
+typedef struct OlcTree {
+  _Atomic(OlcNode *) root;
+  unsigned int       m;
+} OlcTree;
+
+/**
+ * createOLC returns a new empty concurrent B+-tree, or NULL if m is less than 4.
+ * @param m: fanout of B+-tree
+ */
+OlcTree *createOLC(const unsigned int m);
+
+/**
+ * destroyOLC frees T, which must no longer be shared.
+ * @param T: a concurrent B+-tree
+ */
+void destroyOLC(OlcTree *T);
+
+/**
+ * insertOLC inserts newKey into T.
+ * @param T: a concurrent B+-tree
+ * @param newKey: a key to insert
+ */
+void insertOLC(OlcTree *T, const int newKey);
+
+/**
+ * deleteOLC deletes oldKey from T.
+ * @param T: a concurrent B+-tree
+ * @param oldKey: a key to delete
+ */
+void deleteOLC(OlcTree *T, const int oldKey);
+
+/**
+ * searchOLC returns whether T contains key.
+ * @param T: a concurrent B+-tree
+ * @param key: a key to search
+ */
+bool searchOLC(OlcTree *T, const int key);
+
+/**
+ * scanOLC copies up to size keys of T not less than lo into keys in ascending order
+ * and returns the number of keys copied.
+ * Each terminal node is read consistently, but the scan as a whole is not atomic.
+ * @param T: a concurrent B+-tree
+ * @param lo: the lower bound of the range, inclusive
+ * @param keys: a buffer of at least size keys
+ * @param size: size of buffer
+ */
+unsigned int scanOLC(OlcTree *T, const int lo, int *keys, const unsigned int size);
+
+#endif /* _OLCBPLUSTREE_H */
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2020, 9rum. All rights reserved.
+ * Use of this source code is governed by a BSD-style
+ * license that can be found in the LICENSE file.
+ *
+ * File Processing, 2020
+ *
+ * olcbplustree_bench.c - concurrent B+-tree throughput benchmark
+ *
+ * Runs a mix of 90% searchOLC and 10% insertOLC on uniformly random keys
+ * against a preloaded tree, doubling the number of threads up to the one given.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "olcbplustree.h"
+
+#define FANOUT      64
+#define NR_KEYS     (1 << 20)
+#define NR_OPS      (1 << 20)
+#define KEY_RANGE   (NR_KEYS << 1)
+
+static OlcTree *tree;
+
+/**
+ * worker runs NR_OPS operations on tree and returns the number of searches that hit.
+ * @param arg: the seed of the operations
+ */
+static void *worker(void *arg) {
+  unsigned int  seed  = (uintptr_t)arg;
+  uintptr_t     hits  = 0;
+
+  for (unsigned int i=0; i<NR_OPS; ++i) {
+    const int key = rand_r(&seed)%KEY_RANGE;
+
+    if (rand_r(&seed)%10) hits += searchOLC(tree, key);
+    else                  insertOLC(tree, key);
+  }
+
+  return (void *)hits;
+}
+
+static double elapsed(const struct timespec *restrict begin, const struct timespec *restrict end) { return (end->tv_sec-begin->tv_sec)*1e9+(end->tv_nsec-begin->tv_nsec); }
+
+int main(int argc, char **argv) {
+  const unsigned int nr_threads = argc > 1 ? atoi(argv[1]) : 1;
+
+  if (nr_threads == 0) { fprintf(stderr, "usage: %s [threads]\n", argv[0]); return 1; }
+
+  pthread_t *threads = malloc(sizeof(pthread_t)*nr_threads);
+
+  printf("%8s %12s %12s\n", "threads", "Mops/s", "hit rate");
+
+  for (unsigned int n = 1;; n = n<<1 < nr_threads ? n<<1 : nr_threads) {
+    struct timespec begin, end;
+    unsigned long   hits = 0;
+    void            *ret;
+    double          ns;
+
+    tree = createOLC(FANOUT);
+    srand(1);
+    for (unsigned int i=0; i<NR_KEYS; ++i) insertOLC(tree, rand()%KEY_RANGE);
+
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    for (unsigned int i=0; i<n; ++i) pthread_create(&threads[i], NULL, worker, (void *)(uintptr_t)(i+1));
+    for (unsigned int i=0; i<n; ++i) {
+      pthread_join(threads[i], &ret);
+      hits += (uintptr_t)ret;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    ns = elapsed(&begin, &end);
+
+    printf("%8u %12.2f %12.2f\n", n, 1e3*n*NR_OPS/ns, (double)hits/(0.9*n*NR_OPS));
+    destroyOLC(tree);
+    if (n == nr_threads) break;
+  }
+
+  free(threads);
+  /*
+   * gcc -O2 -pthread -Iinclude olcbplustree_bench.c olcbplustree.c (1 core)
+   *
+   * $ ./a.out 8
+   *  threads       Mops/s     hit rate
+   *        1         5.09         0.41
+   *        2         4.64         0.42
+   *        4         4.43         0.45
+   *        8         4.44         0.51
+   *
+   */
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2020, 9rum. All rights reserved.
+ * Use of this source code is governed by a BSD-style
+ * license that can be found in the LICENSE file.
+ *
+ * File Processing, 2020
+ *
+ * olcbplustree_test.c - concurrent B+-tree unit test
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "olcbplustree.h"
+
+#define NR_READERS  3
+#define NR_KEYS     100000
+
+static OlcTree      *tree;
+static atomic_int   inserted;
+
+/**
+ * print prints the keys of T not less than lo.
+ * @param T: a concurrent B+-tree
+ * @param lo: the lower bound of the range, inclusive
+ */
+static void print(OlcTree *T, const int lo) {
+  int           keys[32];
+  unsigned int  n = scanOLC(T, lo, keys, 32);
+
+  for (unsigned int i=0; i<n; ++i) printf("%d ", keys[i]);
+  printf("\n");
+}
+
+/**
+ * reader searches the keys the writer has inserted so far until it has inserted all of them,
+ * and returns the number of searches that missed a key or scans that skipped one.
+ * @param arg: the seed of the keys to search
+ */
+static void *reader(void *arg) {
+  unsigned int  seed  = (uintptr_t)arg;
+  uintptr_t     bad   = 0;
+  int           keys[16],
+                count;
+
+  while ((count = inserted) < NR_KEYS) {
+    if (count == 0) continue;
+
+    const int     lo  = rand_r(&seed)%count;
+    unsigned int  n;
+
+    bad += !searchOLC(tree, count-1) || !searchOLC(tree, lo);
+    n    = scanOLC(tree, lo, keys, 16);                                   /* the keys inserted so far are 0, 1, ... */
+    for (unsigned int i=0; i<n; ++i) bad += keys[i] != lo+(int)i;
+    bad += n < 16 && lo+(int)n < count;
+  }
+
+  return (void *)bad;
+}
+
+int main(void) {
+  const int testcases[] = {40, 11, 77, 33, 20, 90, 99, 70, 88, 80, 66, 10, 22, 30, 44, 55, 50, 60, 25, 49};
+  pthread_t readers[NR_READERS];
+  uintptr_t bad = 0;
+  void      *ret;
+
+  printf("%s\n", createOLC(3) == NULL ? "NULL" : "created");
+
+  tree = createOLC(4);
+  for (const int *it = testcases; it < testcases + sizeof(testcases)/sizeof(int); ++it) insertOLC(tree, *it);
+  print(tree, 0);
+  for (const int *it = testcases; it < testcases + sizeof(testcases)/sizeof(int); it += 2) deleteOLC(tree, *it);
+  print(tree, 0);
+  print(tree, 45);
+  for (const int *it = testcases; it < testcases + sizeof(testcases)/sizeof(int); ++it) printf("%d", searchOLC(tree, *it));
+  printf("\n");
+  destroyOLC(tree);
+
+  tree = createOLC(16);
+  for (unsigned int i=0; i<NR_READERS; ++i) pthread_create(&readers[i], NULL, reader, (void *)(uintptr_t)(i+1));
+  for (int key=0; key<NR_KEYS; ++key) {                                   /* inserts in order while the readers search */
+    insertOLC(tree, key);
+    inserted = key+1;
+  }
+  for (unsigned int i=0; i<NR_READERS; ++i) {
+    pthread_join(readers[i], &ret);
+    bad += (uintptr_t)ret;
+  }
+  printf("%lu\n", (unsigned long)bad);
+  print(tree, NR_KEYS-4);
+  for (int key=0; key<NR_KEYS; ++key) deleteOLC(tree, key);
+  print(tree, 0);
+  destroyOLC(tree);
+  /*
+   * gcc -pthread -Iinclude olcbplustree_test.c olcbplustree.c
+   *
+   * NULL
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70 77 80 88 90 99
+   * 10 11 30 33 49 55 60 70 80 90
+   * 49 55 60 70 80 90
+   * 01010101010101010101
+   * 0
+   * 99996 99997 99998 99999
+   *
+   *
+   */
+}
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2020, 9rum. All rights reserved.
+ * Use of this source code is governed by a BSD-style
+ * license that can be found in the LICENSE file.
+ *
+ * File Processing, 2020
+ * pagefile.c
+ * Page file implementation
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "pagefile.h"
+
+#define PAGE_FILE_MAGIC 0x46505246u /* "FRPF" */
+
+/**
+ * Header represents the header of a page file stored in page 0.
+ */
+typedef struct Header {
+  uint32_t  magic;
+  uint32_t  pageSize;
+  PageId    pageCount;
+  PageId    freeList;
+  uint64_t  meta[PAGE_FILE_META];
+} Header;
+
+/**
+ * readAt reads size bytes at offset of fd into buf, aborting on I/O errors.
+ * A read past the end of file yields zeros.
+ * @param fd: a file descriptor
+ * @param buf: a buffer of at least size bytes
+ * @param size: number of bytes to read
+ * @param offset: offset in file
+ */
+static void readAt(const int fd, void *buf, size_t size, off_t offset) {
+  register ssize_t n;
+
+  while (0 < size) {
+    if ((n = pread(fd, buf, size, offset)) < 0) { perror("pread"); abort(); }
+    if (n == 0) { memset(buf, 0, size); return; }
+    buf     = (char *)buf+n;
+    size   -= n;
+    offset += n;
+  }
+}
+
+/**
+ * writeAt writes size bytes of buf at offset of fd, aborting on I/O errors.
+ * @param fd: a file descriptor
+ * @param buf: a buffer of at least size bytes
+ * @param size: number of bytes to write
+ * @param offset: offset in file
+ */
+static void writeAt(const int fd, const void *buf, size_t size, off_t offset) {
+  register ssize_t n;
+
+  while (0 < size) {
+    if ((n = pwrite(fd, buf, size, offset)) < 0) { perror("pwrite"); abort(); }
+    buf     = (const char *)buf+n;
+    size   -= n;
+    offset += n;
+  }
+}
+
+/**
+ * writeHeader writes back the header of file.
+ * @param file: a page file
+ */
+static void writeHeader(PageFile *file) {
+  Header header = {
+    .magic      = PAGE_FILE_MAGIC,
+    .pageSize   = file -> pageSize,
+    .pageCount  = file -> pageCount,
+    .freeList   = file -> freeList,
+  };
+  memcpy(header.meta, file -> meta, sizeof(header.meta));
+  writeAt(file -> fd, &header, sizeof(Header), 0);
+}
+
+/**
+ * openPageFile opens the page file at path, creating it if it does not exist or is empty.
+ * It returns NULL if the file cannot be opened, is not a page file or was created with another page size.
+ * @param path: path to the file
+ * @param pageSize: size of each page in bytes
+ */
+PageFile *openPageFile(const char *path, const uint32_t pageSize) {
+  if (pageSize < sizeof(Header)) return NULL;
+
+  const int fd = open(path, O_RDWR|O_CREAT, 0644);
+  if (fd < 0) return NULL;
+
+  Header      header;
+  struct stat st;
+
+  if (fstat(fd, &st) < 0) { close(fd); return NULL; }
+  readAt(fd, &header, sizeof(Header), 0);
+
+  if (st.st_size == 0) {                                                  /* case of a new file */
+    header.magic      = PAGE_FILE_MAGIC;
+    header.pageSize   = pageSize;
+    header.pageCount  = 1;
+    header.freeList   = 0;
+    memset(header.meta, 0, sizeof(header.meta));
+  }
+
+  if (header.magic != PAGE_FILE_MAGIC || header.pageSize != pageSize) { close(fd); return NULL; }
+
+  PageFile *file      = malloc(sizeof(PageFile));
+  file -> fd          = fd;
+  file -> pageSize    = pageSize;
+  file -> pageCount   = header.pageCount;
+  file -> freeList    = header.freeList;
+  memcpy(file -> meta, header.meta, sizeof(header.meta));
+  writeHeader(file);
+  return file;
+}
+
+/**
+ * closePageFile writes back the header of file and closes it.
+ * @param file: a page file
+ */
+void closePageFile(PageFile *file) {
+  writeHeader(file);
+  close(file -> fd);
+  free(file);
+}
+
+/**
+ * syncPageFile writes back the header of file and flushes file to stable storage.
+ * @param file: a page file
+ */
+void syncPageFile(PageFile *file) {
+  writeHeader(file);
+  if (fdatasync(file -> fd) < 0) { perror("fdatasync"); abort(); }
+}
+
+/**
+ * readPage reads page id of file into buf.
+ * @param file: a page file
+ * @param id: a page to read
+ * @param buf: a buffer of at least the page size
+ */
+void readPage(PageFile *file, const PageId id, void *buf) { readAt(file -> fd, buf, file -> pageSize, (off_t)id*file -> pageSize); }
+
+/**
+ * writePage writes buf to page id of file.
+ * @param file: a page file
+ * @param id: a page to write
+ * @param buf: a buffer of at least the page size
+ */
+void writePage(PageFile *file, const PageId id, const void *buf) { writeAt(file -> fd, buf, file -> pageSize, (off_t)id*file -> pageSize); }
+
+/**
+ * allocPage returns a free page of file, reusing freed pages first.
+ * @param file: a page file
+ */
+PageId allocPage(PageFile *file) {
+  if (file -> freeList == 0) return file -> pageCount++;
+
+  const PageId id = file -> freeList;
+  readAt(file -> fd, &file -> freeList, sizeof(PageId), (off_t)id*file -> pageSize);
+  return id;
+}
+
+/**
+ * freePage returns page id to the free list of file.
+ * @param file: a page file
+ * @param id: a page to free
+ */
+void freePage(PageFile *file, const PageId id) {
+  writeAt(file -> fd, &file -> freeList, sizeof(PageId), (off_t)id*file -> pageSize);
+  file -> freeList = id;
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2020, 9rum. All rights reserved.
+ * Use of this source code is governed by a BSD-style
+ * license that can be found in the LICENSE file.
+ *
+ * File Processing, 2020
+ * pagefile.h
+ * Page file implementation
+ */
+
+#ifndef _PAGEFILE_H
+#define _PAGEFILE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * PageId identifies a page in a page file.
+ * Page 0 holds the header of the file, so 0 also serves as the null page.
+ */
+typedef uint64_t PageId;
+
+#define PAGE_FILE_META 8
+
+/**
+ * PageFile represents a file of fixed-size pages.
+ * Pages are read and written with pread and pwrite at offsets of the page size,
+ * and freed pages are threaded onto a free list through their first 8 bytes.
+ * meta is preserved in the header for the client of the file.
+ */
+typedef struct PageFile {
+  int           fd;
+  uint32_t      pageSize;
+  PageId        pageCount;
+  PageId        freeList;
+  uint64_t      meta[PAGE_FILE_META];
+} PageFile;
+
+/**
+ * openPageFile opens the page file at path, creating it if it does not exist or is empty.
+ * It returns NULL if the file cannot be opened, is not a page file or was created with another page size.
+ * @param path: path to the file
+ * @param pageSize: size of each page in bytes
+ */
+PageFile *openPageFile(const char *path, const uint32_t pageSize);
+
+/**
+ * closePageFile writes back the header of file and closes it.
+ * @param file: a page file
+ */
+void closePageFile(PageFile *file);
+
+/**
+ * syncPageFile writes back the header of file and flushes file to stable storage.
+ * @param file: a page file
+ */
+void syncPageFile(PageFile *file);
+
+/**
+ * readPage reads page id of file into buf.
+ * @param file: a page file
+ * @param id: a page to read
+ * @param buf: a buffer of at least the page size
+ */
+void readPage(PageFile *file, const PageId id, void *buf);
+
+/**
+ * writePage writes buf to page id of file.
+ * @param file: a page file
+ * @param id: a page to write
+ * @param buf: a buffer of at least the page size
+ */
+void writePage(PageFile *file, const PageId id, const void *buf);
+
+/**
+ * allocPage returns a free page of file, reusing freed pages first.
+ * @param file: a page file
+ */
+PageId allocPage(PageFile *file);
+
+/**
+ * freePage returns page id to the free list of file.
+ * @param file: a page file
+ * @param id: a page to free
+ */
+void freePage(PageFile *file, const PageId id);
+
+#endif /* _PAGEFILE_H */
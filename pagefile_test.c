@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2020, 9rum. All rights reserved.
+ * Use of this source code is governed by a BSD-style
+ * license that can be found in the LICENSE file.
+ *
+ * File Processing, 2020
+ *
+ * pagefile_test.c - page file unit test
+ */
+#include <stdio.h>
+#include <inttypes.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "pagefile.h"
+
+#define PAGE_SIZE 128
+
+int main(void) {
+  const char  *path = "pagefile_test.db";
+  char        page[PAGE_SIZE];
+  PageId      ids[4];
+  PageFile    *file;
+  struct stat st;
+  int         fd;
+
+  unlink(path);
+
+  file = openPageFile(path, PAGE_SIZE);
+  for (unsigned int i=0; i<4; ++i) {
+    ids[i] = allocPage(file);
+    memset(page, 'a'+i, PAGE_SIZE);
+    writePage(file, ids[i], page);
+    printf("%" PRIu64 " ", ids[i]);
+  }
+  printf("\n");
+
+  freePage(file, ids[1]);
+  freePage(file, ids[2]);
+  file -> meta[0] = 42;
+  printf("%" PRIu64 " %" PRIu64 " %" PRIu64 "\n", file -> pageCount, file -> freeList, file -> meta[0]);
+  closePageFile(file);
+
+  file = openPageFile(path, PAGE_SIZE);                                  /* reopens with the header written back */
+  printf("%" PRIu64 " %" PRIu64 " %" PRIu64 "\n", file -> pageCount, file -> freeList, file -> meta[0]);
+  for (unsigned int i=0; i<4; i += 3) {
+    readPage(file, ids[i], page);
+    printf("%c ", page[PAGE_SIZE-1]);
+  }
+  printf("\n");
+  for (unsigned int i=0; i<3; ++i) printf("%" PRIu64 " ", allocPage(file));  /* reuses the freed pages first */
+  printf("\n");
+  closePageFile(file);
+
+  printf("%s\n", openPageFile(path, 2*PAGE_SIZE) == NULL ? "NULL" : "opened");
+  unlink(path);
+
+  memset(page, 0, PAGE_SIZE);                                             /* a file that is not a page file but starts with zeros */
+  page[PAGE_SIZE-1] = 'z';
+  fd = open(path, O_WRONLY|O_CREAT, 0644);
+  if (write(fd, page, PAGE_SIZE) != PAGE_SIZE) return 1;
+  close(fd);
+  printf("%s", openPageFile(path, PAGE_SIZE) == NULL ? "NULL" : "opened");
+  stat(path, &st);
+  fd = open(path, O_RDONLY);
+  if (read(fd, page, PAGE_SIZE) != PAGE_SIZE) return 1;
+  close(fd);
+  printf(" %lld %c\n", (long long)st.st_size, page[PAGE_SIZE-1]);
+  unlink(path);
+  /*
+   * gcc -Iinclude pagefile_test.c pagefile.c
+   *
+   * 1 2 3 4
+   * 5 3 42
+   * 5 3 42
+   * a d
+   * 3 2 5
+   * NULL
+   * NULL 128 z
+   *
+   */
+}
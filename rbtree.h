@@ -23,6 +23,8 @@
 #ifndef _RBTREE_H
 #define _RBTREE_H
 
+#include <stdint.h>
+#include <pool.h>
 #include <stack.h>
 
 /**
@@ -44,6 +46,10 @@
  *  5. Every simple path from a given node to any of its descendant NIL leaves
  *     goes through the same number of black nodes
  *
+ * The color is a field of its own because callers read it and the links directly,
+ * so packing it into the links would change this interface; RB_GENERATE_COMPACT packs it
+ * for trees that only go through the generated accessors.
+ *
  * See https://docs.lib.purdue.edu/cgi/viewcontent.cgi?article=1457&context=cstech
  */
 struct rb_node {
@@ -56,15 +62,25 @@ struct rb_node {
 
 /**
  * rb_get_node - returns a new struct rb_node
+ *
+ * @pool: pool to allocate the node from, or NULL to use malloc
  */
-static inline struct rb_node *rb_get_node(void) {
-  struct rb_node *node = malloc(sizeof(struct rb_node));
+static inline struct rb_node *rb_get_node(struct pool *restrict pool) {
+  struct rb_node *node = pool == NULL ? malloc(sizeof(struct rb_node)) : pool_alloc(pool);
   node->left           = NULL;
   node->right          = NULL;
   node->color          = RED;
   return node;
 }
 
+/**
+ * rb_put_node - releases @node
+ *
+ * @pool: pool @node was allocated from, or NULL if it came from malloc
+ * @node: node to release
+ */
+static inline void rb_put_node(struct pool *restrict pool, struct rb_node *restrict node) { pool == NULL ? free(node) : pool_free(pool, node); }
+
 /**
  * rb_rotate_left - rotates subtree rooted with @node counterclockwise
  *
@@ -115,38 +131,23 @@ static inline void rb_rotate_right(struct rb_node **restrict root, struct rb_nod
  */
 
 /**
- * rb_insert - inserts @key and @value into @tree
+ * rb_insert_fixup - restores the coloring after @walk was linked below the top of @stack
  *
- * @tree:  tree to insert @key and @value into
- * @key:   the key to insert
- * @value: the value to insert
- * @less:  operator defining the (partial) node order
+ * @tree:  tree @walk was linked into
+ * @stack: the search path from the root to the parent of @walk
+ * @walk:  the new node
  */
-extern inline void rb_insert(struct rb_node **restrict tree, const void *restrict key, void *restrict value, bool (*less)(const void *, const void *)) {
-  register struct rb_node *walk  = *tree;
-  register struct rb_node *parent;
-  register struct rb_node *gparent;
-  register struct rb_node *uncle;
-           struct stack   *stack = NULL;
-
-  while (walk != NULL) {
-    if  (!(less(key, walk->key) || less(walk->key, key))) { destroy(&stack); return; }
-    push(&stack, walk);
-    walk = less(key, walk->key) ? walk->left : walk->right;
-  }
-
-  walk        = rb_get_node();
-  walk->key   = key;
-  walk->value = value;
+static inline void rb_insert_fixup(struct rb_node **restrict tree, struct path_stack *restrict stack, register struct rb_node *walk) {
+  register struct rb_node     *parent;
+  register struct rb_node     *gparent;
+  register struct rb_node     *uncle;
 
-  if      ((parent = top(stack)) == NULL) *tree         = walk, walk->color = BLACK;
-  else if (less(key, parent->key))        parent->left  = walk;
-  else                                    parent->right = walk;
+  if (path_empty(stack)) walk->color = BLACK;
 
-  while (!empty(stack)) {
-    if  ((parent = pop(&stack))->color == BLACK) { destroy(&stack); return; }
+  while (!path_empty(stack)) {
+    if  ((parent = path_pop(stack))->color == BLACK) return;
 
-    gparent = pop(&stack);
+    gparent = path_pop(stack);
     uncle   = gparent->right == parent ? gparent->left : gparent->right;
 
     if     (uncle == NULL || uncle->color == BLACK) { /* case of rearranging */
@@ -154,100 +155,278 @@ extern inline void rb_insert(struct rb_node **restrict tree, const void *restric
         if (parent->left == walk) {                   /* case of Left Left */
           parent->color  = BLACK;
           gparent->color = RED;
-          rb_rotate_right(tree, gparent, top(stack));
+          rb_rotate_right(tree, gparent, path_top(stack));
         } else {                                      /* case of Left Right */
           walk->color    = BLACK;
           gparent->color = RED;
           rb_rotate_left(tree, parent, gparent);
-          rb_rotate_right(tree, gparent, top(stack));
+          rb_rotate_right(tree, gparent, path_top(stack));
         }
       } else {
         if (parent->left == walk) {                   /* case of Right Left */
           walk->color    = BLACK;
           gparent->color = RED;
           rb_rotate_right(tree, parent, gparent);
-          rb_rotate_left(tree, gparent, top(stack));
+          rb_rotate_left(tree, gparent, path_top(stack));
         } else {                                      /* case of Right Right */
           parent->color  = BLACK;
           gparent->color = RED;
-          rb_rotate_left(tree, gparent, top(stack));
+          rb_rotate_left(tree, gparent, path_top(stack));
         }
       }
 
-      destroy(&stack);
       return;
     }
 
     parent->color = BLACK;                            /* case of recoloring */
     uncle->color  = BLACK;
     walk          = gparent;
-    walk->color   = empty(stack) ? BLACK : RED;
+    walk->color   = path_empty(stack) ? BLACK : RED;
   }
 }
 
 /**
- * rb_erase - erases @key from @tree
+ * rb_insert_pool - inserts @key and @value into @tree using @pool
  *
- * @tree: tree to erase @key from
- * @key:  the key to erase
- * @less: operator defining the (partial) node order
+ * @tree:  tree to insert @key and @value into
+ * @pool:  pool to allocate the new node from, or NULL to use malloc
+ * @key:   the key to insert
+ * @value: the value to insert
+ * @less:  operator defining the (partial) node order
+ *
+ * Initialize @pool with pool_init(pool, sizeof(struct rb_node)) and use it for every
+ * insertion and erasure of @tree; the whole tree is then released by pool_destroy
+ * in time proportional to the number of slabs, after which @tree must be reset to NULL.
  */
-extern inline void rb_erase(struct rb_node **restrict tree, const void *restrict key, bool (*less)(const void *, const void *)) {
-  register struct rb_node *walk  = *tree;
-  register struct rb_node *parent;
-  register struct rb_node *sibling;
-           struct stack   *stack = NULL;
+extern inline void rb_insert_pool(struct rb_node **restrict tree, struct pool *restrict pool, const void *restrict key, void *restrict value, bool (*less)(const void *, const void *)) {
+  register struct rb_node     *walk = *tree;
+  register struct rb_node     *parent;
+           struct path_stack  stack;
 
-  while (walk != NULL && (less(key, walk->key) || less(walk->key, key))) {
-    push(&stack, walk);
+  path_init(&stack);
+
+  while (walk != NULL) {
+    if  (!(less(key, walk->key) || less(walk->key, key))) return;
+    path_push(&stack, walk);
     walk = less(key, walk->key) ? walk->left : walk->right;
   }
 
-  if (walk == NULL) { destroy(&stack); return; }
+  walk        = rb_get_node(pool);
+  walk->key   = key;
+  walk->value = value;
+
+  if      ((parent = path_top(&stack)) == NULL) *tree         = walk;
+  else if (less(key, parent->key))              parent->left  = walk;
+  else                                          parent->right = walk;
+
+  rb_insert_fixup(tree, &stack, walk);
+}
+
+/**
+ * rb_link - returns the link of @node to its child in direction @dir
+ *
+ * @node: node to return the link of
+ * @dir:  false for the left child, true for the right child
+ */
+static inline struct rb_node **rb_link(struct rb_node *restrict node, const bool dir) { return dir ? &node->right : &node->left; }
+
+/**
+ * rb_is_red - checks whether @node is red, counting NIL leaves as black
+ *
+ * @node: node to check
+ */
+static inline bool rb_is_red(const struct rb_node *restrict node) { return node != NULL && node->color == RED; }
+
+/**
+ * rb_rotate_single - rotates subtree rooted with @node towards @dir and recolors it,
+ * returning the new root of the subtree
+ *
+ * @node: root node of subtree
+ * @dir:  false to rotate clockwise, true to rotate counterclockwise
+ */
+static inline struct rb_node *rb_rotate_single(struct rb_node *restrict node, const bool dir) {
+  struct rb_node *child = *rb_link(node, !dir);
+  *rb_link(node, !dir)  = *rb_link(child, dir);
+  *rb_link(child, dir)  = node;
+  node->color           = RED;
+  child->color          = BLACK;
+  return child;
+}
+
+/**
+ * rb_rotate_double - rotates the child of @node opposite to @dir away from @dir,
+ * and then @node towards @dir, returning the new root of the subtree
+ *
+ * @node: root node of subtree
+ * @dir:  false to end with a clockwise rotation, true to end with a counterclockwise one
+ */
+static inline struct rb_node *rb_rotate_double(struct rb_node *restrict node, const bool dir) {
+  *rb_link(node, !dir) = rb_rotate_single(*rb_link(node, !dir), !dir);
+  return rb_rotate_single(node, dir);
+}
+
+/**
+ * rb_insert_topdown_pool - inserts @key and @value into @tree in a single top-down pass using @pool
+ *
+ * @tree:  tree to insert @key and @value into
+ * @pool:  pool to allocate the new node from, or NULL to use malloc
+ * @key:   the key to insert
+ * @value: the value to insert
+ * @less:  operator defining the (partial) node order
+ *
+ * Every node with two red children is split on the way down, as a 4-node of the
+ * equivalent 2-3-4 tree, and a red violation with its parent is rotated away at once,
+ * so the new node always joins a black parent or a fixable red one and no pass back up is needed.
+ * Only the last four nodes of the search path are kept, and the result is a valid red-black tree
+ * that rb_erase_pool and the other functions accept as is.
+ */
+extern inline void rb_insert_topdown_pool(struct rb_node **restrict tree, struct pool *restrict pool, const void *restrict key, void *restrict value, bool (*less)(const void *, const void *)) {
+  if (*tree == NULL) {
+    *tree          = rb_get_node(pool);
+    (*tree)->key   = key;
+    (*tree)->value = value;
+    (*tree)->color = BLACK;
+    return;
+  }
+
+  struct rb_node           head     = { .left = NULL, .right = *tree, .color = BLACK }; /* false root above the root of @tree */
+  register struct rb_node  *ggparent = &head;
+  register struct rb_node  *gparent  = NULL;
+  register struct rb_node  *parent   = NULL;
+  register struct rb_node  *walk     = *tree;
+  register bool            dir       = true;
+  register bool            last      = true;
+
+  for (;;) {
+    if (walk == NULL) {                                                     /* case of insertion at the bottom */
+      walk        = *rb_link(parent, dir) = rb_get_node(pool);
+      walk->key   = key;
+      walk->value = value;
+    } else if (rb_is_red(walk->left) && rb_is_red(walk->right)) {           /* case of splitting a 4-node */
+      walk->color        = RED;
+      walk->left->color  = BLACK;
+      walk->right->color = BLACK;
+    }
+
+    if (rb_is_red(walk) && rb_is_red(parent)) {                             /* case of rearranging */
+      const bool side = ggparent->right == gparent;
+      *rb_link(ggparent, side) = walk == *rb_link(parent, last) ? rb_rotate_single(gparent, !last) : rb_rotate_double(gparent, !last);
+    }
+
+    if (!(less(key, walk->key) || less(walk->key, key))) break;
+
+    last = dir;
+    dir  = less(walk->key, key);
+
+    if (gparent != NULL) ggparent = gparent;
+    gparent = parent;
+    parent  = walk;
+    walk    = *rb_link(walk, dir);
+  }
+
+  *tree          = head.right;
+  (*tree)->color = BLACK;
+}
+
+/**
+ * rb_build - returns a perfectly balanced subtree holding @n sorted keys
+ *
+ * @pool:   pool to allocate the nodes from, or NULL to use malloc
+ * @keys:   the keys in strictly increasing order
+ * @values: the values of @keys, or NULL to leave every value NULL
+ * @n:      the number of keys
+ * @black:  the number of levels from the root of the subtree that are colored black
+ *
+ * Each node is allocated before its subtrees, so the nodes of a fresh pool
+ * are laid out in preorder and a descent moves forward in memory.
+ */
+static inline struct rb_node *rb_build(struct pool *restrict pool, const void *const *restrict keys, void *const *restrict values, const size_t n, const size_t black) {
+  if (n == 0) return NULL;
+
+  struct rb_node *node = rb_get_node(pool);
+  node->key            = keys[n/2];
+  node->value          = values == NULL ? NULL : values[n/2];
+  node->color          = black == 0 ? RED : BLACK;
+  node->left           = rb_build(pool, keys, values, n/2, black - (black != 0));
+  node->right          = rb_build(pool, keys + n/2 + 1, values == NULL ? NULL : values + n/2 + 1, n - n/2 - 1, black - (black != 0));
+  return node;
+}
+
+/**
+ * rb_build_sorted_pool - builds @tree from @n keys sorted in strictly increasing order in linear time using @pool
+ *
+ * @tree:   tree to build, which must be empty
+ * @pool:   pool to allocate the nodes from, or NULL to use malloc
+ * @keys:   the keys in strictly increasing order
+ * @values: the values of @keys, or NULL to leave every value NULL
+ * @n:      the number of keys
+ *
+ * The tree is split at the median of each range, so every NIL leaf lies at depth ⌊log(n+1)⌋ or one below.
+ * The levels above ⌊log(n+1)⌋ are colored black and the deepest, partial level red,
+ * which gives every path the same black height without any comparison or rotation.
+ */
+extern inline void rb_build_sorted_pool(struct rb_node **restrict tree, struct pool *restrict pool, const void *const *restrict keys, void *const *restrict values, const size_t n) {
+  register size_t black = 0;
+
+  while ((n + 1) >> (black + 1) != 0) black++;
+  *tree = rb_build(pool, keys, values, n, black);
+}
+
+/**
+ * rb_erase_node - erases @walk from @tree using @pool
+ *
+ * @tree:  tree to erase @walk from
+ * @pool:  pool the nodes of @tree were allocated from, or NULL if they came from malloc
+ * @stack: the search path from the root to the parent of @walk
+ * @walk:  the node to erase
+ */
+static inline void rb_erase_node(struct rb_node **restrict tree, struct pool *restrict pool, struct path_stack *restrict stack, register struct rb_node *walk) {
+  register struct rb_node     *parent;
+  register struct rb_node     *sibling;
 
   if (walk->left != NULL && walk->right != NULL) {                    /* case of degree 2 */
     parent = walk;
-    push(&stack, walk);
+    path_push(stack, walk);
 
-    for (walk = walk->left; walk->right != NULL; walk = walk->right) push(&stack, walk);
+    for (walk = walk->left; walk->right != NULL; walk = walk->right) path_push(stack, walk);
 
     parent->key   = walk->key;
     parent->value = walk->value;
   }
 
   if          (walk->left == NULL && walk->right == NULL) {           /* case of degree 0 */
-    if        ((parent = top(stack)) == NULL) *tree         = NULL;
-    else if   (parent->left == walk)          parent->left  = NULL;
-    else                                      parent->right = NULL;
+    if        ((parent = path_top(stack)) == NULL)  *tree         = NULL;
+    else if   (parent->left == walk)                parent->left  = NULL;
+    else                                            parent->right = NULL;
   } else {                                                            /* case of degree 1 */
     if        (walk->left != NULL) {
-      if      ((parent = top(stack)) == NULL) *tree         = walk->left;
-      else if (parent->left == walk)          parent->left  = walk->left;
-      else                                    parent->right = walk->left;
+      if      ((parent = path_top(stack)) == NULL)  *tree         = walk->left;
+      else if (parent->left == walk)                parent->left  = walk->left;
+      else                                          parent->right = walk->left;
     } else {
-      if      ((parent = top(stack)) == NULL) *tree         = walk->right;
-      else if (parent->left == walk)          parent->left  = walk->right;
-      else                                    parent->right = walk->right;
+      if      ((parent = path_top(stack)) == NULL)  *tree         = walk->right;
+      else if (parent->left == walk)                parent->left  = walk->right;
+      else                                          parent->right = walk->right;
     }
   }
 
-  if (walk->color == RED) { free(walk); destroy(&stack); return; }
+  if (walk->color == RED) { rb_put_node(pool, walk); return; }
 
   parent = walk;
   walk   = parent->right == NULL ? parent->left : parent->right;
-  free(parent);
+  rb_put_node(pool, parent);
 
-  if (walk != NULL && walk->color == RED) { walk->color = BLACK; destroy(&stack); return; }
+  if (walk != NULL && walk->color == RED) { walk->color = BLACK; return; }
 
-  while (!empty(stack)) {
-    parent  = pop(&stack);
+  while (!path_empty(stack)) {
+    parent  = path_pop(stack);
     sibling = parent->right == walk ? parent->left : parent->right;
 
     if (sibling->color == RED) {                                      /* case of rearranging */
       sibling->color = BLACK;
       parent->color  = RED;
-      parent->left == walk ? rb_rotate_left(tree, parent, top(stack)) : rb_rotate_right(tree, parent, top(stack));
-      push(&stack, sibling);
+      parent->left == walk ? rb_rotate_left(tree, parent, path_top(stack)) : rb_rotate_right(tree, parent, path_top(stack));
+      path_push(stack, sibling);
       sibling        = parent->right == walk ? parent->left : parent->right;
     }
 
@@ -263,7 +442,7 @@ extern inline void rb_erase(struct rb_node **restrict tree, const void *restrict
         sibling->left->color = BLACK;                                 /* case of Left Left */
         sibling->color       = parent->color;
         parent->color        = BLACK;
-        rb_rotate_right(tree, parent, top(stack));
+        rb_rotate_right(tree, parent, path_top(stack));
       } else {
         if (sibling->left != NULL && sibling->left->color == RED) {   /* case of Right Left */
           sibling->left->color = BLACK;
@@ -274,19 +453,363 @@ extern inline void rb_erase(struct rb_node **restrict tree, const void *restrict
         sibling->right->color = BLACK;                                /* csae of Right Right */
         sibling->color        = parent->color;
         parent->color         = BLACK;
-        rb_rotate_left(tree, parent, top(stack));
+        rb_rotate_left(tree, parent, path_top(stack));
       }
 
-      destroy(&stack);
       return;
     }
 
     sibling->color = RED;                                             /* case of recoloring */
-    if (parent->color == RED) { parent->color = BLACK; destroy(&stack); return; }
+    if (parent->color == RED) { parent->color = BLACK; return; }
     walk           = parent;
   }
 }
 
+/**
+ * rb_erase_pool - erases @key from @tree using @pool
+ *
+ * @tree: tree to erase @key from
+ * @pool: pool the nodes of @tree were allocated from, or NULL if they came from malloc
+ * @key:  the key to erase
+ * @less: operator defining the (partial) node order
+ */
+extern inline void rb_erase_pool(struct rb_node **restrict tree, struct pool *restrict pool, const void *restrict key, bool (*less)(const void *, const void *)) {
+  register struct rb_node     *walk = *tree;
+           struct path_stack  stack;
+
+  path_init(&stack);
+
+  while (walk != NULL && (less(key, walk->key) || less(walk->key, key))) {
+    path_push(&stack, walk);
+    walk = less(key, walk->key) ? walk->left : walk->right;
+  }
+
+  if (walk != NULL) rb_erase_node(tree, pool, &stack, walk);
+}
+
+/**
+ * rb_insert - inserts @key and @value into @tree
+ *
+ * @tree:  tree to insert @key and @value into
+ * @key:   the key to insert
+ * @value: the value to insert
+ * @less:  operator defining the (partial) node order
+ */
+extern inline void rb_insert(struct rb_node **restrict tree, const void *restrict key, void *restrict value, bool (*less)(const void *, const void *)) { rb_insert_pool(tree, NULL, key, value, less); }
+
+/**
+ * rb_insert_topdown - inserts @key and @value into @tree in a single top-down pass
+ *
+ * @tree:  tree to insert @key and @value into
+ * @key:   the key to insert
+ * @value: the value to insert
+ * @less:  operator defining the (partial) node order
+ */
+extern inline void rb_insert_topdown(struct rb_node **restrict tree, const void *restrict key, void *restrict value, bool (*less)(const void *, const void *)) { rb_insert_topdown_pool(tree, NULL, key, value, less); }
+
+/**
+ * rb_build_sorted - builds @tree from @n keys sorted in strictly increasing order in linear time
+ *
+ * @tree:   tree to build, which must be empty
+ * @keys:   the keys in strictly increasing order
+ * @values: the values of @keys, or NULL to leave every value NULL
+ * @n:      the number of keys
+ */
+extern inline void rb_build_sorted(struct rb_node **restrict tree, const void *const *restrict keys, void *const *restrict values, const size_t n) { rb_build_sorted_pool(tree, NULL, keys, values, n); }
+
+/**
+ * rb_erase - erases @key from @tree
+ *
+ * @tree: tree to erase @key from
+ * @key:  the key to erase
+ * @less: operator defining the (partial) node order
+ */
+extern inline void rb_erase(struct rb_node **restrict tree, const void *restrict key, bool (*less)(const void *, const void *)) { rb_erase_pool(tree, NULL, key, less); }
+
+/*
+ * The below functions take a three-way operator instead of less,
+ * so that each node is compared once. The operator denotes:
+ *
+ *    a < b  := cmp(a, b) < 0
+ *    a > b  := cmp(a, b) > 0
+ *    a == b := cmp(a, b) == 0
+ *
+ * and must describe the same ordering as the less the tree was built with, if any.
+ */
+
+/**
+ * rb_search_cmp - returns the node of @tree holding @key, or NULL if there is none
+ *
+ * @tree: tree to search @key in
+ * @key:  the key to search
+ * @cmp:  operator defining the (partial) node order
+ */
+extern inline const struct rb_node *rb_search_cmp(register const struct rb_node *tree, const void *restrict key, int (*cmp)(const void *, const void *)) {
+  register int diff;
+
+  while (tree != NULL && (diff = cmp(key, tree->key)) != 0) tree = diff < 0 ? tree->left : tree->right;
+
+  return tree;
+}
+
+/**
+ * rb_insert_cmp_pool - inserts @key and @value into @tree using @pool
+ *
+ * @tree:  tree to insert @key and @value into
+ * @pool:  pool to allocate the new node from, or NULL to use malloc
+ * @key:   the key to insert
+ * @value: the value to insert
+ * @cmp:   operator defining the (partial) node order
+ */
+extern inline void rb_insert_cmp_pool(struct rb_node **restrict tree, struct pool *restrict pool, const void *restrict key, void *restrict value, int (*cmp)(const void *, const void *)) {
+  register struct rb_node     *walk = *tree;
+  register struct rb_node     *parent;
+  register int                diff  = 0;
+           struct path_stack  stack;
+
+  path_init(&stack);
+
+  while (walk != NULL) {
+    if  ((diff = cmp(key, walk->key)) == 0) return;
+    path_push(&stack, walk);
+    walk = diff < 0 ? walk->left : walk->right;
+  }
+
+  walk        = rb_get_node(pool);
+  walk->key   = key;
+  walk->value = value;
+
+  if      ((parent = path_top(&stack)) == NULL) *tree         = walk;
+  else if (diff < 0)                            parent->left  = walk;
+  else                                          parent->right = walk;
+
+  rb_insert_fixup(tree, &stack, walk);
+}
+
+/**
+ * rb_erase_cmp_pool - erases @key from @tree using @pool
+ *
+ * @tree: tree to erase @key from
+ * @pool: pool the nodes of @tree were allocated from, or NULL if they came from malloc
+ * @key:  the key to erase
+ * @cmp:  operator defining the (partial) node order
+ */
+extern inline void rb_erase_cmp_pool(struct rb_node **restrict tree, struct pool *restrict pool, const void *restrict key, int (*cmp)(const void *, const void *)) {
+  register struct rb_node     *walk = *tree;
+  register int                diff;
+           struct path_stack  stack;
+
+  path_init(&stack);
+
+  while (walk != NULL && (diff = cmp(key, walk->key)) != 0) {
+    path_push(&stack, walk);
+    walk = diff < 0 ? walk->left : walk->right;
+  }
+
+  if (walk != NULL) rb_erase_node(tree, pool, &stack, walk);
+}
+
+/**
+ * rb_insert_cmp - inserts @key and @value into @tree
+ *
+ * @tree:  tree to insert @key and @value into
+ * @key:   the key to insert
+ * @value: the value to insert
+ * @cmp:   operator defining the (partial) node order
+ */
+extern inline void rb_insert_cmp(struct rb_node **restrict tree, const void *restrict key, void *restrict value, int (*cmp)(const void *, const void *)) { rb_insert_cmp_pool(tree, NULL, key, value, cmp); }
+
+/**
+ * rb_erase_cmp - erases @key from @tree
+ *
+ * @tree: tree to erase @key from
+ * @key:  the key to erase
+ * @cmp:  operator defining the (partial) node order
+ */
+extern inline void rb_erase_cmp(struct rb_node **restrict tree, const void *restrict key, int (*cmp)(const void *, const void *)) { rb_erase_cmp_pool(tree, NULL, key, cmp); }
+
+/**
+ * struct rb_root_cached - a red-black tree that caches its first and last nodes
+ *
+ * @root:      the root node of the tree
+ * @leftmost:  the node with the least key, or NULL if the tree is empty
+ * @rightmost: the node with the greatest key, or NULL if the tree is empty
+ *
+ * The cache is kept by rb_insert_cached and rb_erase_cached, so the tree
+ * must not be modified through @root by the other functions.
+ */
+struct rb_root_cached {
+  struct rb_node *root;
+  struct rb_node *leftmost;
+  struct rb_node *rightmost;
+};
+
+/**
+ * RB_ROOT_CACHED - the initializer of an empty struct rb_root_cached
+ */
+#define RB_ROOT_CACHED (struct rb_root_cached) { NULL, NULL, NULL }
+
+/**
+ * rb_first - returns the node of @tree with the least key, or NULL if @tree is empty
+ *
+ * @tree: tree to return the first node of
+ */
+extern inline const struct rb_node *rb_first(const struct rb_root_cached *restrict tree) { return tree->leftmost; }
+
+/**
+ * rb_last - returns the node of @tree with the greatest key, or NULL if @tree is empty
+ *
+ * @tree: tree to return the last node of
+ */
+extern inline const struct rb_node *rb_last(const struct rb_root_cached *restrict tree) { return tree->rightmost; }
+
+/**
+ * rb_insert_cached_pool - inserts @key and @value into @tree using @pool
+ *
+ * @tree:  tree to insert @key and @value into
+ * @pool:  pool to allocate the new node from, or NULL to use malloc
+ * @key:   the key to insert
+ * @value: the value to insert
+ * @less:  operator defining the (partial) node order
+ *
+ * The new node is the first (last) node if the search turned left (right) at every level,
+ * so the cache is kept without another descent.
+ */
+extern inline void rb_insert_cached_pool(struct rb_root_cached *restrict tree, struct pool *restrict pool, const void *restrict key, void *restrict value, bool (*less)(const void *, const void *)) {
+  register struct rb_node     *walk      = tree->root;
+  register struct rb_node     *parent;
+           bool               dir       = false;
+           bool               leftmost  = true;
+           bool               rightmost = true;
+           struct path_stack  stack;
+
+  path_init(&stack);
+
+  while (walk != NULL) {
+    if      (less(key, walk->key)) dir = false, rightmost = false;
+    else if (less(walk->key, key)) dir = true,  leftmost  = false;
+    else                           return;
+    path_push(&stack, walk);
+    walk = *rb_link(walk, dir);
+  }
+
+  walk        = rb_get_node(pool);
+  walk->key   = key;
+  walk->value = value;
+
+  if ((parent = path_top(&stack)) == NULL) tree->root = walk;
+  else                                     *rb_link(parent, dir) = walk;
+
+  if (leftmost)  tree->leftmost  = walk;
+  if (rightmost) tree->rightmost = walk;
+
+  rb_insert_fixup(&tree->root, &stack, walk);
+}
+
+/**
+ * rb_erase_cached_node - erases @walk from @tree using @pool and keeps the cache
+ *
+ * @tree:  tree to erase @walk from
+ * @pool:  pool the nodes of @tree were allocated from, or NULL if they came from malloc
+ * @stack: the search path from the root to the parent of @walk
+ * @walk:  the node to erase
+ *
+ * The first node has no left child, so its successor is the first node of its right subtree,
+ * or else its parent; likewise for the last node. A node with two children is not freed
+ * but takes over the key of its predecessor, which was the first node if it is the only node
+ * of the left subtree.
+ */
+static inline void rb_erase_cached_node(struct rb_root_cached *restrict tree, struct pool *restrict pool, struct path_stack *restrict stack, struct rb_node *restrict walk) {
+  register struct rb_node *next;
+
+  if (walk->left != NULL && walk->right != NULL) {
+    if (walk->left == tree->leftmost && walk->left->right == NULL) tree->leftmost = walk;
+  } else {
+    if (walk == tree->leftmost) {
+      if ((next = walk->right) != NULL) while (next->left != NULL) next = next->left;
+      else                              next = path_top(stack);
+      tree->leftmost = next;
+    }
+    if (walk == tree->rightmost) {
+      if ((next = walk->left) != NULL)  while (next->right != NULL) next = next->right;
+      else                              next = path_top(stack);
+      tree->rightmost = next;
+    }
+  }
+
+  rb_erase_node(&tree->root, pool, stack, walk);
+}
+
+/**
+ * rb_erase_cached_pool - erases @key from @tree using @pool
+ *
+ * @tree: tree to erase @key from
+ * @pool: pool the nodes of @tree were allocated from, or NULL if they came from malloc
+ * @key:  the key to erase
+ * @less: operator defining the (partial) node order
+ */
+extern inline void rb_erase_cached_pool(struct rb_root_cached *restrict tree, struct pool *restrict pool, const void *restrict key, bool (*less)(const void *, const void *)) {
+  register struct rb_node     *walk = tree->root;
+           struct path_stack  stack;
+
+  path_init(&stack);
+
+  while (walk != NULL && (less(key, walk->key) || less(walk->key, key))) {
+    path_push(&stack, walk);
+    walk = less(key, walk->key) ? walk->left : walk->right;
+  }
+
+  if (walk != NULL) rb_erase_cached_node(tree, pool, &stack, walk);
+}
+
+/**
+ * rb_erase_first_pool - erases the first node of @tree using @pool
+ *
+ * @tree: tree to erase the first node of
+ * @pool: pool the nodes of @tree were allocated from, or NULL if they came from malloc
+ *
+ * The path to the first node is the left spine, so no key is compared.
+ * Read the node with rb_first beforehand to pop the least key.
+ */
+extern inline void rb_erase_first_pool(struct rb_root_cached *restrict tree, struct pool *restrict pool) {
+  register struct rb_node     *walk = tree->root;
+           struct path_stack  stack;
+
+  if (walk == NULL) return;
+
+  path_init(&stack);
+
+  for (; walk != tree->leftmost; walk = walk->left) path_push(&stack, walk);
+
+  rb_erase_cached_node(tree, pool, &stack, walk);
+}
+
+/**
+ * rb_insert_cached - inserts @key and @value into @tree
+ *
+ * @tree:  tree to insert @key and @value into
+ * @key:   the key to insert
+ * @value: the value to insert
+ * @less:  operator defining the (partial) node order
+ */
+extern inline void rb_insert_cached(struct rb_root_cached *restrict tree, const void *restrict key, void *restrict value, bool (*less)(const void *, const void *)) { rb_insert_cached_pool(tree, NULL, key, value, less); }
+
+/**
+ * rb_erase_cached - erases @key from @tree
+ *
+ * @tree: tree to erase @key from
+ * @key:  the key to erase
+ * @less: operator defining the (partial) node order
+ */
+extern inline void rb_erase_cached(struct rb_root_cached *restrict tree, const void *restrict key, bool (*less)(const void *, const void *)) { rb_erase_cached_pool(tree, NULL, key, less); }
+
+/**
+ * rb_erase_first - erases the first node of @tree
+ *
+ * @tree: tree to erase the first node of
+ */
+extern inline void rb_erase_first(struct rb_root_cached *restrict tree) { rb_erase_first_pool(tree, NULL); }
+
 /**
  * rb_preorder - applies @func to each node of @tree preorderwise
  *
@@ -311,4 +834,735 @@ extern inline void rb_inorder(const struct rb_node *restrict tree, void (*func)(
  */
 extern inline void rb_postorder(const struct rb_node *restrict tree, void (*func)(const struct rb_node *restrict)) { if (tree != NULL) { rb_postorder(tree->left, func); rb_postorder(tree->right, func); func(tree); } }
 
+/**
+ * struct rb_iter - cursor over the nodes of red-black tree in key order
+ *
+ * @path: the nodes from the root down to the current node, which is on top
+ *
+ * The iterator is usually declared as a local variable and positioned with rb_iter_first,
+ * rb_iter_last or rb_iter_seek, so walking the tree neither recurses nor allocates.
+ * It is invalidated by any insertion or erasure on the tree.
+ */
+struct rb_iter {
+  struct path_stack path;
+};
+
+/**
+ * rb_iter_get - returns the current node of @iter, or NULL if @iter is past either end
+ *
+ * @iter: iterator to access the current node
+ */
+extern inline const struct rb_node *rb_iter_get(const struct rb_iter *restrict iter) { return path_top(&iter->path); }
+
+/**
+ * rb_iter_first - positions @iter at the node with the smallest key of @tree and returns it
+ *
+ * @iter: iterator to position
+ * @tree: tree to iterate over
+ */
+extern inline const struct rb_node *rb_iter_first(struct rb_iter *restrict iter, const struct rb_node *restrict tree) {
+  path_init(&iter->path);
+  for (; tree != NULL; tree = tree->left) path_push(&iter->path, (void *) tree);
+  return rb_iter_get(iter);
+}
+
+/**
+ * rb_iter_last - positions @iter at the node with the largest key of @tree and returns it
+ *
+ * @iter: iterator to position
+ * @tree: tree to iterate over
+ */
+extern inline const struct rb_node *rb_iter_last(struct rb_iter *restrict iter, const struct rb_node *restrict tree) {
+  path_init(&iter->path);
+  for (; tree != NULL; tree = tree->right) path_push(&iter->path, (void *) tree);
+  return rb_iter_get(iter);
+}
+
+/**
+ * rb_iter_next - advances @iter to the in-order successor and returns it, or NULL past the last node
+ *
+ * @iter: iterator positioned at a node
+ */
+extern inline const struct rb_node *rb_iter_next(struct rb_iter *restrict iter) {
+  register const struct rb_node *walk = path_top(&iter->path);
+  register const struct rb_node *child;
+
+  if (walk == NULL) return NULL;
+
+  if (walk->right != NULL) {                                            /* case of leftmost node of right subtree */
+    for (walk = walk->right; walk != NULL; walk = walk->left) path_push(&iter->path, (void *) walk);
+    return rb_iter_get(iter);
+  }
+
+  do    child = path_pop(&iter->path);                                 /* case of nearest ancestor on the right */
+  while ((walk = path_top(&iter->path)) != NULL && walk->right == child);
+  return walk;
+}
+
+/**
+ * rb_iter_prev - moves @iter back to the in-order predecessor and returns it, or NULL before the first node
+ *
+ * @iter: iterator positioned at a node
+ */
+extern inline const struct rb_node *rb_iter_prev(struct rb_iter *restrict iter) {
+  register const struct rb_node *walk = path_top(&iter->path);
+  register const struct rb_node *child;
+
+  if (walk == NULL) return NULL;
+
+  if (walk->left != NULL) {                                             /* case of rightmost node of left subtree */
+    for (walk = walk->left; walk != NULL; walk = walk->right) path_push(&iter->path, (void *) walk);
+    return rb_iter_get(iter);
+  }
+
+  do    child = path_pop(&iter->path);                                 /* case of nearest ancestor on the left */
+  while ((walk = path_top(&iter->path)) != NULL && walk->left == child);
+  return walk;
+}
+
+/**
+ * rb_iter_seek - positions @iter at the first node whose key is not less than @key and returns it,
+ * or NULL if every key of @tree is less than @key
+ *
+ * @iter: iterator to position
+ * @tree: tree to iterate over
+ * @key:  the lower bound to seek, inclusive
+ * @less: operator defining the (partial) node order
+ *
+ * The search path above the result is kept, so rb_iter_prev from the result
+ * moves to the last node whose key is less than @key.
+ */
+extern inline const struct rb_node *rb_iter_seek(struct rb_iter *restrict iter, const struct rb_node *restrict tree, const void *restrict key, bool (*less)(const void *, const void *)) {
+  register size_t size = 0;
+
+  path_init(&iter->path);
+
+  for (; tree != NULL; tree = less(tree->key, key) ? tree->right : tree->left) {
+    path_push(&iter->path, (void *) tree);
+    if (!less(tree->key, key)) size = iter->path.size;                  /* remember the deepest candidate */
+  }
+
+  iter->path.size = size;
+  return rb_iter_get(iter);
+}
+
+/**
+ * rb_finger_climb - pops @path up to the lowest node on it whose subtree holds the position of @key
+ *
+ * @path:  the path from the root to a node whose key is not equal to @key
+ * @key:   the key to find the position of
+ * @less:  operator defining the (partial) node order
+ * @bound: where to store the size of @path up to the nearest ancestor greater than @key, or 0 if none is known;
+ *         NULL if the caller does not need it
+ *
+ * Toward greater keys, the subtree of a node is bounded above by the nearest ancestor it lies to the left of,
+ * so only those ancestors are compared with @key, and likewise toward smaller keys.
+ * The node is popped from @path and returned, and @path is left as the path to its parent.
+ */
+static inline struct rb_node *rb_finger_climb(struct path_stack *restrict path, const void *restrict key, bool (*less)(const void *, const void *), size_t *restrict bound) {
+  register size_t               i     = path->size - 1;
+  register size_t               j;
+  const    bool                 right = less(((struct rb_node *) path->value[i])->key, key);
+  const    struct rb_node       *ancestor;
+
+  if (bound != NULL) *bound = 0;
+
+  for (;; i = j - 1) {
+    for (j = i; j > 0 && *rb_link(path->value[j - 1], !right) != path->value[j]; --j);
+
+    if (j == 0) break;
+
+    ancestor = path->value[j - 1];
+    if (right ? less(key, ancestor->key) : less(ancestor->key, key)) { if (right && bound != NULL) *bound = j; break; }
+  }
+
+  path->size = i;
+  return path->value[i];
+}
+
+/**
+ * rb_finger_seek - positions @finger at the first node whose key is not less than @key and returns it,
+ * or NULL if every key of @tree is less than @key
+ *
+ * @finger: iterator positioned by a previous call or by rb_iter_*; one past either end starts from the root
+ * @tree:   tree to iterate over
+ * @key:    the lower bound to seek, inclusive
+ * @less:   operator defining the (partial) node order
+ *
+ * Behaves as rb_iter_seek, but the search starts from the current node of @finger
+ * and climbs only to the lowest subtree that holds @key, so its cost depends on the height
+ * of that subtree rather than of @tree. Keys close to the current node are usually found in a few steps,
+ * and keys past the last node in one.
+ * @finger must not outlive a modification of @tree through any function but rb_finger_insert.
+ */
+extern inline const struct rb_node *rb_finger_seek(struct rb_iter *restrict finger, const struct rb_node *restrict tree, const void *restrict key, bool (*less)(const void *, const void *)) {
+  register const struct rb_node *walk = rb_iter_get(finger);
+           size_t               size;
+
+  if (walk == NULL) return rb_iter_seek(finger, tree, key, less);
+
+  if (!less(walk->key, key) && !less(key, walk->key)) return walk;
+
+  walk = rb_finger_climb(&finger->path, key, less, &size);
+
+  for (; walk != NULL; walk = less(walk->key, key) ? walk->right : walk->left) {
+    path_push(&finger->path, (void *) walk);
+    if (!less(walk->key, key)) size = finger->path.size;                /* remember the deepest candidate */
+  }
+
+  finger->path.size = size;
+  return rb_iter_get(finger);
+}
+
+/**
+ * rb_finger_insert_pool - inserts @key and @value into @tree using @pool, searching from @finger,
+ * and positions @finger at the node holding @key
+ *
+ * @tree:   tree to insert @key and @value into
+ * @pool:   pool to allocate the new node from, or NULL to use malloc
+ * @finger: iterator positioned by a previous call or by rb_iter_*; one past either end starts from the root
+ * @key:    the key to insert
+ * @value:  the value to insert
+ * @less:   operator defining the (partial) node order
+ *
+ * Returns the node holding @key, which is not replaced if @tree already contained @key.
+ * The search climbs from @finger as in rb_finger_seek, so a key greater than every key of @tree
+ * is placed next to the last node without a descent from the root.
+ * After rebalancing, @finger keeps the part of the path that recoloring did not reach
+ * and descends from there to the new node.
+ */
+extern inline const struct rb_node *rb_finger_insert_pool(struct rb_node **restrict tree, struct pool *restrict pool, struct rb_iter *restrict finger, const void *restrict key, void *restrict value, bool (*less)(const void *, const void *)) {
+  register struct rb_node     *walk = path_top(&finger->path);
+  register struct rb_node     *parent;
+           bool               dir   = false;
+
+  if      (walk == NULL)                                   walk = *tree;
+  else if (!less(walk->key, key) && !less(key, walk->key)) return walk;
+  else                                                     walk = rb_finger_climb(&finger->path, key, less, NULL);
+
+  while (walk != NULL) {
+    if      (less(key, walk->key)) dir = false;
+    else if (less(walk->key, key)) dir = true;
+    else                           { path_push(&finger->path, walk); return walk; }
+    path_push(&finger->path, walk);
+    walk = *rb_link(walk, dir);
+  }
+
+  walk        = rb_get_node(pool);
+  walk->key   = key;
+  walk->value = value;
+
+  if ((parent = path_top(&finger->path)) == NULL) *tree                 = walk;
+  else                                            *rb_link(parent, dir) = walk;
+
+  rb_insert_fixup(tree, &finger->path, walk);
+
+  if ((parent = path_top(&finger->path)) == NULL) parent = *tree;
+  else                                            parent = *rb_link(parent, less(parent->key, key));
+
+  for (; parent != walk; parent = *rb_link(parent, less(parent->key, key))) path_push(&finger->path, parent);
+  path_push(&finger->path, walk);
+
+  return walk;
+}
+
+/**
+ * rb_finger_insert - inserts @key and @value into @tree, searching from @finger,
+ * and positions @finger at the node holding @key
+ *
+ * @tree:   tree to insert @key and @value into
+ * @finger: iterator positioned by a previous call or by rb_iter_*; one past either end starts from the root
+ * @key:    the key to insert
+ * @value:  the value to insert
+ * @less:   operator defining the (partial) node order
+ */
+extern inline const struct rb_node *rb_finger_insert(struct rb_node **restrict tree, struct rb_iter *restrict finger, const void *restrict key, void *restrict value, bool (*less)(const void *, const void *)) { return rb_finger_insert_pool(tree, NULL, finger, key, value, less); }
+
+/**
+ * RB_GENERATE_NODE - defines the node of RB_GENERATE and its accessors
+ */
+#define RB_GENERATE_NODE(name, type)                                                                                       \
+struct name##_node {                                                                                                       \
+  type                      key;                                                                                           \
+  void                      *value;                                                                                        \
+  struct name##_node        *left;                                                                                         \
+  struct name##_node        *right;                                                                                        \
+  unsigned char             color;                                                                                         \
+} __attribute__((aligned(__BIGGEST_ALIGNMENT__)));                                                                         \
+                                                                                                                           \
+static inline struct name##_node *name##_left(const struct name##_node *restrict node) { return node->left; }              \
+                                                                                                                           \
+static inline struct name##_node *name##_right(const struct name##_node *restrict node) { return node->right; }            \
+                                                                                                                           \
+static inline unsigned char name##_color(const struct name##_node *restrict node) { return node->color; }                  \
+                                                                                                                           \
+static inline void name##_set_left(struct name##_node *restrict node, struct name##_node *child) { node->left = child; }   \
+                                                                                                                           \
+static inline void name##_set_right(struct name##_node *restrict node, struct name##_node *child) { node->right = child; } \
+                                                                                                                           \
+static inline void name##_set_color(struct name##_node *restrict node, const unsigned char color) { node->color = color; } \
+                                                                                                                           \
+static inline void name##_augment(struct name##_node *restrict node) { (void) node; }                                      \
+                                                                                                                           \
+static inline struct name##_node *name##_get_node(struct pool *restrict pool) {                                            \
+  struct name##_node *node = pool == NULL ? malloc(sizeof(struct name##_node)) : pool_alloc(pool);                         \
+  node->left               = NULL;                                                                                         \
+  node->right              = NULL;                                                                                         \
+  node->color              = RED;                                                                                          \
+  return node;                                                                                                             \
+}
+
+/**
+ * RB_GENERATE_COMPACT_NODE - defines the node of RB_GENERATE_COMPACT and its accessors
+ *
+ * The color is kept in the lowest bit of the left link, which is always clear in a node address.
+ */
+#define RB_GENERATE_COMPACT_NODE(name, type)                                                                                                              \
+struct name##_node {                                                                                                                                      \
+  type                      key;                                                                                                                          \
+  void                      *value;                                                                                                                       \
+  uintptr_t                 left;                                                                                                                         \
+  uintptr_t                 right;                                                                                                                        \
+} __attribute__((aligned(__BIGGEST_ALIGNMENT__)));                                                                                                        \
+                                                                                                                                                          \
+static inline struct name##_node *name##_left(const struct name##_node *restrict node) { return (struct name##_node *) (node->left & ~(uintptr_t) 1); }   \
+                                                                                                                                                          \
+static inline struct name##_node *name##_right(const struct name##_node *restrict node) { return (struct name##_node *) node->right; }                    \
+                                                                                                                                                          \
+static inline unsigned char name##_color(const struct name##_node *restrict node) { return node->left & 1; }                                              \
+                                                                                                                                                          \
+static inline void name##_set_left(struct name##_node *restrict node, struct name##_node *child) { node->left = (uintptr_t) child | (node->left & 1); }   \
+                                                                                                                                                          \
+static inline void name##_set_right(struct name##_node *restrict node, struct name##_node *child) { node->right = (uintptr_t) child; }                    \
+                                                                                                                                                          \
+static inline void name##_set_color(struct name##_node *restrict node, const unsigned char color) { node->left = (node->left & ~(uintptr_t) 1) | color; } \
+                                                                                                                                                          \
+static inline void name##_augment(struct name##_node *restrict node) { (void) node; }                                                                     \
+                                                                                                                                                          \
+static inline struct name##_node *name##_get_node(struct pool *restrict pool) {                                                                           \
+  struct name##_node *node = pool == NULL ? malloc(sizeof(struct name##_node)) : pool_alloc(pool);                                                        \
+  node->left               = RED;                                                                                                                         \
+  node->right              = 0;                                                                                                                           \
+  return node;                                                                                                                                            \
+}
+
+/**
+ * RB_GENERATE_INTERVAL_NODE - defines the node of RB_GENERATE_INTERVAL and its accessors
+ *
+ * The nodes are ordered by start, then by end, and each keeps in max the greatest end of its subtree,
+ * which name##_augment recomputes from the children.
+ */
+#define RB_GENERATE_INTERVAL_NODE(name, type, less)                                                                                                                                           \
+struct name##_interval {                                                                                                                                                                      \
+  type                      start;                                                                                                                                                            \
+  type                      end;                                                                                                                                                              \
+};                                                                                                                                                                                            \
+                                                                                                                                                                                              \
+struct name##_node {                                                                                                                                                                          \
+  struct name##_interval    key;                                                                                                                                                              \
+  void                      *value;                                                                                                                                                           \
+  struct name##_node        *left;                                                                                                                                                            \
+  struct name##_node        *right;                                                                                                                                                           \
+  type                      max;                                                                                                                                                              \
+  unsigned char             color;                                                                                                                                                            \
+} __attribute__((aligned(__BIGGEST_ALIGNMENT__)));                                                                                                                                            \
+                                                                                                                                                                                              \
+static inline bool name##_interval_less(const struct name##_interval a, const struct name##_interval b) { return less(a.start, b.start) || (!less(b.start, a.start) && less(a.end, b.end)); } \
+                                                                                                                                                                                              \
+static inline struct name##_node *name##_left(const struct name##_node *restrict node) { return node->left; }                                                                                 \
+                                                                                                                                                                                              \
+static inline struct name##_node *name##_right(const struct name##_node *restrict node) { return node->right; }                                                                               \
+                                                                                                                                                                                              \
+static inline unsigned char name##_color(const struct name##_node *restrict node) { return node->color; }                                                                                     \
+                                                                                                                                                                                              \
+static inline void name##_set_left(struct name##_node *restrict node, struct name##_node *child) { node->left = child; }                                                                      \
+                                                                                                                                                                                              \
+static inline void name##_set_right(struct name##_node *restrict node, struct name##_node *child) { node->right = child; }                                                                    \
+                                                                                                                                                                                              \
+static inline void name##_set_color(struct name##_node *restrict node, const unsigned char color) { node->color = color; }                                                                    \
+                                                                                                                                                                                              \
+static inline void name##_augment(struct name##_node *restrict node) {                                                                                                                        \
+  node->max = node->key.end;                                                                                                                                                                  \
+  if (node->left != NULL && less(node->max, node->left->max))   node->max = node->left->max;                                                                                                  \
+  if (node->right != NULL && less(node->max, node->right->max)) node->max = node->right->max;                                                                                                 \
+}                                                                                                                                                                                             \
+                                                                                                                                                                                              \
+static inline struct name##_node *name##_get_node(struct pool *restrict pool) {                                                                                                               \
+  struct name##_node *node = pool == NULL ? malloc(sizeof(struct name##_node)) : pool_alloc(pool);                                                                                            \
+  node->left               = NULL;                                                                                                                                                            \
+  node->right              = NULL;                                                                                                                                                            \
+  node->color              = RED;                                                                                                                                                             \
+  return node;                                                                                                                                                                                \
+}
+
+/**
+ * RB_GENERATE_INTERVAL_QUERY - defines the overlap queries of RB_GENERATE_INTERVAL
+ *
+ * A subtree whose max is not above @lo holds no interval that overlaps [lo, hi),
+ * and neither does a node that starts at or after @hi, nor its right subtree.
+ */
+#define RB_GENERATE_INTERVAL_QUERY(name, type, less)                                                                \
+static inline struct name##_node *name##_overlap_first(struct name##_node *tree, type lo, type hi) {                \
+  while (tree != NULL) {                                                                                            \
+    if      (tree->left != NULL && less(lo, tree->left->max))         tree = tree->left;                            \
+    else if (!less(tree->key.start, hi))                              return NULL;                                  \
+    else if (less(lo, tree->key.end))                                 return tree;                                  \
+    else                                                              tree = tree->right;                           \
+  }                                                                                                                 \
+  return NULL;                                                                                                      \
+}                                                                                                                   \
+                                                                                                                    \
+static inline void name##_overlap(struct name##_node *tree, type lo, type hi, void (*func)(struct name##_node *)) { \
+  while (tree != NULL && less(lo, tree->max)) {                                                                     \
+    name##_overlap(tree->left, lo, hi, func);                                                                       \
+    if (!less(tree->key.start, hi)) return;                                                                         \
+    if (less(lo, tree->key.end))    func(tree);                                                                     \
+    tree = tree->right;                                                                                             \
+  }                                                                                                                 \
+}
+
+/**
+ * RB_GENERATE_RANK_NODE - defines the node of RB_GENERATE_RANK and its accessors
+ *
+ * Each node keeps in size the number of nodes of its subtree, which name##_augment recomputes from the children.
+ */
+#define RB_GENERATE_RANK_NODE(name, type)                                                                                                     \
+struct name##_node {                                                                                                                          \
+  type                      key;                                                                                                              \
+  void                      *value;                                                                                                           \
+  struct name##_node        *left;                                                                                                            \
+  struct name##_node        *right;                                                                                                           \
+  size_t                    size;                                                                                                             \
+  unsigned char             color;                                                                                                            \
+} __attribute__((aligned(__BIGGEST_ALIGNMENT__)));                                                                                            \
+                                                                                                                                              \
+static inline size_t name##_size(const struct name##_node *restrict tree) { return tree == NULL ? 0 : tree->size; }                           \
+                                                                                                                                              \
+static inline struct name##_node *name##_left(const struct name##_node *restrict node) { return node->left; }                                 \
+                                                                                                                                              \
+static inline struct name##_node *name##_right(const struct name##_node *restrict node) { return node->right; }                               \
+                                                                                                                                              \
+static inline unsigned char name##_color(const struct name##_node *restrict node) { return node->color; }                                     \
+                                                                                                                                              \
+static inline void name##_set_left(struct name##_node *restrict node, struct name##_node *child) { node->left = child; }                      \
+                                                                                                                                              \
+static inline void name##_set_right(struct name##_node *restrict node, struct name##_node *child) { node->right = child; }                    \
+                                                                                                                                              \
+static inline void name##_set_color(struct name##_node *restrict node, const unsigned char color) { node->color = color; }                    \
+                                                                                                                                              \
+static inline void name##_augment(struct name##_node *restrict node) { node->size = name##_size(node->left) + name##_size(node->right) + 1; } \
+                                                                                                                                              \
+static inline struct name##_node *name##_get_node(struct pool *restrict pool) {                                                               \
+  struct name##_node *node = pool == NULL ? malloc(sizeof(struct name##_node)) : pool_alloc(pool);                                            \
+  node->left               = NULL;                                                                                                            \
+  node->right              = NULL;                                                                                                            \
+  node->color              = RED;                                                                                                             \
+  return node;                                                                                                                                \
+}
+
+/**
+ * RB_GENERATE_RANK_QUERY - defines the order statistics of RB_GENERATE_RANK
+ *
+ * Both descend a single path, skipping a whole left subtree by its size.
+ */
+#define RB_GENERATE_RANK_QUERY(name, type, less)                                                       \
+static inline struct name##_node *name##_select(struct name##_node *tree, size_t rank) {               \
+  while (tree != NULL) {                                                                               \
+    if      (rank <  name##_size(tree->left)) tree  = tree->left;                                      \
+    else if (rank == name##_size(tree->left)) return tree;                                             \
+    else                                      rank -= name##_size(tree->left) + 1, tree = tree->right; \
+  }                                                                                                    \
+  return NULL;                                                                                         \
+}                                                                                                      \
+                                                                                                       \
+static inline size_t name##_rank(const struct name##_node *tree, type key) {                           \
+  size_t rank = 0;                                                                                     \
+  while (tree != NULL) {                                                                               \
+    if (less(tree->key, key)) rank += name##_size(tree->left) + 1, tree = tree->right;                 \
+    else                      tree  = tree->left;                                                      \
+  }                                                                                                    \
+  return rank;                                                                                         \
+}
+
+/**
+ * RB_GENERATE_BODY - defines the functions of RB_GENERATE over the accessors of the node
+ *
+ * name##_augment is called on every node whose subtree changed, bottom up:
+ * along the search path after a node is linked or unlinked, and on both nodes of a rotation.
+ */
+#define RB_GENERATE_BODY(name, type, less)                                                                                                                                 \
+static inline void name##_put_node(struct pool *restrict pool, struct name##_node *restrict node) { pool == NULL ? free(node) : pool_free(pool, node); }                   \
+                                                                                                                                                                           \
+static inline bool name##_is_red(const struct name##_node *restrict node) { return node != NULL && name##_color(node) == RED; }                                            \
+                                                                                                                                                                           \
+static inline void name##_replace(struct name##_node **restrict root, struct name##_node *restrict parent, struct name##_node *restrict node, struct name##_node *child) { \
+  if      (parent == NULL)                *root = child;                                                                                                                   \
+  else if (name##_left(parent) == node)   name##_set_left(parent, child);                                                                                                  \
+  else                                    name##_set_right(parent, child);                                                                                                 \
+}                                                                                                                                                                          \
+                                                                                                                                                                           \
+static inline void name##_propagate(const struct path_stack *restrict stack) { for (size_t i = stack->size; i-- > 0;) name##_augment(stack->value[i]); }                   \
+                                                                                                                                                                           \
+static inline void name##_rotate_left(struct name##_node **restrict root, struct name##_node *restrict node, struct name##_node *restrict parent) {                        \
+  struct name##_node *rchild = name##_right(node);                                                                                                                         \
+  name##_set_right(node, name##_left(rchild));                                                                                                                             \
+  name##_set_left(rchild, node);                                                                                                                                           \
+  name##_replace(root, parent, node, rchild);                                                                                                                              \
+  name##_augment(node);                                                                                                                                                    \
+  name##_augment(rchild);                                                                                                                                                  \
+}                                                                                                                                                                          \
+                                                                                                                                                                           \
+static inline void name##_rotate_right(struct name##_node **restrict root, struct name##_node *restrict node, struct name##_node *restrict parent) {                       \
+  struct name##_node *lchild = name##_left(node);                                                                                                                          \
+  name##_set_left(node, name##_right(lchild));                                                                                                                             \
+  name##_set_right(lchild, node);                                                                                                                                          \
+  name##_replace(root, parent, node, lchild);                                                                                                                              \
+  name##_augment(node);                                                                                                                                                    \
+  name##_augment(lchild);                                                                                                                                                  \
+}                                                                                                                                                                          \
+                                                                                                                                                                           \
+static inline struct name##_node *name##_search(struct name##_node *tree, type key) {                                                                                      \
+  while (tree != NULL) {                                                                                                                                                   \
+    if      (less(key, tree->key)) tree = name##_left(tree);                                                                                                               \
+    else if (less(tree->key, key)) tree = name##_right(tree);                                                                                                              \
+    else                           return tree;                                                                                                                            \
+  }                                                                                                                                                                        \
+  return NULL;                                                                                                                                                             \
+}                                                                                                                                                                          \
+                                                                                                                                                                           \
+static inline void name##_insert_pool(struct name##_node **restrict tree, struct pool *restrict pool, type key, void *restrict value) {                                    \
+  register struct name##_node *walk = *tree;                                                                                                                               \
+  register struct name##_node *parent;                                                                                                                                     \
+  register struct name##_node *gparent;                                                                                                                                    \
+  register struct name##_node *uncle;                                                                                                                                      \
+           struct path_stack  stack;                                                                                                                                       \
+           bool               dir   = false;                                                                                                                               \
+                                                                                                                                                                           \
+  path_init(&stack);                                                                                                                                                       \
+                                                                                                                                                                           \
+  while (walk != NULL) {                                                                                                                                                   \
+    if      (less(key, walk->key)) dir = false;                                                                                                                            \
+    else if (less(walk->key, key)) dir = true;                                                                                                                             \
+    else                           return;                                                                                                                                 \
+    path_push(&stack, walk);                                                                                                                                               \
+    walk = dir ? name##_right(walk) : name##_left(walk);                                                                                                                   \
+  }                                                                                                                                                                        \
+                                                                                                                                                                           \
+  walk        = name##_get_node(pool);                                                                                                                                     \
+  walk->key   = key;                                                                                                                                                       \
+  walk->value = value;                                                                                                                                                     \
+  name##_augment(walk);                                                                                                                                                    \
+                                                                                                                                                                           \
+  if      ((parent = path_top(&stack)) == NULL) *tree = walk, name##_set_color(walk, BLACK);                                                                               \
+  else if (dir)                                 name##_set_right(parent, walk);                                                                                            \
+  else                                          name##_set_left(parent, walk);                                                                                             \
+                                                                                                                                                                           \
+  name##_propagate(&stack);                                                                                                                                                \
+                                                                                                                                                                           \
+  while (!path_empty(&stack)) {                                                                                                                                            \
+    if  (name##_color(parent = path_pop(&stack)) == BLACK) return;                                                                                                         \
+                                                                                                                                                                           \
+    gparent = path_pop(&stack);                                                                                                                                            \
+    uncle   = name##_right(gparent) == parent ? name##_left(gparent) : name##_right(gparent);                                                                              \
+                                                                                                                                                                           \
+    if     (!name##_is_red(uncle)) {                                                                                                                                       \
+      if   (name##_left(gparent) == parent) {                                                                                                                              \
+        if (name##_left(parent) == walk) {                                                                                                                                 \
+          name##_set_color(parent, BLACK);                                                                                                                                 \
+          name##_set_color(gparent, RED);                                                                                                                                  \
+          name##_rotate_right(tree, gparent, path_top(&stack));                                                                                                            \
+        } else {                                                                                                                                                           \
+          name##_set_color(walk, BLACK);                                                                                                                                   \
+          name##_set_color(gparent, RED);                                                                                                                                  \
+          name##_rotate_left(tree, parent, gparent);                                                                                                                       \
+          name##_rotate_right(tree, gparent, path_top(&stack));                                                                                                            \
+        }                                                                                                                                                                  \
+      } else {                                                                                                                                                             \
+        if (name##_left(parent) == walk) {                                                                                                                                 \
+          name##_set_color(walk, BLACK);                                                                                                                                   \
+          name##_set_color(gparent, RED);                                                                                                                                  \
+          name##_rotate_right(tree, parent, gparent);                                                                                                                      \
+          name##_rotate_left(tree, gparent, path_top(&stack));                                                                                                             \
+        } else {                                                                                                                                                           \
+          name##_set_color(parent, BLACK);                                                                                                                                 \
+          name##_set_color(gparent, RED);                                                                                                                                  \
+          name##_rotate_left(tree, gparent, path_top(&stack));                                                                                                             \
+        }                                                                                                                                                                  \
+      }                                                                                                                                                                    \
+                                                                                                                                                                           \
+      return;                                                                                                                                                              \
+    }                                                                                                                                                                      \
+                                                                                                                                                                           \
+    name##_set_color(parent, BLACK);                                                                                                                                       \
+    name##_set_color(uncle, BLACK);                                                                                                                                        \
+    walk = gparent;                                                                                                                                                        \
+    name##_set_color(walk, path_empty(&stack) ? BLACK : RED);                                                                                                              \
+  }                                                                                                                                                                        \
+}                                                                                                                                                                          \
+                                                                                                                                                                           \
+static inline void name##_erase_pool(struct name##_node **restrict tree, struct pool *restrict pool, type key) {                                                           \
+  register struct name##_node *walk = *tree;                                                                                                                               \
+  register struct name##_node *parent;                                                                                                                                     \
+  register struct name##_node *sibling;                                                                                                                                    \
+  register struct name##_node *child;                                                                                                                                      \
+           struct path_stack  stack;                                                                                                                                       \
+                                                                                                                                                                           \
+  path_init(&stack);                                                                                                                                                       \
+                                                                                                                                                                           \
+  while (walk != NULL) {                                                                                                                                                   \
+    if      (less(key, walk->key)) { path_push(&stack, walk); walk = name##_left(walk); }                                                                                  \
+    else if (less(walk->key, key)) { path_push(&stack, walk); walk = name##_right(walk); }                                                                                 \
+    else                           break;                                                                                                                                  \
+  }                                                                                                                                                                        \
+                                                                                                                                                                           \
+  if (walk == NULL) return;                                                                                                                                                \
+                                                                                                                                                                           \
+  if (name##_left(walk) != NULL && name##_right(walk) != NULL) {                                                                                                           \
+    parent = walk;                                                                                                                                                         \
+    path_push(&stack, walk);                                                                                                                                               \
+                                                                                                                                                                           \
+    for (walk = name##_left(walk); name##_right(walk) != NULL; walk = name##_right(walk)) path_push(&stack, walk);                                                         \
+                                                                                                                                                                           \
+    parent->key   = walk->key;                                                                                                                                             \
+    parent->value = walk->value;                                                                                                                                           \
+  }                                                                                                                                                                        \
+                                                                                                                                                                           \
+  child = name##_left(walk) != NULL ? name##_left(walk) : name##_right(walk);                                                                                              \
+  name##_replace(tree, path_top(&stack), walk, child);                                                                                                                     \
+  name##_propagate(&stack);                                                                                                                                                \
+                                                                                                                                                                           \
+  if (name##_color(walk) == RED) { name##_put_node(pool, walk); return; }                                                                                                  \
+                                                                                                                                                                           \
+  name##_put_node(pool, walk);                                                                                                                                             \
+  walk = child;                                                                                                                                                            \
+                                                                                                                                                                           \
+  if (name##_is_red(walk)) { name##_set_color(walk, BLACK); return; }                                                                                                      \
+                                                                                                                                                                           \
+  while (!path_empty(&stack)) {                                                                                                                                            \
+    parent  = path_pop(&stack);                                                                                                                                            \
+    sibling = name##_right(parent) == walk ? name##_left(parent) : name##_right(parent);                                                                                   \
+                                                                                                                                                                           \
+    if (name##_color(sibling) == RED) {                                                                                                                                    \
+      name##_set_color(sibling, BLACK);                                                                                                                                    \
+      name##_set_color(parent, RED);                                                                                                                                       \
+      name##_left(parent) == walk ? name##_rotate_left(tree, parent, path_top(&stack)) : name##_rotate_right(tree, parent, path_top(&stack));                              \
+      path_push(&stack, sibling);                                                                                                                                          \
+      sibling = name##_right(parent) == walk ? name##_left(parent) : name##_right(parent);                                                                                 \
+    }                                                                                                                                                                      \
+                                                                                                                                                                           \
+    if     (name##_is_red(name##_left(sibling)) || name##_is_red(name##_right(sibling))) {                                                                                 \
+      if   (name##_left(parent) == sibling) {                                                                                                                              \
+        if (name##_is_red(name##_right(sibling))) {                                                                                                                        \
+          name##_set_color(name##_right(sibling), BLACK);                                                                                                                  \
+          name##_set_color(sibling, RED);                                                                                                                                  \
+          name##_rotate_left(tree, sibling, parent);                                                                                                                       \
+          sibling = name##_left(parent);                                                                                                                                   \
+        }                                                                                                                                                                  \
+        name##_set_color(name##_left(sibling), BLACK);                                                                                                                     \
+        name##_set_color(sibling, name##_color(parent));                                                                                                                   \
+        name##_set_color(parent, BLACK);                                                                                                                                   \
+        name##_rotate_right(tree, parent, path_top(&stack));                                                                                                               \
+      } else {                                                                                                                                                             \
+        if (name##_is_red(name##_left(sibling))) {                                                                                                                         \
+          name##_set_color(name##_left(sibling), BLACK);                                                                                                                   \
+          name##_set_color(sibling, RED);                                                                                                                                  \
+          name##_rotate_right(tree, sibling, parent);                                                                                                                      \
+          sibling = name##_right(parent);                                                                                                                                  \
+        }                                                                                                                                                                  \
+        name##_set_color(name##_right(sibling), BLACK);                                                                                                                    \
+        name##_set_color(sibling, name##_color(parent));                                                                                                                   \
+        name##_set_color(parent, BLACK);                                                                                                                                   \
+        name##_rotate_left(tree, parent, path_top(&stack));                                                                                                                \
+      }                                                                                                                                                                    \
+                                                                                                                                                                           \
+      return;                                                                                                                                                              \
+    }                                                                                                                                                                      \
+                                                                                                                                                                           \
+    name##_set_color(sibling, RED);                                                                                                                                        \
+    if (name##_color(parent) == RED) { name##_set_color(parent, BLACK); return; }                                                                                          \
+    walk = parent;                                                                                                                                                         \
+  }                                                                                                                                                                        \
+}                                                                                                                                                                          \
+                                                                                                                                                                           \
+static inline void name##_insert(struct name##_node **restrict tree, type key, void *restrict value) { name##_insert_pool(tree, NULL, key, value); }                       \
+                                                                                                                                                                           \
+static inline void name##_erase(struct name##_node **restrict tree, type key) { name##_erase_pool(tree, NULL, key); }
+
+/**
+ * RB_GENERATE - defines a red-black tree specialized for keys of @type
+ *
+ * @name: the prefix of the generated node type and functions
+ * @type: the type of the keys, which are stored by value in the nodes
+ * @less: function or function-like macro on two values of @type defining the (partial) node order
+ *
+ * Defines struct name##_node along with name##_search, name##_insert_pool, name##_insert,
+ * name##_erase_pool and name##_erase, which behave as their generic counterparts
+ * except that keys are passed by value and @less is called directly,
+ * so a comparison costs neither an indirect call nor a dereference and can be inlined.
+ * name##_search returns the node holding the key, or NULL if there is none.
+ * A node is descended by at most two comparisons, and none are repeated to link a new node.
+ * The generated nodes do not keep subtree sizes; RB_GENERATE_RANK generates the order statistics.
+ *
+ * The links of a node are read by name##_left and name##_right rather than directly,
+ * so the same code walks the nodes of RB_GENERATE_COMPACT.
+ *
+ * Expand it once per translation unit at file scope, e.g.
+ *
+ *    #define int_less(a, b) ((a) < (b))
+ *    RB_GENERATE(rb_int, int, int_less)
+ */
+#define RB_GENERATE(name, type, less) RB_GENERATE_NODE(name, type) RB_GENERATE_BODY(name, type, less)
+
+/**
+ * RB_GENERATE_COMPACT - defines a red-black tree specialized for keys of @type with packed colors
+ *
+ * @name: the prefix of the generated node type and functions
+ * @type: the type of the keys, which are stored by value in the nodes
+ * @less: function or function-like macro on two values of @type defining the (partial) node order
+ *
+ * Generates the same functions as RB_GENERATE, but the color of a node is packed into its left link
+ * instead of a field of its own, so a node with a key of up to 8 bytes takes 32 bytes rather than 48
+ * on x86-64. The links are only valid through name##_left and name##_right.
+ */
+#define RB_GENERATE_COMPACT(name, type, less) RB_GENERATE_COMPACT_NODE(name, type) RB_GENERATE_BODY(name, type, less)
+
+/**
+ * RB_GENERATE_INTERVAL - defines an interval tree of [start, end) intervals with endpoints of @type
+ *
+ * @name: the prefix of the generated node type and functions
+ * @type: the type of the endpoints
+ * @less: function or function-like macro on two values of @type defining the (partial) endpoint order
+ *
+ * Generates the functions of RB_GENERATE keyed by struct name##_interval, so several intervals
+ * may share a start, and in addition:
+ *
+ *  - name##_overlap_first(tree, lo, hi) returns the node overlapping [lo, hi) with the least key,
+ *    or NULL if there is none, in O(log n) time
+ *  - name##_overlap(tree, lo, hi, func) calls func on every node overlapping [lo, hi) in order,
+ *    descending only into subtrees that may hold one, in O(log n + k) time for k such nodes
+ *    when the intervals are disjoint, as the extents of a file are
+ *
+ * A stabbing query for a point p is an overlap query for [p, p + 1).
+ */
+#define RB_GENERATE_INTERVAL(name, type, less) RB_GENERATE_INTERVAL_NODE(name, type, less) RB_GENERATE_BODY(name, struct name##_interval, name##_interval_less) RB_GENERATE_INTERVAL_QUERY(name, type, less)
+
+/**
+ * RB_GENERATE_RANK - defines a red-black tree specialized for keys of @type with order statistics
+ *
+ * @name: the prefix of the generated node type and functions
+ * @type: the type of the keys, which are stored by value in the nodes
+ * @less: function or function-like macro on two values of @type defining the (partial) node order
+ *
+ * Generates the functions of RB_GENERATE over nodes that also record the size of their subtree, and in addition:
+ *
+ *  - name##_size(tree) returns the number of nodes of tree in O(1) time
+ *  - name##_select(tree, rank) returns the node with the rank-th smallest key counting from 0,
+ *    or NULL if tree has no more than rank nodes, in O(log n) time
+ *  - name##_rank(tree, key) returns the number of nodes whose key is less than key in O(log n) time
+ *
+ * Keeping the sizes makes every insertion and erasure touch the whole search path,
+ * so use RB_GENERATE when the order statistics are not needed.
+ */
+#define RB_GENERATE_RANK(name, type, less) RB_GENERATE_RANK_NODE(name, type) RB_GENERATE_BODY(name, type, less) RB_GENERATE_RANK_QUERY(name, type, less)
+
 #endif /* _RBTREE_H */
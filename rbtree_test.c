@@ -16,10 +16,123 @@ bool less(const void *a, const void *b) { return *(uintptr_t *)a < *(uintptr_t *
 
 void print(const struct rb_node *restrict node) { printf(node->color == BLACK ? "\033[01;30m%" PRIuPTR "\033[00m " : "\033[01;31m%" PRIuPTR "\033[00m ", *(uintptr_t *)node->key); }
 
+void print_key(const struct rb_node *restrict node) { if (node == NULL) printf("NULL "); else print(node); }
+
+int black_height(const struct rb_node *restrict node) {
+  int left, right;
+
+  if (node == NULL) return 0;
+  left  = black_height(node->left);
+  right = black_height(node->right);
+  if (left < 0 || left != right)                                                                                                  return -1;
+  if (node->color == RED && (node->left != NULL && node->left->color == RED || node->right != NULL && node->right->color == RED)) return -1;
+  return left + (node->color == BLACK);
+}
+
+size_t check_cached(const struct rb_root_cached *restrict tree) {
+  struct rb_iter iter;
+
+  return (rb_first(tree) != rb_iter_first(&iter, tree->root)) + (rb_last(tree) != rb_iter_last(&iter, tree->root)) + (black_height(tree->root) < 0);
+}
+
+uintptr_t numbers[1 << 10];
+
+const void *keys[1 << 10];
+
+#define key_less(a, b) ((a) < (b))
+
+RB_GENERATE(rb_gen, uintptr_t, key_less)
+RB_GENERATE_COMPACT(rb_compact, uintptr_t, key_less)
+
+#define GENERATE_CHECK(name)                                                                                                  \
+void name##_print(const struct name##_node *restrict tree) {                                                                  \
+  if (tree != NULL) {                                                                                                         \
+    name##_print(name##_left(tree));                                                                                          \
+    printf(name##_color(tree) == BLACK ? "\033[01;30m%" PRIuPTR "\033[00m " : "\033[01;31m%" PRIuPTR "\033[00m ", tree->key); \
+    name##_print(name##_right(tree));                                                                                         \
+  }                                                                                                                           \
+}                                                                                                                             \
+                                                                                                                              \
+int name##_black_height(const struct name##_node *restrict tree) {                                                            \
+  int left, right;                                                                                                            \
+                                                                                                                              \
+  if (tree == NULL) return 0;                                                                                                 \
+  left  = name##_black_height(name##_left(tree));                                                                             \
+  right = name##_black_height(name##_right(tree));                                                                            \
+  if (left < 0 || left != right)                                                                              return -1;      \
+  if (name##_color(tree) == RED && (name##_is_red(name##_left(tree)) || name##_is_red(name##_right(tree)))) return -1;        \
+  return left + (name##_color(tree) == BLACK);                                                                                \
+}                                                                                                                             \
+                                                                                                                              \
+size_t name##_disorder(const struct name##_node *restrict tree, const uintptr_t lo, const uintptr_t hi) {                     \
+  if (tree == NULL) return 0;                                                                                                 \
+  return (tree->key < lo || hi <= tree->key) + name##_disorder(name##_left(tree), lo, tree->key)                              \
+                                            + name##_disorder(name##_right(tree), tree->key + 1, hi);                         \
+}
+
+GENERATE_CHECK(rb_gen)
+GENERATE_CHECK(rb_compact)
+
+RB_GENERATE_INTERVAL(rb_extent, uintptr_t, key_less)
+
+void print_extent(struct rb_extent_node *node) { printf("[%" PRIuPTR ", %" PRIuPTR ") ", node->key.start, node->key.end); }
+
+void print_extent_key(struct rb_extent_node *node) { if (node == NULL) printf("NULL "); else print_extent(node); }
+
+uintptr_t rb_extent_check(const struct rb_extent_node *restrict node, size_t *restrict bad) {
+  uintptr_t max;
+
+  if (node == NULL) return 0;
+  max   = node->key.end;
+  if (max < rb_extent_check(node->left, bad))  max = node->left->max;
+  if (max < rb_extent_check(node->right, bad)) max = node->right->max;
+  *bad += node->max != max;
+  return max;
+}
+
+RB_GENERATE_RANK(rb_rank, uintptr_t, key_less)
+
+size_t rb_rank_check(const struct rb_rank_node *restrict node, size_t *restrict bad) {
+  size_t size;
+
+  if (node == NULL) return 0;
+  size  = rb_rank_check(node->left, bad) + rb_rank_check(node->right, bad) + 1;
+  *bad += node->size != size;
+  return size;
+}
+
+void rb_rank_print(struct rb_rank_node *tree) {
+  for (size_t i = 0; i <= rb_rank_size(tree); ++i) {
+    const struct rb_rank_node *node = rb_rank_select(tree, i);
+
+    if (node == NULL) printf("NULL "); else printf("%" PRIuPTR " ", node->key);
+  }
+  printf("\n");
+}
+
 int main(void) {
   const uintptr_t testcases[] = {40, 11, 77, 33, 20, 90, 99, 70, 88, 80, 66, 10, 22, 30, 44, 55, 50, 60, 25, 49};
+  const uintptr_t increasing[] = {10, 11, 20, 22, 25, 30, 33, 40, 44, 49, 50, 55, 60, 66, 70, 77, 80, 88, 90, 99};
 
-  struct rb_node *tree = NULL;
+  const uintptr_t absent      = 45;
+  const uintptr_t below       = 5;
+  const uintptr_t beyond      = 100;
+  const size_t    sizes[]     = {0, 1, 2, 3, 4, 7, 8, 15, 16, 1023, 1024};
+  const struct rb_extent_interval extents[] = {{10, 20}, {20, 30}, {15, 25}, {30, 40}, {5, 50}, {22, 23}, {40, 45}, {60, 70}, {10, 12}};
+  const struct rb_extent_interval queries[] = {{20, 30}, {20, 21}, {45, 60}, {50, 60}, {0, 5}, {70, 80}, {12, 15}, {0, 100}};
+
+  struct rb_node         *tree = NULL;
+  struct rb_rank_node    *rank = NULL;
+  struct rb_gen_node     *gen  = NULL;
+  struct rb_compact_node *compact = NULL;
+  struct rb_root_cached  cached  = RB_ROOT_CACHED;
+  struct rb_extent_node  *extent = NULL;
+  struct rb_iter         iter;
+  struct rb_iter         finger;
+  struct pool            pool;
+  const char             *next;
+  const struct rb_node   *walk;
+  size_t                 bad;
 
   for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); ++it) {
     rb_insert(&tree, it, NULL, less);
@@ -41,6 +154,254 @@ int main(void) {
     rb_inorder(tree, print);
     printf("\n");
   }
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); ++it) {
+    rb_insert_topdown(&tree, it, NULL, less);
+    rb_inorder(tree, print);
+    printf("\n");
+  }
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); ++it) {
+    rb_erase(&tree, it, less);
+    rb_inorder(tree, print);
+    printf("\n");
+  }
+
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); ++it) rb_insert(&tree, it, NULL, less);
+  for (const struct rb_node *node = rb_iter_first(&iter, tree); node != NULL; node = rb_iter_next(&iter)) print(node);
+  print_key(rb_iter_get(&iter));
+  print_key(rb_iter_next(&iter));
+  printf("\n");
+  for (const struct rb_node *node = rb_iter_last(&iter, tree); node != NULL; node = rb_iter_prev(&iter)) print(node);
+  print_key(rb_iter_get(&iter));
+  print_key(rb_iter_prev(&iter));
+  printf("\n");
+  print_key(rb_iter_seek(&iter, tree, &testcases[12], less));            /* seeks a present key */
+  print_key(rb_iter_next(&iter));
+  print_key(rb_iter_next(&iter));
+  print_key(rb_iter_seek(&iter, tree, &absent, less));
+  print_key(rb_iter_prev(&iter));
+  print_key(rb_iter_seek(&iter, tree, &below, less));
+  print_key(rb_iter_prev(&iter));
+  print_key(rb_iter_seek(&iter, tree, &testcases[6], less));             /* seeks the last key */
+  print_key(rb_iter_next(&iter));
+  print_key(rb_iter_seek(&iter, tree, &beyond, less));                   /* seeks past the end */
+  print_key(rb_iter_next(&iter));
+  print_key(rb_iter_prev(&iter));
+  printf("\n");
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); ++it) rb_erase(&tree, it, less);
+  print_key(rb_iter_first(&iter, tree));
+  print_key(rb_iter_last(&iter, tree));
+  print_key(rb_iter_seek(&iter, tree, &below, less));
+  printf("\n");
+
+  rb_iter_first(&finger, tree);                                          /* past the end of the empty tree */
+  for (const uintptr_t *it = increasing; it < increasing + sizeof(increasing)/sizeof(uintptr_t); ++it) {
+    rb_finger_insert(&tree, &finger, it, NULL, less);
+    rb_inorder(tree, print);
+    printf("\n");
+  }
+  rb_preorder(tree, print);
+  printf("\n");
+  print_key(rb_iter_get(&finger));
+  print_key(rb_finger_insert(&tree, &finger, &absent, NULL, less));
+  print_key(rb_iter_next(&finger));
+  print_key(rb_iter_prev(&finger));
+  print_key(rb_iter_prev(&finger));
+  printf("\n");
+  print_key(rb_finger_seek(&finger, tree, &testcases[12], less));        /* seeks backwards */
+  print_key(rb_finger_seek(&finger, tree, &below, less));
+  print_key(rb_iter_prev(&finger));
+  printf("\n");
+  print_key(rb_finger_seek(&finger, tree, &beyond, less));               /* moves past the end */
+  print_key(rb_finger_seek(&finger, tree, &testcases[17], less));
+  print_key(rb_iter_next(&finger));
+  print_key(rb_finger_seek(&finger, tree, &beyond, less));
+  print_key(rb_finger_insert(&tree, &finger, &beyond, NULL, less));
+  print_key(rb_iter_next(&finger));
+  print_key(rb_finger_insert(&tree, &finger, &below, NULL, less));
+  print_key(rb_iter_prev(&finger));
+  printf("\n");
+  rb_inorder(tree, print);
+  printf("\n");
+  for (const uintptr_t *it = increasing; it < increasing + sizeof(increasing)/sizeof(uintptr_t); ++it) rb_erase(&tree, it, less);
+  rb_erase(&tree, &absent, less);
+  rb_erase(&tree, &below, less);
+  rb_erase(&tree, &beyond, less);
+
+  pool_init(&pool, sizeof(struct rb_node));
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); ++it) rb_insert_pool(&tree, &pool, it, NULL, less);
+  next = pool.next;
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); it += 2) rb_erase_pool(&tree, &pool, it, less);
+  rb_inorder(tree, print);
+  printf("\n");
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); it += 2) rb_insert_pool(&tree, &pool, it, NULL, less);
+  rb_inorder(tree, print);
+  printf("\n");
+  printf("%d %d\n", pool.next == next, pool.free == NULL);                   /* reuses every erased node before carving a new one */
+  pool_destroy(&pool);
+  tree = NULL;
+
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); ++it) rb_rank_insert(&rank, *it, NULL);
+  rb_rank_print(rank);
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); it += 2) {
+    rb_rank_erase(&rank, *it);
+    bad = 0;
+    rb_rank_check(rank, &bad);
+    for (size_t i = 0; i < rb_rank_size(rank); ++i) bad += rb_rank_rank(rank, rb_rank_select(rank, i)->key) != i;
+    printf("%zu %zu\n", rb_rank_size(rank), bad);
+  }
+  rb_rank_print(rank);
+  rb_rank_insert(&rank, absent, NULL);
+  rb_rank_insert(&rank, beyond, NULL);
+  rb_rank_insert(&rank, testcases[1], NULL);                             /* is already there */
+  rb_rank_print(rank);
+  printf("%zu %zu %zu %zu %zu\n", rb_rank_rank(rank, below), rb_rank_rank(rank, testcases[2]), rb_rank_rank(rank, absent), rb_rank_rank(rank, 46), rb_rank_rank(rank, 1000));
+  for (const uintptr_t *it = increasing; it < increasing + sizeof(increasing)/sizeof(uintptr_t); ++it) rb_rank_erase(&rank, *it);
+  rb_rank_print(rank);
+  rb_rank_erase(&rank, absent);
+  rb_rank_erase(&rank, beyond);
+  printf("%zu %s\n", rb_rank_size(rank), rb_rank_select(rank, 0) == NULL ? "NULL" : "not empty");
+
+  for (size_t i = 0; i < sizeof(keys)/sizeof(void *); ++i) numbers[i] = 2*i, keys[i] = &numbers[i];
+  for (const size_t *n = sizes; n < sizes + sizeof(sizes)/sizeof(size_t); ++n) {
+    rb_build_sorted(&tree, keys, NULL, *n);
+    bad  = tree != NULL && tree->color == RED;
+    walk = rb_iter_first(&iter, tree);
+    for (size_t i = 0; i < *n; ++i, walk = rb_iter_next(&iter)) bad += walk == NULL || walk->key != keys[i];
+    bad += walk != NULL;
+    printf("%zu %d %zu", *n, black_height(tree), bad);
+    for (size_t i = 1; i < *n; i += 2) rb_erase(&tree, keys[i], less);
+    printf(" %d", black_height(tree));
+    for (size_t i = 0; i < *n; i += 2) rb_erase(&tree, keys[i], less);
+    printf(" %s\n", tree == NULL ? "NULL" : "not empty");
+  }
+
+  bad = 0;
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); ++it) {
+    rb_gen_insert(&gen, *it, NULL);
+    rb_gen_print(gen);
+    printf("\n");
+    bad += rb_gen_is_red(gen) || rb_gen_black_height(gen) < 0;
+  }
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); ++it) {
+    rb_gen_erase(&gen, *it);
+    rb_gen_print(gen);
+    printf("\n");
+    bad += rb_gen_is_red(gen) || rb_gen_black_height(gen) < 0;
+  }
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); ++it) {
+    rb_gen_insert(&gen, *it, NULL);
+    rb_gen_print(gen);
+    printf("\n");
+    bad += rb_gen_is_red(gen) || rb_gen_black_height(gen) < 0;
+  }
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); ++it) printf("%d", rb_gen_search(gen, *it) != NULL && rb_gen_search(gen, *it)->key == *it);
+  printf(" %d%d%d\n", rb_gen_search(gen, absent) != NULL, rb_gen_search(gen, below) != NULL, rb_gen_search(gen, beyond) != NULL);
+  for (const uintptr_t *it = testcases + sizeof(testcases)/sizeof(uintptr_t) - 1; testcases <= it; --it) {
+    rb_gen_erase(&gen, *it);
+    rb_gen_print(gen);
+    printf("\n");
+    bad += rb_gen_is_red(gen) || rb_gen_black_height(gen) < 0;
+  }
+  printf("%zu %s\n", bad, gen == NULL ? "NULL" : "not empty");
+
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); ++it) rb_compact_insert(&compact, *it, NULL);
+  rb_compact_print(compact);
+  printf("\n");
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); it += 2) rb_compact_erase(&compact, *it);
+  rb_compact_print(compact);
+  printf("\n");
+  for (const uintptr_t *it = testcases+1; it < testcases + sizeof(testcases)/sizeof(uintptr_t); it += 2) rb_compact_erase(&compact, *it);
+  for (size_t i = 0; i < sizeof(numbers)/sizeof(uintptr_t); ++i) rb_compact_insert(&compact, numbers[i*7919 % (sizeof(numbers)/sizeof(uintptr_t))], NULL);
+  bad = rb_compact_is_red(compact) + rb_compact_disorder(compact, 0, UINTPTR_MAX);
+  for (size_t i = 0; i < sizeof(numbers)/sizeof(uintptr_t); ++i) bad += rb_compact_search(compact, numbers[i]) == NULL;
+  bad += rb_compact_search(compact, numbers[sizeof(numbers)/sizeof(uintptr_t) - 1] + 1) != NULL;
+  printf("%zu %d %zu", sizeof(numbers)/sizeof(uintptr_t), rb_compact_black_height(compact), bad);
+  for (size_t i = 1; i < sizeof(numbers)/sizeof(uintptr_t); i += 2) rb_compact_erase(&compact, numbers[i]);
+  bad = rb_compact_is_red(compact) + rb_compact_disorder(compact, 0, UINTPTR_MAX);
+  for (size_t i = 0; i < sizeof(numbers)/sizeof(uintptr_t); ++i) bad += (rb_compact_search(compact, numbers[i]) == NULL) != (i % 2 == 1);
+  printf(" %d %zu", rb_compact_black_height(compact), bad);
+  for (size_t i = 0; i < sizeof(numbers)/sizeof(uintptr_t); i += 2) rb_compact_erase(&compact, numbers[i]);
+  printf(" %s\n", compact == NULL ? "NULL" : "not empty");
+
+  print_key(rb_first(&cached));
+  print_key(rb_last(&cached));
+  printf("\n");
+  bad = 0;
+  for (const uintptr_t *it = testcases; it < testcases + sizeof(testcases)/sizeof(uintptr_t); ++it) {
+    rb_insert_cached(&cached, it, NULL, less);
+    print_key(rb_first(&cached));
+    print_key(rb_last(&cached));
+    bad += check_cached(&cached);
+  }
+  printf("\n");
+  for (int i = 0; i < 5; ++i) {                                          /* erases the last node */
+    rb_erase_cached(&cached, rb_last(&cached)->key, less);
+    print_key(rb_last(&cached));
+    bad += check_cached(&cached);
+  }
+  printf("\n");
+  for (int i = 0; i < 5; ++i) {                                          /* erases the first node */
+    rb_erase_cached(&cached, rb_first(&cached)->key, less);
+    print_key(rb_first(&cached));
+    bad += check_cached(&cached);
+  }
+  printf("\n");
+  for (const uintptr_t *it = testcases+1; it < testcases + sizeof(testcases)/sizeof(uintptr_t); it += 2) {
+    rb_erase_cached(&cached, it, less);
+    print_key(rb_first(&cached));
+    print_key(rb_last(&cached));
+    bad += check_cached(&cached);
+  }
+  printf("\n");
+  while (rb_first(&cached) != NULL) {
+    rb_erase_first(&cached);
+    print_key(rb_first(&cached));
+    bad += check_cached(&cached);
+  }
+  printf("\n");
+  rb_insert_cached(&cached, &increasing[2], NULL, less);
+  rb_insert_cached(&cached, &increasing[0], NULL, less);
+  rb_insert_cached(&cached, &increasing[5], NULL, less);
+  rb_erase_cached(&cached, &increasing[2], less);                         /* takes over the key of the first node */
+  print_key(rb_first(&cached));
+  print_key(rb_last(&cached));
+  bad += check_cached(&cached);
+  rb_erase_first(&cached);
+  print_key(rb_first(&cached));
+  print_key(rb_last(&cached));
+  bad += check_cached(&cached);
+  rb_erase_first(&cached);
+  printf("\n");
+  rb_erase_first(&cached);
+  rb_erase_cached(&cached, &absent, less);
+  print_key(rb_first(&cached));
+  print_key(rb_last(&cached));
+  printf("%zu %s\n", bad, cached.root == NULL ? "NULL" : "not empty");
+
+  for (const struct rb_extent_interval *it = extents; it < extents + sizeof(extents)/sizeof(struct rb_extent_interval); ++it) rb_extent_insert(&extent, *it, NULL);
+  for (const struct rb_extent_interval *it = queries; it < queries + sizeof(queries)/sizeof(struct rb_extent_interval); ++it) {
+    print_extent_key(rb_extent_overlap_first(extent, it->start, it->end));
+    printf("| ");
+    rb_extent_overlap(extent, it->start, it->end, print_extent);
+    printf("\n");
+  }
+  bad = 0;
+  rb_extent_check(extent, &bad);
+  printf("%" PRIuPTR " %zu\n", extent->max, bad);
+  for (const struct rb_extent_interval *it = extents + 4; it < extents + sizeof(extents)/sizeof(struct rb_extent_interval); ++it) {
+    rb_extent_erase(&extent, *it);                                       /* erases the widest interval first */
+    rb_extent_check(extent, &bad);
+    printf("%" PRIuPTR " ", extent == NULL ? 0 : extent->max);
+  }
+  printf("%zu\n", bad);
+  for (const struct rb_extent_interval *it = queries; it < queries + 3; ++it) {
+    print_extent_key(rb_extent_overlap_first(extent, it->start, it->end));
+    printf("| ");
+    rb_extent_overlap(extent, it->start, it->end, print_extent);
+    printf("\n");
+  }
+  for (const struct rb_extent_interval *it = extents; it < extents + 4; ++it) rb_extent_erase(&extent, *it);
+  printf("%s %s\n", extent == NULL ? "NULL" : "not empty", rb_extent_overlap_first(extent, 0, 100) == NULL ? "NULL" : "found");
   /*
    * 40
    * 11 40
@@ -122,5 +483,221 @@ int main(void) {
    * 11 40
    * 40
    *
+   * 40
+   * 11 40
+   * 11 40 77
+   * 11 33 40 77
+   * 11 20 33 40 77
+   * 11 20 33 40 77 90
+   * 11 20 33 40 77 90 99
+   * 11 20 33 40 70 77 90 99
+   * 11 20 33 40 70 77 88 90 99
+   * 11 20 33 40 70 77 80 88 90 99
+   * 11 20 33 40 66 70 77 80 88 90 99
+   * 10 11 20 33 40 66 70 77 80 88 90 99
+   * 10 11 20 22 33 40 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 44 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 44 55 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 44 50 55 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 44 50 55 60 66 70 77 80 88 90 99
+   * 10 11 20 22 25 30 33 40 44 50 55 60 66 70 77 80 88 90 99
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70 77 80 88 90 99
+   *
+   * 10 11 20 22 25 30 33 44 49 50 55 60 66 70 77 80 88 90 99
+   * 10 20 22 25 30 33 44 49 50 55 60 66 70 77 80 88 90 99
+   * 10 20 22 25 30 33 44 49 50 55 60 66 70 80 88 90 99
+   * 10 20 22 25 30 44 49 50 55 60 66 70 80 88 90 99
+   * 10 22 25 30 44 49 50 55 60 66 70 80 88 90 99
+   * 10 22 25 30 44 49 50 55 60 66 70 80 88 99
+   * 10 22 25 30 44 49 50 55 60 66 70 80 88
+   * 10 22 25 30 44 49 50 55 60 66 80 88
+   * 10 22 25 30 44 49 50 55 60 66 80
+   * 10 22 25 30 44 49 50 55 60 66
+   * 10 22 25 30 44 49 50 55 60
+   * 22 25 30 44 49 50 55 60
+   * 25 30 44 49 50 55 60
+   * 25 44 49 50 55 60
+   * 25 49 50 55 60
+   * 25 49 50 60
+   * 25 49 60
+   * 25 49
+   * 49
+   *
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70 77 80 88 90 99 NULL NULL
+   * 99 90 88 80 77 70 66 60 55 50 49 44 40 33 30 25 22 20 11 10 NULL NULL
+   * 22 25 30 49 44 10 NULL 99 NULL NULL NULL NULL
+   * NULL NULL NULL
+   *
+   * 10
+   * 10 11
+   * 10 11 20
+   * 10 11 20 22
+   * 10 11 20 22 25
+   * 10 11 20 22 25 30
+   * 10 11 20 22 25 30 33
+   * 10 11 20 22 25 30 33 40
+   * 10 11 20 22 25 30 33 40 44
+   * 10 11 20 22 25 30 33 40 44 49
+   * 10 11 20 22 25 30 33 40 44 49 50
+   * 10 11 20 22 25 30 33 40 44 49 50 55
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70 77
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70 77 80
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70 77 80 88
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70 77 80 88 90
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70 77 80 88 90 99
+   * 40 22 11 10 20 30 25 33 55 49 44 50 77 66 60 70 88 80 90 99
+   * 99 45 49 45 44
+   * 22 10 NULL
+   * NULL 60 66 NULL 100 NULL 5 NULL
+   * 5 10 11 20 22 25 30 33 40 44 45 49 50 55 60 66 70 77 80 88 90 99 100
+   *
+   * 10 11 30 33 49 55 60 70 80 90
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70 77 80 88 90 99
+   * 1 1
+   *
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70 77 80 88 90 99 NULL
+   * 19 0
+   * 18 0
+   * 17 0
+   * 16 0
+   * 15 0
+   * 14 0
+   * 13 0
+   * 12 0
+   * 11 0
+   * 10 0
+   * 10 11 30 33 49 55 60 70 80 90 NULL
+   * 10 11 30 33 45 49 55 60 70 80 90 100 NULL
+   * 0 9 4 5 12
+   * 45 100 NULL
+   * 0 NULL
+   *
+   * 0 0 0 0 NULL
+   * 1 1 0 1 NULL
+   * 2 1 0 1 NULL
+   * 3 2 0 1 NULL
+   * 4 2 0 1 NULL
+   * 7 3 0 2 NULL
+   * 8 3 0 2 NULL
+   * 15 4 0 3 NULL
+   * 16 4 0 3 NULL
+   * 1023 10 0 9 NULL
+   * 1024 10 0 9 NULL
+   *
+   * 40
+   * 11 40
+   * 11 40 77
+   * 11 33 40 77
+   * 11 20 33 40 77
+   * 11 20 33 40 77 90
+   * 11 20 33 40 77 90 99
+   * 11 20 33 40 70 77 90 99
+   * 11 20 33 40 70 77 88 90 99
+   * 11 20 33 40 70 77 80 88 90 99
+   * 11 20 33 40 66 70 77 80 88 90 99
+   * 10 11 20 33 40 66 70 77 80 88 90 99
+   * 10 11 20 22 33 40 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 44 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 44 55 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 44 50 55 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 44 50 55 60 66 70 77 80 88 90 99
+   * 10 11 20 22 25 30 33 40 44 50 55 60 66 70 77 80 88 90 99
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70 77 80 88 90 99
+   * 10 11 20 22 25 30 33 44 49 50 55 60 66 70 77 80 88 90 99
+   * 10 20 22 25 30 33 44 49 50 55 60 66 70 77 80 88 90 99
+   * 10 20 22 25 30 33 44 49 50 55 60 66 70 80 88 90 99
+   * 10 20 22 25 30 44 49 50 55 60 66 70 80 88 90 99
+   * 10 22 25 30 44 49 50 55 60 66 70 80 88 90 99
+   * 10 22 25 30 44 49 50 55 60 66 70 80 88 99
+   * 10 22 25 30 44 49 50 55 60 66 70 80 88
+   * 10 22 25 30 44 49 50 55 60 66 80 88
+   * 10 22 25 30 44 49 50 55 60 66 80
+   * 10 22 25 30 44 49 50 55 60 66
+   * 10 22 25 30 44 49 50 55 60
+   * 22 25 30 44 49 50 55 60
+   * 25 30 44 49 50 55 60
+   * 25 44 49 50 55 60
+   * 25 49 50 55 60
+   * 25 49 50 60
+   * 25 49 60
+   * 25 49
+   * 49
+   *
+   * 40
+   * 11 40
+   * 11 40 77
+   * 11 33 40 77
+   * 11 20 33 40 77
+   * 11 20 33 40 77 90
+   * 11 20 33 40 77 90 99
+   * 11 20 33 40 70 77 90 99
+   * 11 20 33 40 70 77 88 90 99
+   * 11 20 33 40 70 77 80 88 90 99
+   * 11 20 33 40 66 70 77 80 88 90 99
+   * 10 11 20 33 40 66 70 77 80 88 90 99
+   * 10 11 20 22 33 40 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 44 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 44 55 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 44 50 55 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 44 50 55 60 66 70 77 80 88 90 99
+   * 10 11 20 22 25 30 33 40 44 50 55 60 66 70 77 80 88 90 99
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70 77 80 88 90 99
+   * 11111111111111111111 000
+   * 10 11 20 22 25 30 33 40 44 50 55 60 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 44 50 55 60 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 44 50 55 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 44 55 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 44 66 70 77 80 88 90 99
+   * 10 11 20 22 30 33 40 66 70 77 80 88 90 99
+   * 10 11 20 22 33 40 66 70 77 80 88 90 99
+   * 10 11 20 33 40 66 70 77 80 88 90 99
+   * 11 20 33 40 66 70 77 80 88 90 99
+   * 11 20 33 40 70 77 80 88 90 99
+   * 11 20 33 40 70 77 88 90 99
+   * 11 20 33 40 70 77 90 99
+   * 11 20 33 40 77 90 99
+   * 11 20 33 40 77 90
+   * 11 20 33 40 77
+   * 11 33 40 77
+   * 11 40 77
+   * 11 40
+   * 40
+   *
+   * 0 NULL
+   *
+   * 10 11 20 22 25 30 33 40 44 49 50 55 60 66 70 77 80 88 90 99
+   * 10 11 30 33 49 55 60 70 80 90
+   * 1024 7 0 7 0 NULL
+   *
+   * NULL NULL
+   * 40 40 11 40 11 77 11 77 11 77 11 90 11 99 11 99 11 99 11 99 11 99 10 99 10 99 10 99 10 99 10 99 10 99 10 99 10 99 10 99
+   * 90 88 80 77 70
+   * 11 20 22 25 30
+   * 30 70 30 70 30 70 30 66 30 66 30 66 40 66 40 66 40 66 40 66
+   * 44 50 66 NULL
+   * 10 30 30 30
+   * NULL NULL 0 NULL
+   *
+   * [5, 50) | [5, 50) [15, 25) [20, 30) [22, 23)
+   * [5, 50) | [5, 50) [15, 25) [20, 30)
+   * [5, 50) | [5, 50)
+   * NULL |
+   * NULL |
+   * NULL |
+   * [5, 50) | [5, 50) [10, 20)
+   * [5, 50) | [5, 50) [10, 12) [10, 20) [15, 25) [20, 30) [22, 23) [30, 40) [40, 45) [60, 70)
+   * 70 0
+   * 70 70 70 40 40 0
+   * [15, 25) | [15, 25) [20, 30)
+   * [15, 25) | [15, 25) [20, 30)
+   * NULL |
+   * NULL NULL
+   *
    */
 }
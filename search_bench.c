@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2020, 9rum. All rights reserved.
+ * Use of this source code is governed by a BSD-style
+ * license that can be found in the LICENSE file.
+ *
+ * File Processing, 2020
+ *
+ * search_bench.c - intra-node key search microbenchmark
+ *
+ * Compares the branchy binary search formerly used by btree.c and bplustree.c
+ * with lower_bound from search.h on a node of m-1 keys for each fanout m.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "search.h"
+
+#define NR_QUERIES (1 << 22)
+
+/**
+ * binarySearch returns index i where K[i-1] < key <= K[i].
+ * @param K: an array
+ * @param n: size of array
+ * @param key: a key to search
+ */
+static unsigned int binarySearch(const int *K, const unsigned int n, const int key) {
+  register int  i = 0,
+                j = n-1;
+  register unsigned int mid;
+
+  while (i <= j) {
+    mid = i+j>>1;
+    if (key == K[mid])  return mid;
+    if (key < K[mid])   j = mid-1;
+    else                i = mid+1;
+  }
+
+  return i;
+}
+
+static __attribute__((noinline)) unsigned int scalar(const int *K, const unsigned int n, const int key) { return binarySearch(K, n, key); }
+
+static __attribute__((noinline)) unsigned int vector(const int *K, const unsigned int n, const int key) { return lower_bound(K, n, key); }
+
+static double elapsed(const struct timespec *restrict begin, const struct timespec *restrict end) { return (end->tv_sec-begin->tv_sec)*1e9+(end->tv_nsec-begin->tv_nsec); }
+
+int main(void) {
+  const unsigned int fanouts[] = {4, 8, 16, 32, 64, 128, 256, 512, 1024};
+
+  int *queries = malloc(sizeof(int)*NR_QUERIES);
+
+  printf("%6s %12s %12s %8s\n", "m", "binary (ns)", "lower (ns)", "speedup");
+
+  for (const unsigned int *m = fanouts; m < fanouts + sizeof(fanouts)/sizeof(unsigned int); ++m) {
+    const unsigned int n = *m-1;
+    int *K = malloc(sizeof(int)*n);
+
+    srand(*m);
+    for (unsigned int i=0; i<n; ++i) K[i] = (i ? K[i-1] : 0)+1+rand()%8;
+    for (unsigned int i=0; i<NR_QUERIES; ++i) queries[i] = rand()%(K[n-1]+2);
+
+    struct timespec begin, end;
+    unsigned long   checksum[2] = {0, 0};
+    double          ns[2];
+
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    for (unsigned int i=0; i<NR_QUERIES; ++i) checksum[0] += scalar(K, n, queries[i]);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    ns[0] = elapsed(&begin, &end)/NR_QUERIES;
+
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    for (unsigned int i=0; i<NR_QUERIES; ++i) checksum[1] += vector(K, n, queries[i]);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    ns[1] = elapsed(&begin, &end)/NR_QUERIES;
+
+    if (checksum[0] != checksum[1]) { fprintf(stderr, "m=%u: results differ\n", *m); return 1; }
+
+    printf("%6u %12.2f %12.2f %7.2fx\n", *m, ns[0], ns[1], ns[0]/ns[1]);
+    free(K);
+  }
+
+  free(queries);
+  /*
+   * gcc -O2 -Iinclude search_bench.c (SSE2)
+   *
+   *      m  binary (ns)   lower (ns)  speedup
+   *      4        16.01         8.35    1.92x
+   *      8        22.94         6.41    3.58x
+   *     16        30.60        10.76    2.84x
+   *     32        42.71         9.28    4.60x
+   *     64        48.27        10.20    4.73x
+   *    128        60.07         9.92    6.05x
+   *    256        67.86        15.08    4.50x
+   *    512        82.39        13.87    5.94x
+   *   1024        89.43        12.57    7.11x
+   *
+   * gcc -O2 -mavx2 -Iinclude search_bench.c (AVX2)
+   *
+   *      m  binary (ns)   lower (ns)  speedup
+   *      4        16.40         7.16    2.29x
+   *      8        23.14         9.40    2.46x
+   *     16        32.12        11.40    2.82x
+   *     32        41.82         8.80    4.75x
+   *     64        50.97         9.78    5.21x
+   *    128        63.85         8.35    7.64x
+   *    256        69.43        10.95    6.34x
+   *    512        75.98         9.05    8.39x
+   *   1024        84.22        14.98    5.62x
+   *
+   */
+}
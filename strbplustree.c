@@ -0,0 +1,657 @@
+/*
+ * Copyright (c) 2020, 9rum. All rights reserved.
+ * Use of this source code is governed by a BSD-style
+ * license that can be found in the LICENSE file.
+ *
+ * File Processing, 2020
+ * strbplustree.c
+ * B+-tree implementation for variable-length byte-string keys
+ */
+
+#include <stdlib.h>
+
+#include "search.h"
+#include "stack.h"
+#include "strbplustree.h"
+
+/**
+ * stride returns the size of a slot in a node of level, including the child that follows it in internal nodes.
+ * @param level: level of the node, 0 for terminal nodes
+ */
+static inline size_t stride(const unsigned int level) { return level == 0 ? sizeof(StrSlot) : sizeof(StrSlot)+sizeof(StrNode *); }
+
+/**
+ * slot returns the i-th slot of x.
+ * @param x: a node
+ * @param i: index of the slot
+ */
+static inline StrSlot *slot(const StrNode *x, const unsigned int i) { return (StrSlot *)((char *)(x+1)+stride(x -> level)*i); }
+
+/**
+ * child returns the i-th child of internal node x, the leftmost one being P.
+ * @param x: an internal node
+ * @param i: index of the child
+ */
+static inline StrNode *child(const StrNode *x, const unsigned int i) {
+  StrNode *c = x -> P;
+  if (0 < i) memcpy(&c, slot(x, i-1)+1, sizeof(StrNode *));
+  return c;
+}
+
+/**
+ * prefixOf returns the prefix shared by the keys of x.
+ * @param T: a B+-tree of byte strings
+ * @param x: a node
+ */
+static inline const unsigned char *prefixOf(const StrTree *T, const StrNode *x) { return (const unsigned char *)x+T -> pageSize-x -> prefix; }
+
+/**
+ * freeSpace returns the number of contiguous free bytes between the slots and the key bytes of x.
+ * @param x: a node
+ */
+static inline size_t freeSpace(const StrNode *x) { return x -> top-sizeof(StrNode)-stride(x -> level)*x -> n; }
+
+/**
+ * used returns the number of bytes of x holding its header, slots and live key bytes.
+ * @param T: a B+-tree of byte strings
+ * @param x: a node
+ */
+static inline size_t used(const StrTree *T, const StrNode *x) { return T -> pageSize-freeSpace(x)-x -> dead; }
+
+/**
+ * head returns the first 4 bytes of s in big-endian order, padded with zeros.
+ * @param s: a byte string
+ * @param length: length of s in bytes
+ */
+static inline uint32_t head(const unsigned char *s, const size_t length) {
+  register uint32_t h = 0;
+  for (unsigned int j=0; j<4; ++j) h = h<<8 | (j < length ? s[j] : 0);
+  return h;
+}
+
+/**
+ * newNode returns a new empty node of T.
+ * @param T: a B+-tree of byte strings
+ * @param level: level of the node, 0 for terminal nodes
+ */
+static StrNode *newNode(const StrTree *T, const unsigned int level) {
+  StrNode *x    = aligned_alloc(CACHE_LINE_SIZE, T -> pageSize+CACHE_LINE_SIZE-1 & ~(size_t)(CACHE_LINE_SIZE-1));
+  x -> P        = NULL;
+  x -> n        = 0;
+  x -> level    = level;
+  x -> prefix   = 0;
+  x -> top      = T -> pageSize;
+  x -> dead     = 0;
+  return x;
+}
+
+/**
+ * compare compares the suffix of a key with the suffix in slot s of x, as memcmp does.
+ * @param x: a node
+ * @param s: a slot of x
+ * @param key: the suffix of a key past the prefix of x
+ * @param length: length of key in bytes
+ * @param h: head of key
+ */
+static inline int compare(const StrNode *x, const StrSlot *s, const unsigned char *key, const size_t length, const uint32_t h) {
+  if (h != s -> head) return h < s -> head ? -1 : 1;
+
+  register const size_t n = length < s -> length ? length : s -> length;
+  register const int    c = n <= 4 ? 0 : memcmp(key+4, (const unsigned char *)x+s -> offset+4, n-4); /* equal heads cover the first bytes */
+  return c != 0 ? c : (s -> length < length)-(length < s -> length);
+}
+
+/**
+ * search returns the index of the first key of x not less than key, and stores in found whether it equals key.
+ * @param T: a B+-tree of byte strings
+ * @param x: a node
+ * @param key: a key to search
+ * @param length: length of key in bytes
+ * @param found: where to store whether x contains key
+ */
+static unsigned int search(const StrTree *T, const StrNode *x, const unsigned char *key, const size_t length, bool *found) {
+  register const unsigned int p = x -> prefix;
+  register unsigned int lo      = 0,
+                        hi      = x -> n,
+                        mid;
+  register int c                = memcmp(key, prefixOf(T, x), length < p ? length : p);
+
+  *found = false;
+  if (c < 0 || c == 0 && length < p)  return 0;                                   /* key precedes every key of x */
+  if (0 < c)                          return x -> n;                              /* key follows every key of x */
+
+  const uint32_t h = head(key+p, length-p);
+
+  while (lo < hi) {
+    mid = lo+hi>>1;
+    if ((c = compare(x, slot(x, mid), key+p, length-p, h)) == 0) { *found = true; return mid; }
+    if (c < 0)  hi = mid;
+    else        lo = mid+1;
+  }
+
+  return lo;
+}
+
+/**
+ * descend returns the index of the child of internal node x to search key in.
+ * The keys of the i-th child are not less than the (i-1)-th separator and less than the i-th.
+ * @param T: a B+-tree of byte strings
+ * @param x: an internal node
+ * @param key: a key to search
+ * @param length: length of key in bytes
+ */
+static inline unsigned int descend(const StrTree *T, const StrNode *x, const unsigned char *key, const size_t length) {
+  bool found;
+  const unsigned int i = search(T, x, key, length, &found);
+  return i+found;
+}
+
+/**
+ * lengthOf returns the length of the key of e in bytes.
+ * @param e: an entry
+ */
+static inline unsigned int lengthOf(const StrEntry *e) { return e -> prefixLength+e -> suffixLength; }
+
+/**
+ * byteOf returns the j-th byte of the key of e.
+ * @param e: an entry
+ * @param j: index of the byte
+ */
+static inline unsigned char byteOf(const StrEntry *e, const unsigned int j) { return j < e -> prefixLength ? e -> prefix[j] : e -> suffix[j-e -> prefixLength]; }
+
+/**
+ * common returns the length of the longest common prefix of the keys of a and b.
+ * @param a: an entry
+ * @param b: an entry
+ */
+static unsigned int common(const StrEntry *a, const StrEntry *b) {
+  register const unsigned int n = lengthOf(a) < lengthOf(b) ? lengthOf(a) : lengthOf(b);
+  register unsigned int j       = a -> prefix == b -> prefix ? a -> prefixLength : 0; /* entries of the same node share its prefix */
+
+  while (j < n && byteOf(a, j) == byteOf(b, j)) ++j;
+  return j;
+}
+
+/**
+ * copyKey copies the bytes from from to to of the key of e into dst.
+ * @param dst: a buffer of at least to-from bytes
+ * @param e: an entry
+ * @param from: index of the first byte to copy
+ * @param to: index past the last byte to copy
+ */
+static void copyKey(unsigned char *dst, const StrEntry *e, register unsigned int from, const unsigned int to) {
+  if (from < e -> prefixLength) {
+    register const unsigned int n = (to < e -> prefixLength ? to : e -> prefixLength)-from;
+    memcpy(dst, e -> prefix+from, n);
+    dst  += n;
+    from += n;
+  }
+  if (from < to) memcpy(dst, e -> suffix+from-e -> prefixLength, to-from);
+}
+
+/**
+ * gather stores the keys of x in e, along with the children to their right if x is internal,
+ * and returns their number.
+ * @param T: a B+-tree of byte strings
+ * @param x: a node
+ * @param e: a buffer of at least x -> n entries
+ */
+static unsigned int gather(const StrTree *T, const StrNode *x, StrEntry *e) {
+  for (unsigned int i=0; i<x -> n; ++i) {
+    const StrSlot *s    = slot(x, i);
+    e[i].prefix         = prefixOf(T, x);
+    e[i].suffix         = (const unsigned char *)x+s -> offset;
+    e[i].prefixLength   = x -> prefix;
+    e[i].suffixLength   = s -> length;
+    e[i].child          = x -> level == 0 ? NULL : child(x, i+1);
+  }
+  return x -> n;
+}
+
+/**
+ * sizeOf returns the number of bytes a node of level takes to hold the n keys of e, which sum to total bytes.
+ * @param e: sorted entries
+ * @param n: number of entries
+ * @param total: sum of the lengths of the keys
+ * @param level: level of the node
+ */
+static inline size_t sizeOf(const StrEntry *e, const unsigned int n, const size_t total, const unsigned int level) {
+  return n == 0 ? sizeof(StrNode) : sizeof(StrNode)+stride(level)*n+total-(size_t)(n-1)*common(&e[0], &e[n-1]);
+}
+
+/**
+ * pack lays out the n keys of e in y, whose P and level are set, storing their common prefix once.
+ * @param T: a B+-tree of byte strings
+ * @param y: a node that none of e refers to
+ * @param e: sorted entries
+ * @param n: number of entries
+ */
+static void pack(const StrTree *T, StrNode *y, const StrEntry *e, const unsigned int n) {
+  register const unsigned int p   = n == 0 ? 0 : common(&e[0], &e[n-1]);
+  register unsigned int top       = T -> pageSize-p,
+                        length;
+  register StrSlot *s;
+
+  if (0 < n) copyKey((unsigned char *)y+top, &e[0], 0, p);
+
+  for (unsigned int i=0; i<n; ++i) {
+    length        = lengthOf(&e[i])-p;
+    top          -= length;
+    copyKey((unsigned char *)y+top, &e[i], p, p+length);
+    s             = slot(y, i);
+    s -> offset   = top;
+    s -> length   = length;
+    s -> head     = head((const unsigned char *)y+top, length);
+    if (y -> level != 0) memcpy(s+1, &e[i].child, sizeof(StrNode *));
+  }
+
+  y -> n      = n;
+  y -> prefix = p;
+  y -> top    = top;
+  y -> dead   = 0;
+}
+
+/**
+ * commit copies node y, packed in a scratch page, over x.
+ * @param T: a B+-tree of byte strings
+ * @param x: a node
+ * @param y: a scratch page
+ */
+static inline void commit(const StrTree *T, StrNode *x, const StrNode *y) {
+  memcpy(x, y, sizeof(StrNode)+stride(y -> level)*y -> n);
+  memcpy((char *)x+y -> top, (const char *)y+y -> top, T -> pageSize-y -> top);
+}
+
+/**
+ * divide finds where to split the n keys of e between two nodes of level so that both fit in a page
+ * and the larger is as small as possible, and returns whether it can.
+ * Terminal nodes split into e[0..k) and e[k..n), and internal nodes move e[k] up to their parent.
+ * @param T: a B+-tree of byte strings
+ * @param e: sorted entries
+ * @param n: number of entries
+ * @param level: level of the nodes
+ * @param k: where to store the index to split at
+ */
+static bool divide(const StrTree *T, const StrEntry *e, const unsigned int n, const unsigned int level, unsigned int *k) {
+  register const unsigned int gap = level != 0;
+  register size_t total           = 0,
+                  sum             = 0,
+                  left,
+                  right,
+                  best            = SIZE_MAX;
+
+  for (unsigned int i=0; i<n; ++i) total += lengthOf(&e[i]);
+
+  for (unsigned int i=1; i+gap<n; ++i) {
+    sum  += lengthOf(&e[i-1]);
+    left  = sizeOf(e, i, sum, level);
+    right = sizeOf(e+i+gap, n-i-gap, total-sum-(gap ? lengthOf(&e[i]) : 0), level);
+    if (left <= T -> pageSize && right <= T -> pageSize && (left < right ? right : left) < best) { best = left < right ? right : left; *k = i; }
+  }
+
+  return best != SIZE_MAX;
+}
+
+/**
+ * place inserts key, along with child to its right if x is internal, as the i-th key of x.
+ * If x overflows, it moves the upper keys to a new right sibling, which it returns,
+ * and stores the separator to insert into the parent in separator. Otherwise it returns NULL.
+ * @param T: a B+-tree of byte strings
+ * @param x: a node
+ * @param i: index to insert key at
+ * @param key: a key held outside of x
+ * @param length: length of key in bytes
+ * @param child: the child to the right of key, or NULL if x is terminal
+ * @param separator: a buffer of at least T -> maxKey bytes other than key
+ * @param separatorLength: where to store the length of the separator
+ */
+static StrNode *place(StrTree *T, StrNode *x, const unsigned int i, const unsigned char *key, const unsigned int length, StrNode *child, unsigned char *separator, unsigned int *separatorLength) {
+  register const unsigned int p = x -> prefix;
+  register const size_t       w = stride(x -> level);
+  register StrSlot            *s;
+
+  if (0 < x -> n && p <= length && memcmp(key, prefixOf(T, x), p) == 0 && w+length-p <= freeSpace(x)) { /* case of insertion in place */
+    x -> top   -= length-p;
+    memcpy((char *)x+x -> top, key+p, length-p);
+    memmove(slot(x, i+1), slot(x, i), w*(x -> n-i));
+    s           = slot(x, i);
+    s -> offset = x -> top;
+    s -> length = length-p;
+    s -> head   = head(key+p, length-p);
+    if (x -> level != 0) memcpy(s+1, &child, sizeof(StrNode *));
+    x -> n++;
+    return NULL;
+  }
+
+  StrEntry              *e  = T -> entries[0];
+  StrNode               *y  = T -> scratch[0],
+                        *z;
+  register unsigned int n   = gather(T, x, e);
+  register size_t total     = length;
+  unsigned int          k;
+
+  memmove(&e[i+1], &e[i], sizeof(StrEntry)*(n-i));
+  e[i] = (StrEntry){ .prefix = NULL, .suffix = key, .prefixLength = 0, .suffixLength = length, .child = child };
+  n++;
+  for (unsigned int j=0; j<n; ++j) if (j != i) total += lengthOf(&e[j]);
+
+  y -> P      = x -> P;
+  y -> level  = x -> level;
+
+  if (sizeOf(e, n, total, x -> level) <= T -> pageSize) { pack(T, y, e, n); commit(T, x, y); return NULL; } /* case of repacking */
+
+  if (!divide(T, e, n, x -> level, &k)) { fprintf(stderr, "strbplustree: cannot split a node of %u keys\n", n); abort(); }
+
+  z = newNode(T, x -> level);                                                     /* case of split */
+  if (x -> level == 0) {
+    *separatorLength  = common(&e[k-1], &e[k])+1;                                 /* the shortest prefix of e[k] greater than e[k-1] */
+    z -> P            = x -> P;
+    y -> P            = z;
+    copyKey(separator, &e[k], 0, *separatorLength);
+    pack(T, z, &e[k], n-k);
+  } else {
+    *separatorLength  = lengthOf(&e[k]);
+    z -> P            = e[k].child;
+    copyKey(separator, &e[k], 0, *separatorLength);
+    pack(T, z, &e[k+1], n-k-1);
+  }
+  pack(T, y, e, k);
+  commit(T, x, y);
+  return z;
+}
+
+/**
+ * removeSlot removes the i-th key of x, along with the child to its right if x is internal.
+ * @param x: a node
+ * @param i: index of the key
+ */
+static inline void removeSlot(StrNode *x, const unsigned int i) {
+  x -> dead += slot(x, i) -> length;
+  memmove(slot(x, i), slot(x, i+1), stride(x -> level)*(x -> n-i-1));
+  x -> n--;
+}
+
+/**
+ * createSBPT returns a new empty B+-tree of byte strings,
+ * or NULL if pageSize is not between STR_MIN_PAGE_SIZE and STR_MAX_PAGE_SIZE.
+ * @param pageSize: size of each node in bytes
+ */
+StrTree *createSBPT(const unsigned int pageSize) {
+  if (pageSize < STR_MIN_PAGE_SIZE || STR_MAX_PAGE_SIZE < pageSize) return NULL;
+
+  const size_t capacity = 2*(pageSize/sizeof(StrSlot))+2;                         /* keys of two nodes and the separator between them */
+  StrTree *T            = malloc(sizeof(StrTree));
+  T -> root             = NULL;
+  T -> pageSize         = pageSize;
+  T -> maxKey           = (pageSize-sizeof(StrNode))/4-stride(1);                 /* four keys fit in a node along with their slots */
+
+  for (unsigned int i=0; i<2; ++i) {
+    T -> scratch[i]     = newNode(T, 0);
+    T -> entries[i]     = malloc(sizeof(StrEntry)*capacity);
+    T -> separator[i]   = malloc(T -> maxKey);
+  }
+
+  return T;
+}
+
+/**
+ * freeNodes frees the subtree rooted at x.
+ * @param x: a node
+ */
+static void freeNodes(StrNode *x) {
+  if (x -> level != 0) for (unsigned int i=0; i<=x -> n; ++i) freeNodes(child(x, i));
+  free(x);
+}
+
+/**
+ * destroySBPT frees T.
+ * @param T: a B+-tree of byte strings
+ */
+void destroySBPT(StrTree *T) {
+  if (T -> root != NULL) freeNodes(T -> root);
+
+  for (unsigned int i=0; i<2; ++i) {
+    free(T -> scratch[i]);
+    free(T -> entries[i]);
+    free(T -> separator[i]);
+  }
+  free(T);
+}
+
+/**
+ * insertSBPT inserts newKey into T and returns whether it did,
+ * which it does not if T contains newKey or newKey is longer than T -> maxKey.
+ * @param T: a B+-tree of byte strings
+ * @param newKey: a key to insert
+ * @param length: length of newKey in bytes
+ */
+bool insertSBPT(StrTree *T, const void *newKey, const size_t length) {
+  if (T -> maxKey < length) return false;
+
+  const unsigned char   *key  = newKey;
+  register StrNode      *x    = T -> root,
+                        *z;
+  register unsigned int i,
+                        b     = 0;
+  unsigned int          separatorLength;
+  struct path_stack     stack,
+                        iStack;
+  bool                  found;
+
+  if (x == NULL) { T -> root = newNode(T, 0); place(T, T -> root, 0, key, length, NULL, T -> separator[0], &separatorLength); return true; }
+
+  path_init(&stack);
+  path_init(&iStack);
+
+  while (x -> level != 0) {                                                       /* find position to insert newKey while storing x on the stack */
+    i = descend(T, x, key, length);
+    path_push(&stack, x);
+    path_push(&iStack, (void *)(uintptr_t)i);
+    x = child(x, i);
+  }
+
+  i = search(T, x, key, length, &found);
+  if (found) return false;
+
+  z = place(T, x, i, key, length, NULL, T -> separator[b], &separatorLength);
+
+  while (z != NULL) {                                                             /* insert the separator of the split node into its parent */
+    if (path_empty(&stack)) {                                                     /* the level of tree increases */
+      T -> root       = newNode(T, x -> level+1);
+      T -> root -> P  = x;
+      place(T, T -> root, 0, T -> separator[b], separatorLength, z, T -> separator[b^1], &separatorLength);
+      return true;
+    }
+
+    x = path_pop(&stack);
+    i = (uintptr_t)path_pop(&iStack);
+    z = place(T, x, i, T -> separator[b], separatorLength, z, T -> separator[b^1], &separatorLength);
+    b ^= 1;
+  }
+
+  return true;
+}
+
+/**
+ * deleteSBPT deletes oldKey from T and returns whether T contained it.
+ * A node that falls below a quarter of a page is merged with a sibling if both fit in one page,
+ * and otherwise the keys of both are redistributed if the new separator fits in their parent.
+ * @param T: a B+-tree of byte strings
+ * @param oldKey: a key to delete
+ * @param length: length of oldKey in bytes
+ */
+bool deleteSBPT(StrTree *T, const void *oldKey, const size_t length) {
+  if (T -> root == NULL || T -> maxKey < length) return false;
+
+  const unsigned char   *key  = oldKey;
+  register StrNode      *x    = T -> root,
+                        *y,
+                        *left,
+                        *right;
+  register unsigned int i,
+                        n;
+  register size_t       total;
+  unsigned int          k,
+                        k2,
+                        separatorLength;
+  struct path_stack     stack,
+                        iStack;
+  bool                  found;
+
+  path_init(&stack);
+  path_init(&iStack);
+
+  while (x -> level != 0) {                                                       /* find position of oldKey while storing x on the stack */
+    i = descend(T, x, key, length);
+    path_push(&stack, x);
+    path_push(&iStack, (void *)(uintptr_t)i);
+    x = child(x, i);
+  }
+
+  i = search(T, x, key, length, &found);
+  if (!found) return false;
+
+  removeSlot(x, i);
+
+  for (;;) {
+    if (x == T -> root) {
+      if (x -> n == 0) { T -> root = x -> level == 0 ? NULL : x -> P; free(x); } /* the level of tree decreases */
+      return true;
+    }
+
+    if (0 < x -> n && T -> pageSize/4 <= used(T, x)) return true;
+
+    y     = path_pop(&stack);
+    i     = (uintptr_t)path_pop(&iStack);
+    if (y -> n == 0) return true;                                                 /* x has no sibling to merge with */
+    i     = i < y -> n ? i : i-1;                                                 /* x and its sibling are separated by the i-th key of y */
+    left  = child(y, i);
+    right = child(y, i+1);
+
+    StrEntry  *e  = T -> entries[0];
+    StrNode   *l  = T -> scratch[0];
+
+    n = gather(T, left, e);
+    if (x -> level != 0) {                                                        /* the separator comes down between the keys of internal nodes */
+      const StrSlot *s  = slot(y, i);
+      e[n++]            = (StrEntry){ .prefix = prefixOf(T, y), .suffix = (const unsigned char *)y+s -> offset, .prefixLength = y -> prefix, .suffixLength = s -> length, .child = right -> P };
+    }
+    n += gather(T, right, e+n);
+    for (total = 0, k = 0; k < n; ++k) total += lengthOf(&e[k]);
+
+    l -> level = x -> level;
+
+    if (sizeOf(e, n, total, x -> level) <= T -> pageSize) {                       /* case of merge */
+      l -> P = x -> level == 0 ? right -> P : left -> P;
+      pack(T, l, e, n);
+      commit(T, left, l);
+      free(right);
+      removeSlot(y, i);
+      x = y;
+      continue;
+    }
+
+    if (!divide(T, e, n, x -> level, &k)) return true;                            /* case of key redistribution */
+
+    const unsigned int  gap       = x -> level != 0;
+    unsigned char       *separator = T -> separator[0];
+    StrEntry            *f         = T -> entries[1];
+    StrNode             *r         = T -> scratch[1];
+
+    separatorLength = gap ? lengthOf(&e[k]) : common(&e[k-1], &e[k])+1;
+    copyKey(separator, &e[k], 0, separatorLength);
+
+    gather(T, y, f);
+    f[i] = (StrEntry){ .prefix = NULL, .suffix = separator, .prefixLength = 0, .suffixLength = separatorLength, .child = right };
+    for (total = 0, k2 = 0; k2 < y -> n; ++k2) total += lengthOf(&f[k2]);
+    if (T -> pageSize < sizeOf(f, y -> n, total, y -> level)) return true;       /* the parent cannot hold the new separator */
+
+    l -> P      = left -> P;
+    r -> level  = x -> level;
+    r -> P      = gap ? e[k].child : right -> P;
+    pack(T, l, e, k);
+    pack(T, r, e+k+gap, n-k-gap);
+    commit(T, left, l);
+    commit(T, right, r);
+
+    l -> P      = y -> P;
+    l -> level  = y -> level;
+    pack(T, l, f, y -> n);
+    commit(T, y, l);
+    return true;
+  }
+}
+
+/**
+ * searchSBPT returns whether T contains key.
+ * @param T: a B+-tree of byte strings
+ * @param key: a key to search
+ * @param length: length of key in bytes
+ */
+bool searchSBPT(const StrTree *T, const void *key, const size_t length) {
+  if (T -> root == NULL || T -> maxKey < length) return false;
+
+  register const StrNode *x = T -> root;
+  bool found;
+
+  while (x -> level != 0) x = child(x, descend(T, x, key, length));
+
+  search(T, x, key, length, &found);
+  return found;
+}
+
+/**
+ * seekSBPT positions cursor at the first key in T not less than lo.
+ * @param cursor: a cursor to position
+ * @param T: a B+-tree of byte strings
+ * @param lo: the lower bound of the range, inclusive
+ * @param length: length of lo in bytes
+ */
+void seekSBPT(StrCursor *cursor, const StrTree *T, const void *lo, const size_t length) {
+  register const StrNode *x = T -> root;
+  bool found;
+
+  cursor -> tree  = T;
+  cursor -> node  = NULL;
+  cursor -> i     = 0;
+
+  if (x == NULL) return;
+
+  while (x -> level != 0) x = child(x, descend(T, x, lo, length));
+
+  cursor -> node  = x;
+  cursor -> i     = search(T, x, lo, length, &found);
+}
+
+/**
+ * nextSBPT copies the key at cursor into key, stores its length in length and advances cursor past it.
+ * It returns false once the keys are exhausted.
+ * @param cursor: a cursor positioned by seekSBPT
+ * @param key: a buffer of at least T -> maxKey bytes
+ * @param length: where to store the length of the key
+ */
+bool nextSBPT(StrCursor *cursor, void *key, size_t *length) {
+  register const StrNode *x = cursor -> node;
+
+  while (x != NULL && x -> n <= cursor -> i) { cursor -> node = x = x -> P; cursor -> i = 0; } /* move on to the next terminal node */
+  if (x == NULL) return false;
+
+  const StrSlot *s = slot(x, cursor -> i++);
+  memcpy(key, prefixOf(cursor -> tree, x), x -> prefix);
+  memcpy((char *)key+x -> prefix, (const char *)x+s -> offset, s -> length);
+  *length = x -> prefix+s -> length;
+  return true;
+}
+
+/**
+ * traverseSBPT implements sequential access in T.
+ * @param T: a B+-tree of byte strings
+ */
+void traverseSBPT(const StrTree *T) {
+  register const StrNode *x = T -> root;
+
+  if (x == NULL) return;
+  while (x -> level != 0) x = x -> P;
+
+  for (; x != NULL; x = x -> P) for (unsigned int i=0; i<x -> n; ++i) printf("%.*s%.*s ", (int)x -> prefix, (const char *)prefixOf(T, x), (int)slot(x, i) -> length, (const char *)x+slot(x, i) -> offset);
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2020, 9rum. All rights reserved.
+ * Use of this source code is governed by a BSD-style
+ * license that can be found in the LICENSE file.
+ *
+ * File Processing, 2020
+ * strbplustree.h
+ * B+-tree implementation for variable-length byte-string keys
+ */
+
+#ifndef _STRBPLUSTREE_H
+#define _STRBPLUSTREE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define STR_MIN_PAGE_SIZE 256
+#define STR_MAX_PAGE_SIZE 65536
+
+/**
+ * StrSlot locates the suffix of a key within its node.
+ * head holds the first 4 bytes of the suffix in big-endian order, padded with zeros,
+ * so that most comparisons are decided without touching the suffix itself.
+ * In internal nodes each slot is followed by the child to the right of its key.
+ */
+typedef struct StrSlot {
+  uint16_t          offset;
+  uint16_t          length;
+  uint32_t          head;
+} StrSlot;
+
+/**
+ * StrNode represents a slotted page of B+-tree.
+ * The slots grow up from the header and the key bytes grow down from the end of the page,
+ * where the prefix shared by every key of the node is stored once, followed by the suffixes of the keys.
+ * top is the lowest offset used by key bytes, and dead counts the bytes of erased suffixes
+ * that are reclaimed when the node is repacked.
+ * Terminal nodes have level 0 and link to their right sibling through P,
+ * and internal nodes keep their leftmost child in P.
+ */
+typedef struct StrNode {
+  struct StrNode    *P;
+  unsigned int      n;
+  unsigned int      level;
+  unsigned int      prefix;
+  unsigned int      top;
+  unsigned int      dead;
+} StrNode;
+
+/**
+ * StrEntry refers to a key held by a node, or by the caller, while nodes are repacked.
+ * The key is the concatenation of prefix and suffix.
+ */
+typedef struct StrEntry {
+  const unsigned char *prefix;
+  const unsigned char *suffix;
+  unsigned int        prefixLength;
+  unsigned int        suffixLength;
+  StrNode             *child;
+} StrEntry;
+
+/**
+ * StrTree represents a B+-tree of byte strings ordered as by memcmp, shorter strings first on ties.
+ * Internal nodes hold the shortest separators that tell their children apart, rather than whole keys.
+ * Keys longer than maxKey are rejected, so that a split always leaves both halves within a page.
+ */
+typedef struct StrTree {
+  StrNode           *root;
+  unsigned int      pageSize;
+  unsigned int      maxKey;
+  StrNode           *scratch[2];
+  StrEntry          *entries[2];
+  unsigned char     *separator[2];
+} StrTree;
+
+/**
+ * StrCursor represents a position in the terminal nodes of B+-tree during a range scan.
+ */
+typedef struct StrCursor {
+  const StrTree     *tree;
+  const StrNode     *node;
+  unsigned int      i;
+} StrCursor;
+
+/**
+ * createSBPT returns a new empty B+-tree of byte strings,
+ * or NULL if pageSize is not between STR_MIN_PAGE_SIZE and STR_MAX_PAGE_SIZE.
+ * @param pageSize: size of each node in bytes
+ */
+StrTree *createSBPT(const unsigned int pageSize);
+
+/**
+ * destroySBPT frees T.
+ * @param T: a B+-tree of byte strings
+ */
+void destroySBPT(StrTree *T);
+
+/**
+ * insertSBPT inserts newKey into T and returns whether it did,
+ * which it does not if T contains newKey or newKey is longer than T -> maxKey.
+ * @param T: a B+-tree of byte strings
+ * @param newKey: a key to insert
+ * @param length: length of newKey in bytes
+ */
+bool insertSBPT(StrTree *T, const void *newKey, const size_t length);
+
+/**
+ * deleteSBPT deletes oldKey from T and returns whether T contained it.
+ * @param T: a B+-tree of byte strings
+ * @param oldKey: a key to delete
+ * @param length: length of oldKey in bytes
+ */
+bool deleteSBPT(StrTree *T, const void *oldKey, const size_t length);
+
+/**
+ * searchSBPT returns whether T contains key.
+ * @param T: a B+-tree of byte strings
+ * @param key: a key to search
+ * @param length: length of key in bytes
+ */
+bool searchSBPT(const StrTree *T, const void *key, const size_t length);
+
+/**
+ * seekSBPT positions cursor at the first key in T not less than lo.
+ * @param cursor: a cursor to position
+ * @param T: a B+-tree of byte strings
+ * @param lo: the lower bound of the range, inclusive
+ * @param length: length of lo in bytes
+ */
+void seekSBPT(StrCursor *cursor, const StrTree *T, const void *lo, const size_t length);
+
+/**
+ * nextSBPT copies the key at cursor into key, stores its length in length and advances cursor past it.
+ * It returns false once the keys are exhausted.
+ * @param cursor: a cursor positioned by seekSBPT
+ * @param key: a buffer of at least T -> maxKey bytes
+ * @param length: where to store the length of the key
+ */
+bool nextSBPT(StrCursor *cursor, void *key, size_t *length);
+
+/**
+ * traverseSBPT implements sequential access in T.
+ * @param T: a B+-tree of byte strings
+ */
+void traverseSBPT(const StrTree *T);
+
+#endif /* _STRBPLUSTREE_H */
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2020, 9rum. All rights reserved.
+ * Use of this source code is governed by a BSD-style
+ * license that can be found in the LICENSE file.
+ *
+ * File Processing, 2020
+ *
+ * strbplustree_test.c - byte-string B+-tree unit test
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "strbplustree.h"
+
+#define PAGE_SIZE 256
+
+/**
+ * print prints the keys of T not less than lo, at most count of them.
+ * @param T: a B+-tree of byte strings
+ * @param lo: the lower bound of the range, inclusive
+ * @param count: the number of keys to print
+ */
+static void print(const StrTree *T, const char *lo, unsigned int count) {
+  StrCursor cursor;
+  char      key[PAGE_SIZE];
+  size_t    length;
+
+  seekSBPT(&cursor, T, lo, strlen(lo));
+  while (count-- > 0 && nextSBPT(&cursor, key, &length)) printf("%.*s ", (int)length, key);
+  printf("\n");
+}
+
+int main(void) {
+  const char  *testcases[] = {"interval", "apple", "internet", "inter", "application", "index", "internal", "apply", "intern", "indent",
+                              "applied", "interview", "append", "indexes", "into", "apart", "interim", "applet", "indexer", "interact"},
+              *absent[]    = {"app", "intervals", "indexe", "zebra", ""};
+  char        key[PAGE_SIZE];
+  StrTree     *T;
+
+  printf("%s %s\n", createSBPT(STR_MIN_PAGE_SIZE-1) == NULL ? "NULL" : "created", createSBPT(STR_MAX_PAGE_SIZE+1) == NULL ? "NULL" : "created");
+
+  T = createSBPT(PAGE_SIZE);
+  for (const char **it = testcases; it < testcases + sizeof(testcases)/sizeof(char *); ++it) insertSBPT(T, *it, strlen(*it));
+  traverseSBPT(T);
+  printf("\n");
+  printf("%u\n", T -> root -> level);                                    /* the keys no longer fit in a single node */
+  printf("%d\n", insertSBPT(T, testcases[0], strlen(testcases[0])));
+
+  for (const char **it = testcases; it < testcases + sizeof(testcases)/sizeof(char *); ++it) printf("%d", searchSBPT(T, *it, strlen(*it)));
+  printf("\n");
+  for (const char **it = absent; it < absent + sizeof(absent)/sizeof(char *); ++it) printf("%d", searchSBPT(T, *it, strlen(*it)));
+  printf("\n");
+
+  memset(key, 'x', sizeof(key));
+  printf("%d %d\n", insertSBPT(T, key, T -> maxKey+1), insertSBPT(T, key, T -> maxKey));
+  printf("%d %d\n", searchSBPT(T, key, T -> maxKey+1), deleteSBPT(T, key, T -> maxKey));
+
+  print(T, "app", 4);
+  print(T, "indexe", 3);
+  print(T, "interz", 5);
+  print(T, "zebra", 5);
+
+  for (const char **it = testcases; it < testcases + sizeof(testcases)/sizeof(char *); it += 2) deleteSBPT(T, *it, strlen(*it));
+  traverseSBPT(T);
+  printf("\n");
+  printf("%d\n", deleteSBPT(T, testcases[0], strlen(testcases[0])));
+  for (const char **it = testcases; it < testcases + sizeof(testcases)/sizeof(char *); ++it) printf("%d", searchSBPT(T, *it, strlen(*it)));
+  printf("\n");
+  print(T, "", 20);
+
+  for (const char **it = testcases+1; it < testcases + sizeof(testcases)/sizeof(char *); it += 2) deleteSBPT(T, *it, strlen(*it));
+  printf("%s\n", T -> root == NULL ? "NULL" : "not empty");
+  destroySBPT(T);
+  /*
+   * gcc -Iinclude strbplustree_test.c strbplustree.c
+   *
+   * NULL NULL
+   * apart append apple applet application applied apply indent index indexer indexes inter interact interim intern internal internet interval interview into
+   * 1
+   * 0
+   * 11111111111111111111
+   * 00000
+   * 0 1
+   * 0 1
+   * append apple applet application
+   * indexer indexes inter
+   * into
+   *
+   * apart apple applet apply indent index indexes inter interact interview
+   * 0
+   * 01010101010101010101
+   * apart apple applet apply indent index indexes inter interact interview
+   * NULL
+   *
+   */
+}
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2020, 9rum. All rights reserved.
+ * Use of this source code is governed by a BSD-style
+ * license that can be found in the LICENSE file.
+ *
+ * File Processing, 2020
+ * wal.c
+ * Write-ahead log implementation
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "wal.h"
+
+/**
+ * checksum folds size bytes of buf into hash with FNV-1a.
+ * @param hash: a running hash
+ * @param buf: a buffer of at least size bytes
+ * @param size: number of bytes to hash
+ */
+static uint32_t checksum(register uint32_t hash, const void *buf, const size_t size) {
+  for (const unsigned char *p = buf; p < (const unsigned char *)buf+size; ++p) hash = (hash ^ *p)*16777619u;
+  return hash;
+}
+
+/**
+ * writeAll writes size bytes of buf at offset of fd, aborting on I/O errors.
+ * @param fd: a file descriptor
+ * @param buf: a buffer of at least size bytes
+ * @param size: number of bytes to write
+ * @param offset: offset in file
+ */
+static void writeAll(const int fd, const void *buf, size_t size, off_t offset) {
+  register ssize_t n;
+
+  while (0 < size) {
+    if ((n = pwrite(fd, buf, size, offset)) < 0) { perror("pwrite"); abort(); }
+    buf     = (const char *)buf+n;
+    size   -= n;
+    offset += n;
+  }
+}
+
+/**
+ * readAll reads size bytes at offset of fd into buf.
+ * It returns false if the file ends first.
+ * @param fd: a file descriptor
+ * @param buf: a buffer of at least size bytes
+ * @param size: number of bytes to read
+ * @param offset: offset in file
+ */
+static bool readAll(const int fd, void *buf, size_t size, off_t offset) {
+  register ssize_t n;
+
+  while (0 < size) {
+    if ((n = pread(fd, buf, size, offset)) < 0) { perror("pread"); abort(); }
+    if (n == 0) return false;
+    buf     = (char *)buf+n;
+    size   -= n;
+    offset += n;
+  }
+
+  return true;
+}
+
+/**
+ * flush writes the buffered records of log without flushing them to stable storage.
+ * @param log: a write-ahead log
+ */
+static void flush(WriteAheadLog *log) {
+  writeAll(log -> fd, log -> buffer, log -> used, log -> end);
+  log -> end  += log -> used;
+  log -> used  = 0;
+}
+
+/**
+ * put appends size bytes of buf to log.
+ * @param log: a write-ahead log
+ * @param buf: a buffer of at least size bytes
+ * @param size: number of bytes to append
+ */
+static void put(WriteAheadLog *log, const void *buf, const size_t size) {
+  if (size == 0) return;
+  if (WAL_BUFFER_SIZE < log -> used+size) flush(log);
+  if (WAL_BUFFER_SIZE < size) { writeAll(log -> fd, buf, size, log -> end); log -> end += size; return; }
+
+  memcpy(log -> buffer+log -> used, buf, size);
+  log -> used += size;
+}
+
+/**
+ * openWAL opens the log at path, creating it if it does not exist.
+ * It returns NULL if the log cannot be opened.
+ * @param path: path to the log
+ */
+WriteAheadLog *openWAL(const char *path) {
+  const int fd = open(path, O_RDWR|O_CREAT, 0644);
+  if (fd < 0) return NULL;
+
+  WriteAheadLog *log  = calloc(1, sizeof(WriteAheadLog));
+  log -> fd           = fd;
+  log -> end          = lseek(fd, 0, SEEK_END);
+  log -> buffer       = malloc(WAL_BUFFER_SIZE);
+  return log;
+}
+
+/**
+ * closeWAL commits log and closes it.
+ * @param log: a write-ahead log
+ */
+void closeWAL(WriteAheadLog *log) {
+  commitWAL(log);
+  close(log -> fd);
+  free(log -> buffer);
+  free(log);
+}
+
+/**
+ * appendWAL appends a record of type to log and returns its LSN.
+ * The payload is the concatenation of head and body.
+ * @param log: a write-ahead log
+ * @param type: type of the record
+ * @param head: first part of the payload
+ * @param headSize: size of head in bytes
+ * @param body: second part of the payload
+ * @param bodySize: size of body in bytes
+ */
+uint64_t appendWAL(WriteAheadLog *log, const LogRecordType type, const void *head, const size_t headSize, const void *body, const size_t bodySize) {
+  LogRecord record = {
+    .type = type,
+    .size = headSize+bodySize,
+    .lsn  = ++log -> lsn,
+  };
+  record.checksum = checksum(checksum(checksum(2166136261u, &record, sizeof(LogRecord)), head, headSize), body, bodySize);
+
+  put(log, &record, sizeof(LogRecord));
+  put(log, head, headSize);
+  put(log, body, bodySize);
+  return record.lsn;
+}
+
+/**
+ * commitWAL writes the buffered records of log and flushes them to stable storage.
+ * @param log: a write-ahead log
+ */
+void commitWAL(WriteAheadLog *log) {
+  if (log -> durable == log -> lsn) return;
+
+  flush(log);
+  if (fdatasync(log -> fd) < 0) { perror("fdatasync"); abort(); }
+  log -> durable = log -> lsn;
+  log -> syncs++;
+}
+
+/**
+ * truncateWAL empties log once the pages it covers are durable in the page file.
+ * @param log: a write-ahead log
+ */
+void truncateWAL(WriteAheadLog *log) {
+  if (ftruncate(log -> fd, 0) < 0 || fdatasync(log -> fd) < 0) { perror("ftruncate"); abort(); }
+  log -> end      = 0;
+  log -> used     = 0;
+  log -> durable  = log -> lsn;
+}
+
+/**
+ * recoverWAL redoes the page images of the committed operations in log onto file,
+ * discarding a torn or uncommitted tail, and then truncates log.
+ * @param log: a write-ahead log
+ * @param file: the page file covered by log
+ */
+void recoverWAL(WriteAheadLog *log, PageFile *file) {
+  const size_t  image     = sizeof(PageId)+file -> pageSize;
+  char          *pending  = NULL,
+                *payload  = malloc(image < sizeof(LogCommit) ? sizeof(LogCommit) : image);
+  size_t        n         = 0,
+                capacity  = 0;
+  off_t         offset    = 0;
+  LogRecord     record;
+
+  while (readAll(log -> fd, &record, sizeof(LogRecord), offset)) {
+    if      (record.type == WAL_PAGE    && record.size != image)              break;
+    else if (record.type == WAL_COMMIT  && record.size != sizeof(LogCommit))  break;
+    else if (record.type != WAL_PAGE    && record.type != WAL_COMMIT)         break;
+    if (!readAll(log -> fd, payload, record.size, offset+sizeof(LogRecord)))  break;
+
+    const uint32_t expected = record.checksum;
+    record.checksum = 0;
+    if (checksum(checksum(2166136261u, &record, sizeof(LogRecord)), payload, record.size) != expected) break;
+    offset += sizeof(LogRecord)+record.size;
+
+    if (record.type == WAL_PAGE) {                                            /* hold the image until its operation commits */
+      if (n == capacity) pending = realloc(pending, image*(capacity = capacity ? capacity<<1 : 16));
+      memcpy(pending+image*n++, payload, image);
+      continue;
+    }
+
+    for (size_t i=0; i<n; ++i) {
+      PageId id;
+      memcpy(&id, pending+image*i, sizeof(PageId));
+      writePage(file, id, pending+image*i+sizeof(PageId));
+    }
+    n = 0;
+
+    const LogCommit *commit = (const LogCommit *)payload;
+    file -> pageCount       = commit -> pageCount;
+    file -> freeList        = commit -> freeList;
+    memcpy(file -> meta, commit -> meta, sizeof(file -> meta));
+  }
+
+  free(pending);
+  free(payload);
+  syncPageFile(file);
+  truncateWAL(log);
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2020, 9rum. All rights reserved.
+ * Use of this source code is governed by a BSD-style
+ * license that can be found in the LICENSE file.
+ *
+ * File Processing, 2020
+ * wal.h
+ * Write-ahead log implementation
+ */
+
+#ifndef _WAL_H
+#define _WAL_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#include "pagefile.h"
+
+#define WAL_BUFFER_SIZE     (1 << 20)
+#define WAL_CHECKPOINT_SIZE (1 << 26)
+
+/**
+ * LogRecordType distinguishes the records of a write-ahead log.
+ * WAL_PAGE carries the after-image of a page and WAL_COMMIT the header of the page file
+ * at the end of an operation, which makes the page images logged before it redoable.
+ */
+typedef enum LogRecordType {
+  WAL_PAGE    = 1,
+  WAL_COMMIT  = 2,
+} LogRecordType;
+
+/**
+ * LogRecord represents the header of a log record, followed by size bytes of payload.
+ * checksum covers the header, with checksum 0, and the payload.
+ */
+typedef struct LogRecord {
+  uint32_t      type;
+  uint32_t      size;
+  uint64_t      lsn;
+  uint32_t      checksum;
+  uint32_t      reserved;
+} LogRecord;
+
+/**
+ * LogCommit represents the payload of a WAL_COMMIT record.
+ */
+typedef struct LogCommit {
+  PageId        pageCount;
+  PageId        freeList;
+  uint64_t      meta[PAGE_FILE_META];
+} LogCommit;
+
+/**
+ * WriteAheadLog represents an append-only log of page images.
+ * Records are buffered and written on commit, which makes every record appended so far durable
+ * with a single fdatasync, so a batch of operations shares the cost of one flush.
+ */
+typedef struct WriteAheadLog {
+  int           fd;
+  off_t         end;
+  char          *buffer;
+  size_t        used;
+  uint64_t      lsn;
+  uint64_t      durable;
+  uint64_t      syncs;
+} WriteAheadLog;
+
+/**
+ * openWAL opens the log at path, creating it if it does not exist.
+ * It returns NULL if the log cannot be opened.
+ * @param path: path to the log
+ */
+WriteAheadLog *openWAL(const char *path);
+
+/**
+ * closeWAL commits log and closes it.
+ * @param log: a write-ahead log
+ */
+void closeWAL(WriteAheadLog *log);
+
+/**
+ * appendWAL appends a record of type to log and returns its LSN.
+ * The payload is the concatenation of head and body.
+ * @param log: a write-ahead log
+ * @param type: type of the record
+ * @param head: first part of the payload
+ * @param headSize: size of head in bytes
+ * @param body: second part of the payload
+ * @param bodySize: size of body in bytes
+ */
+uint64_t appendWAL(WriteAheadLog *log, const LogRecordType type, const void *head, const size_t headSize, const void *body, const size_t bodySize);
+
+/**
+ * commitWAL writes the buffered records of log and flushes them to stable storage.
+ * @param log: a write-ahead log
+ */
+void commitWAL(WriteAheadLog *log);
+
+/**
+ * truncateWAL empties log once the pages it covers are durable in the page file.
+ * @param log: a write-ahead log
+ */
+void truncateWAL(WriteAheadLog *log);
+
+/**
+ * recoverWAL redoes the page images of the committed operations in log onto file,
+ * discarding a torn or uncommitted tail, and then truncates log.
+ * @param log: a write-ahead log
+ * @param file: the page file covered by log
+ */
+void recoverWAL(WriteAheadLog *log, PageFile *file);
+
+#endif /* _WAL_H */
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2020, 9rum. All rights reserved.
+ * Use of this source code is governed by a BSD-style
+ * license that can be found in the LICENSE file.
+ *
+ * File Processing, 2020
+ *
+ * wal_test.c - write-ahead log unit test
+ */
+#include <stdio.h>
+#include <inttypes.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "wal.h"
+
+#define PAGE_SIZE 128
+
+/**
+ * logPage appends the image of page id filled with c to log.
+ * @param log: a write-ahead log
+ * @param id: a page
+ * @param c: the byte to fill the page with
+ */
+static void logPage(WriteAheadLog *log, const PageId id, const char c) {
+  char page[PAGE_SIZE];
+
+  memset(page, c, PAGE_SIZE);
+  appendWAL(log, WAL_PAGE, &id, sizeof(PageId), page, PAGE_SIZE);
+}
+
+/**
+ * logCommit appends a commit record holding the header of file to log.
+ * @param log: a write-ahead log
+ * @param file: the page file covered by log
+ */
+static void logCommit(WriteAheadLog *log, const PageFile *file) {
+  LogCommit commit = { .pageCount = file -> pageCount, .freeList = file -> freeList };
+
+  memcpy(commit.meta, file -> meta, sizeof(commit.meta));
+  appendWAL(log, WAL_COMMIT, &commit, sizeof(LogCommit), NULL, 0);
+}
+
+/**
+ * crash commits two operations to the log of the page file at path and exits without writing back a page.
+ * The first allocates page 1 as all a's, and the second allocates page 2 and rewrites both pages as all b's.
+ * @param path: path to the page file
+ * @param logPath: path to the log
+ */
+static void crash(const char *path, const char *logPath) {
+  fflush(stdout);
+  if (fork() == 0) {
+    PageFile      *file = openPageFile(path, PAGE_SIZE);
+    WriteAheadLog *log  = openWAL(logPath);
+
+    logPage(log, allocPage(file), 'a');
+    logCommit(log, file);
+    commitWAL(log);
+    printf("%" PRIu64 " ", log -> durable);
+
+    logPage(log, 1, 'b');
+    logPage(log, allocPage(file), 'b');
+    logCommit(log, file);
+    commitWAL(log);
+    printf("%" PRIu64 " %" PRIu64 "\n", log -> durable, log -> syncs);
+    fflush(stdout);
+    _exit(0);
+  }
+  wait(NULL);
+}
+
+/**
+ * recover redoes the log at logPath onto the page file at path and prints what it restored.
+ * @param path: path to the page file
+ * @param logPath: path to the log
+ */
+static void recover(const char *path, const char *logPath) {
+  PageFile      *file = openPageFile(path, PAGE_SIZE);
+  WriteAheadLog *log  = openWAL(logPath);
+  char          page[PAGE_SIZE];
+  struct stat   st;
+
+  recoverWAL(log, file);
+  stat(logPath, &st);
+  printf("%" PRIu64 " ", file -> pageCount);
+  for (PageId id=1; id<file -> pageCount; ++id) {
+    readPage(file, id, page);
+    printf("%c", page[PAGE_SIZE-1]);
+  }
+  printf(" %lld\n", (long long)st.st_size);
+
+  closeWAL(log);
+  closePageFile(file);
+}
+
+int main(void) {
+  const char  *path     = "wal_test.db",
+              *logPath  = "wal_test.db.wal";
+  const off_t image     = sizeof(LogRecord)+sizeof(PageId)+PAGE_SIZE,
+              commit    = sizeof(LogRecord)+sizeof(LogCommit);
+  struct stat st;
+
+  unlink(path);
+  unlink(logPath);
+  crash(path, logPath);
+  stat(logPath, &st);
+  printf("%lld\n", (long long)st.st_size);
+  recover(path, logPath);                                               /* redoes both operations */
+
+  unlink(path);
+  unlink(logPath);
+  crash(path, logPath);
+  truncate(logPath, image+commit+image/2);                               /* tears the first page image of the second operation */
+  recover(path, logPath);                                               /* redoes the first operation only */
+
+  unlink(path);
+  unlink(logPath);
+  crash(path, logPath);
+  truncate(logPath, image+commit+2*image+commit-1);                      /* tears the last byte of the second commit */
+  recover(path, logPath);
+
+  unlink(path);
+  unlink(logPath);
+  /*
+   * gcc -Iinclude wal_test.c wal.c pagefile.c
+   *
+   * 2 5 2
+   * 688
+   * 3 bb 0
+   * 2 5 2
+   * 2 a 0
+   * 2 5 2
+   * 2 a 0
+   *
+   */
+}